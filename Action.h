@@ -1,21 +1,110 @@
+/**
+* @brief This function presses a key, unless it is 0 (no key).
+*
+* @param key uint8_t
+*
+* @return none
+*
+* @note none
+*/
+void pressKey(uint8_t key)
+{
+  if (key != 0)
+  {
+    bleKeyboard.press(key);
+  }
+}
+
+/**
+* @brief This function presses and releases a key, unless it is 0 (no key).
+*
+* @param key uint8_t
+*
+* @return none
+*
+* @note none
+*/
+void writeKey(uint8_t key)
+{
+  if (key != 0)
+  {
+    bleKeyboard.write(key);
+  }
+}
+
+/**
+* @brief This function presses a row of keys, e.g. from a combo table.
+*
+* @param keys const uint8_t * or nullptr
+* @param count size_t
+*
+* @return none
+*
+* @note Keys that are 0 are skipped. All keys go out in one report.
+*/
+void pressKeys(const uint8_t *keys, size_t count)
+{
+  if (keys != nullptr)
+  {
+    bleKeyboard.pressKeys(keys, count);
+  }
+}
+
+/**
+* @brief This function switches to another bonded host and remembers it.
+*
+* @param host uint8_t 0 for any host (to pair a new one), 1 and up for the bonded hosts
+*
+* @return True if switched. False if there is no such host.
+*
+* @note The current host is disconnected, the new one reconnects in about a second.
+*/
+bool switchHost(uint8_t host)
+{
+  if (!bleKeyboard.selectHost(host))
+  {
+    Serial.printf("[WARNING]: There is no host %u, %u hosts are paired.\n", host, bleKeyboard.getHostCount());
+    return false;
+  }
+  savedStates.putUChar("blehost", host);
+  if (host == 0)
+  {
+    Serial.println("[INFO]: Waiting for any host, a new one can pair now.");
+  }
+  else
+  {
+    Serial.printf("[INFO]: Switched to host %u of %u.\n", host, bleKeyboard.getHostCount());
+  }
+  return true;
+}
+
 /**
 * @brief This function takes an int as an "action" and "value". It uses 
          a switch statement to determine which type of action to do.
          e.g. write, print, press. If an action requires a char, you
          can pass the pointer to that char through the parameter "symbol"
+         The keys of an action are looked up by value in Keytables.h.
 *
 * @param action int 
 * @param value int
-* @param symbol char *
+* @param symbol const char *
 *
 * @return none
 *
 * @note Case 11 is used for special functions, none bleKeyboard related.
+        Case 14 opens menu "value", so menus can be nested like folders.
+        Case 15 types the file "symbol" from /uploads.
+        Case 16 sends the HTTP request in the file "symbol" from /uploads.
 */
 
-void bleKeyboardAction(int action, int value, char *symbol)
+void bleKeyboardAction(int action, int value, const char *symbol)
 {
 
+  if (hidCancelled() && action != 11)
+  {
+    return;
+  }
+
   Serial.println("[INFO]: BLE Keyboard action received");
   
   switch (action)
@@ -24,210 +113,33 @@ void bleKeyboardAction(int action, int value, char *symbol)
     // No Action
     break;
   case 1: // Delay
-    delay(value);
+    actionDelay(value);
     break;
   case 2: // Send TAB ARROW etc
-    switch (value)
-    {
-    case 1:
-      bleKeyboard.write(KEY_UP_ARROW);
-      break;
-    case 2:
-      bleKeyboard.write(KEY_DOWN_ARROW);
-      break;
-    case 3:
-      bleKeyboard.write(KEY_LEFT_ARROW);
-      break;
-    case 4:
-      bleKeyboard.write(KEY_RIGHT_ARROW);
-      break;
-    case 5:
-      bleKeyboard.write(KEY_BACKSPACE);
-      break;
-    case 6:
-      bleKeyboard.write(KEY_TAB);
-      break;
-    case 7:
-      bleKeyboard.write(KEY_RETURN);
-      break;
-    case 8:
-      bleKeyboard.write(KEY_PAGE_UP);
-      break;
-    case 9:
-      bleKeyboard.write(KEY_PAGE_DOWN);
-      break;
-    case 10:
-      bleKeyboard.write(KEY_DELETE);
-      break;
-    case 11:
-      bleKeyboard.write(KEY_PRTSC);
-      break;
-    case 12:
-      bleKeyboard.write(KEY_ESC);
-      break;
-    case 13:
-      bleKeyboard.write(KEY_HOME);
-      break; 
-    case 14:
-      bleKeyboard.write(KEY_END);
-      break; 
-    
-    default:
-      //if nothing matches do nothing
-      break;
-    }
+    writeKey(tableKey(navigationKeys, value - 1));
     break;
   case 3: // Send Media Key
-#if defined(USEUSBHID)
-
-#else
-    switch (value)
+    if (tableKey(mediaKeys, value - 1))
     {
-    case 1:
-      bleKeyboard.write(KEY_MEDIA_MUTE);
-      break;
-    case 2:
-      bleKeyboard.write(KEY_MEDIA_VOLUME_DOWN);
-      break;
-    case 3:
-      bleKeyboard.write(KEY_MEDIA_VOLUME_UP);
-      break;
-    case 4:
-      bleKeyboard.write(KEY_MEDIA_PLAY_PAUSE);
-      break;
-    case 5:
-      bleKeyboard.write(KEY_MEDIA_STOP);
-      break;
-    case 6:
-      bleKeyboard.write(KEY_MEDIA_NEXT_TRACK);
-      break;
-    case 7:
-      bleKeyboard.write(KEY_MEDIA_PREVIOUS_TRACK);
-      break;
-    default:
-      //if nothing matches do nothing
-      break;
+      bleKeyboard.write(tableKey(mediaKeys, value - 1));
     }
     break;
-#endif //if defined(USEUSBHID)
   case 4: // Send Character
     bleKeyboard.print(symbol);
     break;
   case 5: // Option Keys
-    switch (value)
+    if (value == MODIFIER_RELEASE_ALL)
     {
-    case 1:
-      bleKeyboard.press(KEY_LEFT_CTRL);
-      break;
-    case 2:
-      bleKeyboard.press(KEY_LEFT_SHIFT);
-      break;
-    case 3:
-      bleKeyboard.press(KEY_LEFT_ALT);
-      break;
-    case 4:
-      bleKeyboard.press(KEY_LEFT_GUI);
-      break;
-    case 5:
-      bleKeyboard.press(KEY_RIGHT_CTRL);
-      break;
-    case 6:
-      bleKeyboard.press(KEY_RIGHT_SHIFT);
-      break;
-    case 7:
-      bleKeyboard.press(KEY_RIGHT_ALT);
-      break;
-    case 8:
-      bleKeyboard.press(KEY_RIGHT_GUI);
-      break;
-    case 9:
       bleKeyboard.releaseAll();
-      break;
-    default:
-      //if nothing matches do nothing
-      break;
     }
-    break;
-  case 6: // Function Keys
-    switch (value)
+    else
     {
-    case 1:
-      bleKeyboard.press(KEY_F1);
-      break;
-    case 2:
-      bleKeyboard.press(KEY_F2);
-      break;
-    case 3:
-      bleKeyboard.press(KEY_F3);
-      break;
-    case 4:
-      bleKeyboard.press(KEY_F4);
-      break;
-    case 5:
-      bleKeyboard.press(KEY_F5);
-      break;
-    case 6:
-      bleKeyboard.press(KEY_F6);
-      break;
-    case 7:
-      bleKeyboard.press(KEY_F7);
-      break;
-    case 8:
-      bleKeyboard.press(KEY_F8);
-      break;
-    case 9:
-      bleKeyboard.press(KEY_F9);
-      break;
-    case 10:
-      bleKeyboard.press(KEY_F10);
-      break;
-    case 11:
-      bleKeyboard.press(KEY_F11);
-      break;
-    case 12:
-      bleKeyboard.press(KEY_F12);
-      break;
-    case 13:
-      bleKeyboard.press(KEY_F13);
-      break;
-    case 14:
-      bleKeyboard.press(KEY_F14);
-      break;
-    case 15:
-      bleKeyboard.press(KEY_F15);
-      break;
-    case 16:
-      bleKeyboard.press(KEY_F16);
-      break;
-    case 17:
-      bleKeyboard.press(KEY_F17);
-      break;
-    case 18:
-      bleKeyboard.press(KEY_F18);
-      break;
-    case 19:
-      bleKeyboard.press(KEY_F19);
-      break;
-    case 20:
-      bleKeyboard.press(KEY_F20);
-      break;
-    case 21:
-      bleKeyboard.press(KEY_F21);
-      break;
-    case 22:
-      bleKeyboard.press(KEY_F22);
-      break;
-    case 23:
-      bleKeyboard.press(KEY_F23);
-      break;
-    case 24:
-      bleKeyboard.press(KEY_F24);
-      break;
-    default:
-      //if nothing matches do nothing
-      break;
+      pressKey(tableKey(modifierKeys, value - 1));
     }
     break;
+  case 6: // Function Keys
+    pressKey(tableKey(functionKeys, value - 1));
+    break;
   case 7: // Send Number
     bleKeyboard.print(value);
     break;
@@ -235,234 +147,29 @@ void bleKeyboardAction(int action, int value, char *symbol)
     bleKeyboard.print(symbol);
     break;
   case 9: // Combos
-    switch (value)
+    pressKeys(tableRow(comboKeys, value - 1), sizeof(comboKeys[0]));
+    break;
+  case 10: // Helpers: the helper modifiers from general.json plus F1 to F11
+    if (value >= 1 && value <= HELPER_COUNT)
     {
-    case 1:
-      bleKeyboard.press(KEY_LEFT_CTRL);
-      bleKeyboard.press(KEY_LEFT_SHIFT);
-      break;
-    case 2:
-      bleKeyboard.press(KEY_LEFT_ALT);
-      bleKeyboard.press(KEY_LEFT_SHIFT);
-      break;
-    case 3:
-      bleKeyboard.press(KEY_LEFT_GUI);
-      bleKeyboard.press(KEY_LEFT_SHIFT);
-      break;
-    case 4:
-      bleKeyboard.press(KEY_LEFT_CTRL);
-      bleKeyboard.press(KEY_LEFT_GUI);
-      break;
-    case 5:
-      bleKeyboard.press(KEY_LEFT_ALT);
-      bleKeyboard.press(KEY_LEFT_GUI);
-      break;
-    case 6:
-      bleKeyboard.press(KEY_LEFT_CTRL);
-      bleKeyboard.press(KEY_LEFT_ALT);
-      break;
-    case 7:
-      bleKeyboard.press(KEY_LEFT_CTRL);
-      bleKeyboard.press(KEY_LEFT_ALT);
-      bleKeyboard.press(KEY_LEFT_GUI);
-      break;
-    case 8:
-      bleKeyboard.press(KEY_RIGHT_CTRL);
-      bleKeyboard.press(KEY_RIGHT_SHIFT);
-      break;
-    case 9:
-      bleKeyboard.press(KEY_RIGHT_ALT);
-      bleKeyboard.press(KEY_RIGHT_SHIFT);
-      break;
-    case 10:
-      bleKeyboard.press(KEY_RIGHT_GUI);
-      bleKeyboard.press(KEY_RIGHT_SHIFT);
-      break;
-    case 11:
-      bleKeyboard.press(KEY_RIGHT_CTRL);
-      bleKeyboard.press(KEY_RIGHT_GUI);
-      break;
-    case 12:
-      bleKeyboard.press(KEY_RIGHT_ALT);
-      bleKeyboard.press(KEY_RIGHT_GUI);
-      break;
-    case 13:
-      bleKeyboard.press(KEY_RIGHT_CTRL);
-      bleKeyboard.press(KEY_RIGHT_ALT);
-      break;
-    case 14:
-      bleKeyboard.press(KEY_RIGHT_CTRL);
-      bleKeyboard.press(KEY_RIGHT_ALT);
-      bleKeyboard.press(KEY_RIGHT_GUI);
-      break;
+      const uint8_t keys[] = {generalconfig.modifier1, generalconfig.modifier2, generalconfig.modifier3,
+                              tableKey(functionKeys, value - 1)};
+      pressKeys(keys, sizeof(keys));
+      bleKeyboard.releaseAll();
+      actionDelay(generalconfig.helperdelay);
     }
     break;
-  case 10: // Helpers
-  switch (value)
+  case 11: // Special functions
+    if (!onUiTask())
     {
-      case 1:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F1);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 2:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F2);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 3:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F3);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 4:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F4);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 5:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F5);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 6:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F6);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 7:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F7);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 8:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F8);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 9:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F9);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 10:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F10);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
-      break;
-      case 11:
-        if(generalconfig.modifier1 != 0){
-          bleKeyboard.press(generalconfig.modifier1);
-        }
-        if(generalconfig.modifier2 != 0){
-          bleKeyboard.press(generalconfig.modifier2);
-        }
-        if(generalconfig.modifier3 != 0){
-          bleKeyboard.press(generalconfig.modifier3);
-        }
-        bleKeyboard.press(KEY_F11);
-        bleKeyboard.releaseAll();
-        delay(generalconfig.helperdelay);
+      // Special functions draw to the screen, so they run on the UI task
+      postUiEvent(UI_EVENT_SPECIAL, value);
       break;
     }
-    break;
-  case 11: // Special functions
     switch (value)
     {
-    case 1:        // Enter config mode
-      
-      configmode();
-        
+    case 1: // Enter config mode, the config mode screen starts WiFi
+      routerGo(PAGE_CONFIGMODE);
       break;
     case 2: // Display Brightness Down
       if (ledBrightness > 25)
@@ -495,60 +202,19 @@ void bleKeyboardAction(int action, int value, char *symbol)
         Serial.println(generalconfig.sleeptimer);
       }
       break;
+    case 5: // Stop running actions
+      cancelActions();
+      break;
+    case 6: // Switch to the next bonded host, after the last one any host
+      switchHost((bleKeyboard.getHost() + 1) % (bleKeyboard.getHostCount() + 1));
+      break;
+    case 7: // Pair a new host
+      switchHost(0);
+      break;
     }
     break;
   case 12: // Numpad
-    switch (value)
-    {
-      case 0:
-        bleKeyboard.write(KEY_NUM_0);
-        break;
-      case 1:
-        bleKeyboard.write(KEY_NUM_1);
-        break;
-      case 2:
-        bleKeyboard.write(KEY_NUM_2);
-        break;
-      case 3:
-        bleKeyboard.write(KEY_NUM_3);
-        break;
-      case 4:
-        bleKeyboard.write(KEY_NUM_4);
-        break;
-      case 5:
-        bleKeyboard.write(KEY_NUM_5);
-        break;
-      case 6:
-        bleKeyboard.write(KEY_NUM_6);
-        break;
-      case 7:
-        bleKeyboard.write(KEY_NUM_7);
-        break;
-      case 8:
-        bleKeyboard.write(KEY_NUM_8);
-        break;
-      case 9:
-        bleKeyboard.write(KEY_NUM_9);
-        break;
-      case 10:
-        bleKeyboard.write(KEY_NUM_SLASH);
-        break;
-      case 11:
-        bleKeyboard.write(KEY_NUM_ASTERISK);
-        break;
-      case 12:
-        bleKeyboard.write(KEY_NUM_MINUS);
-        break;
-      case 13:
-        bleKeyboard.write(KEY_NUM_PLUS);
-        break;
-      case 14:
-        bleKeyboard.write(KEY_NUM_ENTER);
-        break;
-      case 15:
-        bleKeyboard.write(KEY_NUM_PERIOD);
-        break;
-    }
+    writeKey(tableKey(numpadKeys, value));
     break;
     case 13: // Custom functions
     switch (value)
@@ -576,8 +242,19 @@ void bleKeyboardAction(int action, int value, char *symbol)
         break;
     }
     break;
+  case 14: // Open page (a menu used as a folder)
+    postUiEvent(UI_EVENT_OPEN, value);
+    break;
+  case 15: // Type File: the contents of /uploads/symbol
+    typeFile(symbol);
+    break;
+  case 16: // HTTP request: described in /uploads/symbol, see Webhook.h
+    webhookQueue(symbol);
+    break;
   default:
     //If nothing matches do nothing
     break;
   }
 }
+
+
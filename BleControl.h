@@ -0,0 +1,284 @@
+/*
+ * BLE control service.
+ *
+ * A GATT service next to the HID service, so a companion app on the host can
+ * drive the deck over the BLE link that is already there, without USB serial
+ * or WiFi mode. All characteristics need an encrypted (paired) link.
+ *
+ *   Page    read, write, notify  uint8_t page. Writing switches to that page.
+ *   Button  write                page, button (0 to 4) and an optional 1 for
+ *                                the long press. Runs the button's macro.
+ *   Latch   read, notify         Read: the latch bit array of all pages.
+ *                                Notify: page and a bit mask of its 5 buttons,
+ *                                for every page whose latches changed.
+ *   Config  write                A small JSON object, e.g. {"sleeptimer":5}.
+ *                                Applied right away, not saved to general.json.
+ *
+ * Writes arrive on the NimBLE task and are handed to the UI task as events.
+ * The UI task calls bleControlSync() every tick to notify changes.
+ */
+
+#define BLE_CONTROL_SERVICE_UUID "6e3c0001-8f5a-4b7e-9d2c-1f0e4a5b6c7d"
+#define BLE_CONTROL_PAGE_UUID "6e3c0002-8f5a-4b7e-9d2c-1f0e4a5b6c7d"
+#define BLE_CONTROL_BUTTON_UUID "6e3c0003-8f5a-4b7e-9d2c-1f0e4a5b6c7d"
+#define BLE_CONTROL_LATCH_UUID "6e3c0004-8f5a-4b7e-9d2c-1f0e4a5b6c7d"
+#define BLE_CONTROL_CONFIG_UUID "6e3c0005-8f5a-4b7e-9d2c-1f0e4a5b6c7d"
+
+// The longest config patch, and how many can wait for the UI task
+#define BLE_CONTROL_PATCH_MAX 128
+#define BLE_CONTROL_PATCH_QUEUE 2
+
+NimBLECharacteristic *bleControlPage = nullptr;
+NimBLECharacteristic *bleControlButton = nullptr;
+NimBLECharacteristic *bleControlLatch = nullptr;
+NimBLECharacteristic *bleControlConfig = nullptr;
+
+QueueHandle_t bleControlPatches = nullptr;
+
+// What the host was last told
+int16_t bleControlSentPage = -1;
+uint8_t bleControlSentLatches[sizeof(latchbits)];
+
+struct BleControlPatch
+{
+  uint8_t length;
+  char json[BLE_CONTROL_PATCH_MAX];
+};
+
+class BleControlCallbacks : public NimBLECharacteristicCallbacks
+{
+  void onRead(NimBLECharacteristic *characteristic, NimBLEConnInfo &connInfo) override
+  {
+    if (characteristic == bleControlLatch)
+    {
+      characteristic->setValue(latchbits, sizeof(latchbits));
+    }
+    else if (characteristic == bleControlPage)
+    {
+      characteristic->setValue((uint8_t)pageNum);
+    }
+  }
+
+  void onWrite(NimBLECharacteristic *characteristic, NimBLEConnInfo &connInfo) override
+  {
+    NimBLEAttValue value = characteristic->getValue();
+
+    if (characteristic == bleControlPage && value.size() == 1)
+    {
+      int page = value[0];
+      if (page == PAGE_HOME || isMenuPage(page))
+      {
+        postUiEvent(UI_EVENT_PAGE, page);
+      }
+    }
+    else if (characteristic == bleControlButton && value.size() >= 2)
+    {
+      bool longpress = value.size() >= 3 && value[2];
+      if (isMenuPage(value[0]) && value[1] < BUTTONS_PER_PAGE - 1)
+      {
+        postUiEvent(UI_EVENT_TRIGGER, value[0] << 4 | value[1] << 1 | longpress);
+      }
+    }
+    else if (characteristic == bleControlConfig && value.size() > 0 && value.size() < BLE_CONTROL_PATCH_MAX)
+    {
+      BleControlPatch patch;
+      patch.length = value.size();
+      memcpy(patch.json, value.data(), value.size());
+      patch.json[patch.length] = '\0';
+      if (xQueueSend(bleControlPatches, &patch, 0) == pdTRUE)
+      {
+        postUiEvent(UI_EVENT_CONFIG, 0);
+      }
+    }
+  }
+};
+
+BleControlCallbacks bleControlCallbacks;
+
+/**
+* @brief This function adds the control service to the BLE server.
+*
+* @param server NimBLEServer *
+*
+* @return none
+*
+* @note Called by bleKeyboard.begin(), see setServicesCallback().
+*/
+void bleControlSetup(NimBLEServer *server)
+{
+  bleControlPatches = xQueueCreate(BLE_CONTROL_PATCH_QUEUE, sizeof(BleControlPatch));
+
+  NimBLEService *service = server->createService(BLE_CONTROL_SERVICE_UUID);
+  bleControlPage = service->createCharacteristic(BLE_CONTROL_PAGE_UUID,
+                                                 NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::READ_ENC |
+                                                     NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_ENC |
+                                                     NIMBLE_PROPERTY::NOTIFY);
+  bleControlButton = service->createCharacteristic(BLE_CONTROL_BUTTON_UUID,
+                                                   NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_ENC);
+  bleControlLatch = service->createCharacteristic(BLE_CONTROL_LATCH_UUID,
+                                                  NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::READ_ENC |
+                                                      NIMBLE_PROPERTY::NOTIFY,
+                                                  sizeof(latchbits));
+  bleControlConfig = service->createCharacteristic(BLE_CONTROL_CONFIG_UUID,
+                                                   NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_ENC,
+                                                   BLE_CONTROL_PATCH_MAX);
+
+  bleControlPage->setCallbacks(&bleControlCallbacks);
+  bleControlButton->setCallbacks(&bleControlCallbacks);
+  bleControlLatch->setCallbacks(&bleControlCallbacks);
+  bleControlConfig->setCallbacks(&bleControlCallbacks);
+
+  memcpy(bleControlSentLatches, latchbits, sizeof(latchbits));
+  service->start();
+}
+
+/**
+* @brief This function runs the macro of a button for the control service.
+*
+* @param value int16_t page << 4 | button << 1 | long press
+*
+* @return none
+*
+* @note Runs on the UI task, like a touch.
+*/
+void bleControlTrigger(int16_t value)
+{
+  int page = value >> 4;
+  int b = (value >> 1) & 0x07;
+  bool longpress = value & 1;
+
+  Button *button = getMenuButton(page, b);
+  if (button == nullptr)
+  {
+    return;
+  }
+  queueMacro(button, page, b, longpress);
+  if (button->latch && !button->led && !longpress)
+  {
+    toggleLatch(page, b);
+    if (page == pageNum)
+    {
+      drawLatchButton(b);
+    }
+  }
+}
+
+/**
+* @brief This function applies the config patches written to the control service.
+*
+* @param none
+*
+* @return none
+*
+* @note Runs on the UI task. Unknown keys are ignored.
+*/
+void bleControlApplyPatches()
+{
+  BleControlPatch patch;
+  while (xQueueReceive(bleControlPatches, &patch, 0) == pdTRUE)
+  {
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, patch.json, patch.length);
+    if (error || !doc.is<JsonObject>())
+    {
+      Serial.printf("[WARNING]: Config patch over BLE is not a JSON object: %s\n", patch.json);
+      continue;
+    }
+
+    if (doc.containsKey("sleepenable"))
+    {
+      generalconfig.sleepenable = doc["sleepenable"];
+    }
+    if (doc.containsKey("sleeptimer"))
+    {
+      generalconfig.sleeptimer = doc["sleeptimer"].as<int>();
+    }
+    if (generalconfig.sleepenable)
+    {
+      Interval = generalconfig.sleeptimer * 60000;
+    }
+    if (doc.containsKey("deepsleeptimer"))
+    {
+      generalconfig.deepsleeptimer = doc["deepsleeptimer"].as<int>();
+    }
+    if (doc.containsKey("beep"))
+    {
+      generalconfig.beep = doc["beep"];
+    }
+    if (doc.containsKey("helperdelay"))
+    {
+      generalconfig.helperdelay = doc["helperdelay"].as<int>();
+    }
+    if (doc.containsKey("brightness"))
+    {
+      ledBrightness = constrain(doc["brightness"].as<int>(), 0, 255);
+      ledcWrite(0, ledBrightness);
+      savedStates.putInt("ledBrightness", ledBrightness);
+    }
+    if (doc.containsKey("keyboardlayout"))
+    {
+      const char *layout = doc["keyboardlayout"] | "us";
+      if (bleKeyboard.setLayout(layout))
+      {
+        strlcpy(generalconfig.keyboardlayout, layout, sizeof(generalconfig.keyboardlayout));
+      }
+    }
+    Serial.printf("[INFO]: Config patch over BLE: %s\n", patch.json);
+  }
+}
+
+/**
+* @brief This function notifies the host of page and latch changes.
+*
+* @param none
+*
+* @return none
+*
+* @note Called by the UI task every tick. Does nothing while no host is connected.
+*/
+void bleControlSync()
+{
+  if (bleControlPage == nullptr || !bleKeyboard.isConnected())
+  {
+    return;
+  }
+
+  if (pageNum != bleControlSentPage)
+  {
+    bleControlSentPage = pageNum;
+    bleControlPage->setValue((uint8_t)pageNum);
+    bleControlPage->notify();
+  }
+
+  if (memcmp(bleControlSentLatches, latchbits, sizeof(latchbits)) == 0)
+  {
+    return;
+  }
+  for (int page = 1; page <= PAGE_SETTINGS; page++)
+  {
+    uint8_t mask = 0;
+    uint8_t sentmask = 0;
+    for (int b = 0; b < BUTTONS_PER_PAGE - 1; b++)
+    {
+      int index = latchIndex(page, b);
+      if (index < 0)
+      {
+        continue;
+      }
+      if (latchbits[index / 8] & (1 << (index % 8)))
+      {
+        mask |= 1 << b;
+      }
+      if (bleControlSentLatches[index / 8] & (1 << (index % 8)))
+      {
+        sentmask |= 1 << b;
+      }
+    }
+    if (mask != sentmask)
+    {
+      uint8_t change[2] = {(uint8_t)page, mask};
+      bleControlLatch->notify(change, sizeof(change));
+    }
+  }
+  memcpy(bleControlSentLatches, latchbits, sizeof(latchbits));
+}
@@ -1,143 +1,53 @@
 #include "BleKeyboard.h"
+#include "KeyLayouts.h"
 
 #include "sdkconfig.h"
 #include <driver/adc.h>
-#include "esp_timer.h"
 #include "esp_log.h"
+#include <Preferences.h>
 
 static const char* LOG_TAG = "BleKeyboard";
 
-// ASCII to HID keycode mapping
-const uint8_t _asciimap[128] PROGMEM = {
-  0x00,             // NUL
-  0x00,             // SOH
-  0x00,             // STX
-  0x00,             // ETX
-  0x00,             // EOT
-  0x00,             // ENQ
-  0x00,             // ACK
-  0x00,             // BEL
-  0x2a,             // BS  Backspace
-  0x2b,             // TAB Tab
-  0x28,             // LF  Enter
-  0x00,             // VT
-  0x00,             // FF
-  0x00,             // CR
-  0x00,             // SO
-  0x00,             // SI
-  0x00,             // DEL
-  0x00,             // DC1
-  0x00,             // DC2
-  0x00,             // DC3
-  0x00,             // DC4
-  0x00,             // NAK
-  0x00,             // SYN
-  0x00,             // ETB
-  0x00,             // CAN
-  0x00,             // EM
-  0x00,             // SUB
-  0x00,             // ESC
-  0x00,             // FS
-  0x00,             // GS
-  0x00,             // RS
-  0x00,             // US
-  0x2c,             //  ' '
-  0x1e|0x80,        // !
-  0x34|0x80,        // "
-  0x20|0x80,        // #
-  0x21|0x80,        // $
-  0x22|0x80,        // %
-  0x24|0x80,        // &
-  0x34,             // '
-  0x26|0x80,        // (
-  0x27|0x80,        // )
-  0x25|0x80,        // *
-  0x2e|0x80,        // +
-  0x36,             // ,
-  0x2d,             // -
-  0x37,             // .
-  0x38,             // /
-  0x27,             // 0
-  0x1e,             // 1
-  0x1f,             // 2
-  0x20,             // 3
-  0x21,             // 4
-  0x22,             // 5
-  0x23,             // 6
-  0x24,             // 7
-  0x25,             // 8
-  0x26,             // 9
-  0x33|0x80,        // :
-  0x33,             // ;
-  0x36|0x80,        // <
-  0x2e,             // =
-  0x37|0x80,        // >
-  0x38|0x80,        // ?
-  0x1f|0x80,        // @
-  0x04|0x80,        // A
-  0x05|0x80,        // B
-  0x06|0x80,        // C
-  0x07|0x80,        // D
-  0x08|0x80,        // E
-  0x09|0x80,        // F
-  0x0a|0x80,        // G
-  0x0b|0x80,        // H
-  0x0c|0x80,        // I
-  0x0d|0x80,        // J
-  0x0e|0x80,        // K
-  0x0f|0x80,        // L
-  0x10|0x80,        // M
-  0x11|0x80,        // N
-  0x12|0x80,        // O
-  0x13|0x80,        // P
-  0x14|0x80,        // Q
-  0x15|0x80,        // R
-  0x16|0x80,        // S
-  0x17|0x80,        // T
-  0x18|0x80,        // U
-  0x19|0x80,        // V
-  0x1a|0x80,        // W
-  0x1b|0x80,        // X
-  0x1c|0x80,        // Y
-  0x1d|0x80,        // Z
-  0x2f,             // [
-  0x31,             // bslash
-  0x30,             // ]
-  0x23|0x80,        // ^
-  0x2d|0x80,        // _
-  0x35,             // `
-  0x04,             // a
-  0x05,             // b
-  0x06,             // c
-  0x07,             // d
-  0x08,             // e
-  0x09,             // f
-  0x0a,             // g
-  0x0b,             // h
-  0x0c,             // i
-  0x0d,             // j
-  0x0e,             // k
-  0x0f,             // l
-  0x10,             // m
-  0x11,             // n
-  0x12,             // o
-  0x13,             // p
-  0x14,             // q
-  0x15,             // r
-  0x16,             // s
-  0x17,             // t
-  0x18,             // u
-  0x19,             // v
-  0x1a,             // w
-  0x1b,             // x
-  0x1c,             // y
-  0x1d,             // z
-  0x2f|0x80,        // {
-  0x31|0x80,        // |
-  0x30|0x80,        // }
-  0x35|0x80,        // ~
-  0x00              // DEL
-};
+// How long a caller waits for room in a full report queue before the report is dropped
+#define HID_QUEUE_WAIT_MS 500
+
+// How often a report is retried when the controller is out of buffers
+#define HID_NOTIFY_RETRIES 3
+
+// The report sender task, it runs next to the NimBLE host on core 0
+#define HID_SENDER_STACK 3072
+#define HID_SENDER_PRIORITY 5
+#define HID_SENDER_CORE 0
+
+// Connection parameters we ask for. Intervals are in units of 1.25 ms, the
+// supervision timeout in units of 10 ms. While in use a short interval and no
+// slave latency keep the delay between a touch and the key on the host short.
+#define BLE_FAST_MIN_INTERVAL 6     // 7.5 ms
+#define BLE_FAST_MAX_INTERVAL 12    // 15 ms, some hosts refuse less
+#define BLE_FAST_LATENCY 0
+#define BLE_RELAXED_MIN_INTERVAL 48 // 60 ms
+#define BLE_RELAXED_MAX_INTERVAL 96 // 120 ms
+#define BLE_RELAXED_LATENCY 4
+#define BLE_SUPERVISION_TIMEOUT 400 // 4 s
+
+// How long one round of directed advertising to the selected host lasts
+#define BLE_DIRECTED_ADV_MS 1280
+
+// Advertising intervals in units of 0.625 ms. Directed advertising uses the
+// fast one so a host that is listening connects within a few hundred ms.
+#define BLE_ADV_FAST_INTERVAL 32 // 20 ms
+#define BLE_ADV_MIN_INTERVAL 48  // 30 ms
+#define BLE_ADV_MAX_INTERVAL 96  // 60 ms
+
+// Reports made before the host is back wait this long, older ones are dropped
+#define BLE_PENDING_MAX_MS 5000
+
+// Hosts that do not encrypt the link get the reports this long after connecting
+#define BLE_SECURE_WAIT_MS 2000
+
+// Where the last host is kept, it is called back first after a wake
+#define BLE_PREFS_NAMESPACE "blekeyboard"
+#define BLE_PREFS_LASTPEER "lastpeer"
 
 // HID descriptor (keyboard + consumer/media)
 static const uint8_t _hidReportDescriptor[] = {
@@ -212,37 +122,89 @@ static const uint8_t _hidReportDescriptor[] = {
   END_COLLECTION(0)
 };
 
+// NKRO keyboard, appended to the descriptor above by begin(true). The boot
+// report stays, hosts in boot protocol only read that one.
+static const uint8_t _nkroReportDescriptor[] = {
+  USAGE_PAGE(1),      0x01,
+  USAGE(1),           0x06,
+  COLLECTION(1),      0x01,
+
+  REPORT_ID(1),       NKRO_ID,
+  USAGE_PAGE(1),      0x07,
+  USAGE_MINIMUM(1),   0xE0,
+  USAGE_MAXIMUM(1),   0xE7,
+  LOGICAL_MINIMUM(1), 0x00,
+  LOGICAL_MAXIMUM(1), 0x01,
+  REPORT_SIZE(1),     0x01,
+  REPORT_COUNT(1),    0x08,
+  HIDINPUT(1),        0x02,
+
+  USAGE_MINIMUM(1),   0x00,
+  USAGE_MAXIMUM(1),   0x7F,
+  REPORT_COUNT(1),    NKRO_KEY_BYTES * 8,
+  HIDINPUT(1),        0x02,
+  END_COLLECTION(0)
+};
+
 BleKeyboard::BleKeyboard(std::string deviceName_, std::string deviceManufacturer_, uint8_t batteryLevel_)
   : deviceName(deviceName_.substr(0, 15))
   , deviceManufacturer(deviceManufacturer_.substr(0, 15))
-  , batteryLevel(batteryLevel_) {}
+  , batteryLevel(batteryLevel_)
+  , _layout(layout_us) {}
 
-void BleKeyboard::begin(void) {
+void BleKeyboard::begin(bool nkro) {
+  _nkro = nkro;
   NimBLEDevice::init(deviceName);
+  NimBLEDevice::setSecurityAuth(true, false, true); // Bond, so hosts can be switched without pairing again
 
-  NimBLEServer* pServer = NimBLEDevice::createServer();
-  pServer->setCallbacks(this);
+  server = NimBLEDevice::createServer();
+  server->setCallbacks(this);
+  server->advertiseOnDisconnect(false); // onDisconnect() picks the host to advertise to
 
-  hid = new NimBLEHIDDevice(pServer);
+  hid = new NimBLEHIDDevice(server);
 
   inputKeyboard  = hid->getInputReport(KEYBOARD_ID);
   outputKeyboard = hid->getOutputReport(KEYBOARD_ID);
   inputMediaKeys = hid->getInputReport(MEDIA_KEYS_ID);
+  if (_nkro) inputNkro = hid->getInputReport(NKRO_ID);
 
   outputKeyboard->setCallbacks(this);
+  inputKeyboard->setCallbacks(this);  // onStatus() paces the report queue
+  inputMediaKeys->setCallbacks(this);
+  if (inputNkro) inputNkro->setCallbacks(this);
+
+  reportQueue = xQueueCreate(HID_REPORT_QUEUE_LENGTH, sizeof(QueuedReport));
+  notifyDone = xSemaphoreCreateBinary();
+  linkUp = xSemaphoreCreateBinary();
+  xTaskCreatePinnedToCore(senderTask, "ble_hid_tx", HID_SENDER_STACK, this,
+                          HID_SENDER_PRIORITY, nullptr, HID_SENDER_CORE);
 
   hid->setManufacturer(deviceManufacturer);
 
   hid->setPnp(0x02, vid, pid, version);
   hid->setHidInfo(0x00, 0x01);
 
-  hid->setReportMap((uint8_t*)_hidReportDescriptor, sizeof(_hidReportDescriptor));
+  uint8_t reportMap[sizeof(_hidReportDescriptor) + sizeof(_nkroReportDescriptor)];
+  size_t mapSize = sizeof(_hidReportDescriptor);
+  memcpy(reportMap, _hidReportDescriptor, sizeof(_hidReportDescriptor));
+  if (_nkro) {
+    memcpy(reportMap + mapSize, _nkroReportDescriptor, sizeof(_nkroReportDescriptor));
+    mapSize += sizeof(_nkroReportDescriptor);
+  }
+  hid->setReportMap(reportMap, mapSize);
   hid->startServices();
+  if (servicesCallback) servicesCallback(server);
 
   advertising = NimBLEDevice::getAdvertising();
   advertising->setAppearance(HID_KEYBOARD);
   advertising->addServiceUUID(hid->getHidService()->getUUID());
-  advertising->start();
+  advertising->setAdvertisingCompleteCallback([this](NimBLEAdvertising*) {
+    // Directed advertising has run out, keep waiting for the selected host
+    if (!connected && server->getConnectedCount() == 0) startAdvertising();
+  });
+  reconnectBurst = true;
+  startMeasuring();
+  startAdvertising();
 
   hid->setBatteryLevel(batteryLevel);
 
@@ -257,6 +219,10 @@ bool BleKeyboard::isConnected(void) {
   return connected;
 }
 
+uint8_t BleKeyboard::getLeds(void) {
+  return _leds;
+}
+
 void BleKeyboard::setBatteryLevel(uint8_t level) {
   batteryLevel = level;
   if (hid) hid->setBatteryLevel(batteryLevel);
@@ -267,36 +233,343 @@ void BleKeyboard::setName(std::string name) {
 }
 
 void BleKeyboard::setDelay(uint32_t ms) { _delay_ms = ms; }
+
+bool BleKeyboard::setLayout(const char* name) {
+  const uint16_t* layout = findKeyLayout(name);
+  if (!layout) return false;
+  _layout = layout;
+  return true;
+}
+
+void BleKeyboard::setLowLatency(bool fast) {
+  if (_link.fast == fast) return;
+  _link.fast = fast;
+  if (connected) requestConnParams();
+}
+
+void BleKeyboard::setPhy2M(bool enable) { _phy2M = enable; }
+
+void BleKeyboard::setServicesCallback(void (*callback)(NimBLEServer* server)) { servicesCallback = callback; }
+
+void BleKeyboard::setRoute(const HidRoute* route) { _route = route; }
+
+bool BleKeyboard::isRouted(void) {
+  return _route && _route->ready();
+}
+
+// Asks the host for the fast or the relaxed parameters, the host decides what
+// we get and tells us in onConnParamsUpdate()
+void BleKeyboard::requestConnParams(void) {
+  if (!server) return;
+  if (_link.fast) {
+    server->updateConnParams(_connHandle, BLE_FAST_MIN_INTERVAL, BLE_FAST_MAX_INTERVAL,
+                             BLE_FAST_LATENCY, BLE_SUPERVISION_TIMEOUT);
+  } else {
+    server->updateConnParams(_connHandle, BLE_RELAXED_MIN_INTERVAL, BLE_RELAXED_MAX_INTERVAL,
+                             BLE_RELAXED_LATENCY, BLE_SUPERVISION_TIMEOUT);
+  }
+}
+
+void BleKeyboard::storeLinkInfo(NimBLEConnInfo& connInfo) {
+  _connHandle = connInfo.getConnHandle();
+  _connInterval = connInfo.getConnInterval();
+  _link.interval = _connInterval;
+  _link.latency = connInfo.getConnLatency();
+  _link.timeout = connInfo.getConnTimeout();
+  ESP_LOGI(LOG_TAG, "Connection interval %u x 1.25 ms, latency %u, timeout %u x 10 ms",
+           _link.interval, _link.latency, _link.timeout);
+}
+
+BleLinkInfo BleKeyboard::getLinkInfo(void) {
+  return _link;
+}
+
+// Advertises to the selected bonded host only, so no other host takes the
+// connection and the selected one reconnects within about a second. Host 0
+// advertises to anyone, after one round to the last host on a wake.
+void BleKeyboard::startAdvertising(void) {
+  if (!advertising) return;
+  advertising->stop();
+
+  bool directed = false;
+  NimBLEAddress address;
+  if (_host > 0 && _host <= getHostCount()) {
+    address = NimBLEDevice::getBondedAddress(_host - 1);
+    directed = true;
+  } else if (reconnectBurst) {
+    Preferences prefs;
+    ble_addr_t last;
+    prefs.begin(BLE_PREFS_NAMESPACE, true);
+    if (prefs.getBytes(BLE_PREFS_LASTPEER, &last, sizeof(last)) == sizeof(last)) {
+      address = NimBLEAddress(last);
+      directed = NimBLEDevice::isBonded(address);
+    }
+    prefs.end();
+  }
+  reconnectBurst = false;
+
+  if (directed) {
+    advertising->setMinInterval(BLE_ADV_FAST_INTERVAL);
+    advertising->setMaxInterval(BLE_ADV_FAST_INTERVAL);
+    advertising->start(BLE_DIRECTED_ADV_MS, &address);
+    ESP_LOGI(LOG_TAG, "Advertising to %s", address.toString().c_str());
+  } else {
+    advertising->setMinInterval(BLE_ADV_MIN_INTERVAL);
+    advertising->setMaxInterval(BLE_ADV_MAX_INTERVAL);
+    advertising->start();
+  }
+}
+
+void BleKeyboard::reconnect(void) {
+  if (connected || !advertising) return;
+  reconnectBurst = true;
+  startMeasuring();
+  startAdvertising();
+}
+
+void BleKeyboard::startMeasuring(void) {
+  wakeAt = millis();
+  firstQueuedAt = 0;
+  _link.reconnectMs = 0;
+  _link.firstKeyMs = 0;
+  measuring = true;
+}
+
+// Reports wait until the link is encrypted, the host ignores them before that
+bool BleKeyboard::linkReady(void) {
+  return connected && (secured || millis() - connectedAt > BLE_SECURE_WAIT_MS);
+}
+
+// Drops the current host and advertises to the new one
+bool BleKeyboard::selectHost(uint8_t host) {
+  if (!advertising) {
+    _host = host; // Checked by begin(), the bonds are not loaded yet
+    return true;
+  }
+  if (host > getHostCount()) return false;
+  _host = host;
+  if (connected && server) {
+    server->disconnect(_connHandle); // onDisconnect() advertises
+  } else {
+    startAdvertising();
+  }
+  return true;
+}
+
+uint8_t BleKeyboard::getHost(void) { return _host; }
+
+uint8_t BleKeyboard::getHostCount(void) {
+  int bonds = NimBLEDevice::getNumBonds();
+  return bonds > 0 ? bonds : 0;
+}
+
+// The modifier bits a layout entry needs
+uint8_t BleKeyboard::layoutModifiers(uint16_t entry) {
+  return ((entry & LAYOUT_SHIFT) ? 0x02 : 0) | ((entry & LAYOUT_ALTGR) ? 0x40 : 0);
+}
+
 void BleKeyboard::set_vendor_id(uint16_t v) { vid = v; }
 void BleKeyboard::set_product_id(uint16_t p) { pid = p; }
 void BleKeyboard::set_version(uint16_t v) { version = v; }
 
-void BleKeyboard::sendReport(KeyReport* keys) {
-  if (!connected) return;
-  inputKeyboard->setValue((uint8_t*)keys, sizeof(KeyReport));
-  inputKeyboard->notify();
-  delay_ms(_delay_ms);
+bool BleKeyboard::sendReport(KeyReport* keys) {
+  if (isRouted()) {
+    stats.routed++;
+    return _route->sendKeys(keys->modifiers, keys->keys);
+  }
+  return queueReport(inputKeyboard, (uint8_t*)keys, sizeof(KeyReport));
 }
 
-void BleKeyboard::sendReport(MediaKeyReport* keys) {
-  if (!connected) return;
-  inputMediaKeys->setValue((uint8_t*)keys, sizeof(MediaKeyReport));
-  inputMediaKeys->notify();
-  delay_ms(_delay_ms);
+bool BleKeyboard::sendReport(MediaKeyReport* keys) {
+  if (isRouted()) {
+    stats.routed++;
+    return _route->sendMedia((*keys)[0] | ((*keys)[1] << 8));
+  }
+  return queueReport(inputMediaKeys, (uint8_t*)keys, sizeof(MediaKeyReport));
 }
 
-size_t BleKeyboard::press(uint8_t k) {
-  uint8_t i;
+bool BleKeyboard::sendReport(NkroReport* keys) {
+  if (isRouted()) {
+    // The route only has a boot report, it gets the first 6 keys
+    uint8_t boot[6] = {0};
+    uint8_t n = 0;
+    for (uint8_t k = 1; k < NKRO_KEY_BYTES * 8 && n < 6; k++) {
+      if (nkroHasKey(*keys, k)) boot[n++] = k;
+    }
+    stats.routed++;
+    return _route->sendKeys(keys->modifiers, boot);
+  }
+  return queueReport(inputNkro, (uint8_t*)keys, sizeof(NkroReport));
+}
+
+// Sends the keys that are down in the report begin() selected
+bool BleKeyboard::sendKeys(void) {
+  return _nkro ? sendReport(&_nkroReport) : sendReport(&_keyReport);
+}
+
+bool BleKeyboard::nkroHasKey(const NkroReport& report, uint8_t k) {
+  return report.keys[k >> 3] & (1 << (k & 7));
+}
+
+// Copies a report into the queue and returns, the sender task notifies it.
+// Only waits if the queue is full, a report that still does not fit is dropped.
+// While the host is away reports are kept, up to the queue length, until it is back.
+bool BleKeyboard::queueReport(NimBLECharacteristic* characteristic, const uint8_t* data, size_t length) {
+  if (!reportQueue || !characteristic || length > HID_REPORT_MAX) return false;
+
+  QueuedReport report;
+  report.characteristic = characteristic;
+  report.queuedAt = millis();
+  report.queuedUs = micros();
+  report.length = length;
+  memcpy(report.data, data, length);
+  if (measuring && !firstQueuedAt) firstQueuedAt = report.queuedAt | 1;
+
+  TickType_t wait = connected ? pdMS_TO_TICKS(HID_QUEUE_WAIT_MS) : 0;
+  if (xQueueSend(reportQueue, &report, wait) != pdTRUE) {
+    stats.dropped++;
+    return false;
+  }
+  UBaseType_t depth = uxQueueMessagesWaiting(reportQueue);
+  if (depth > stats.maxdepth) stats.maxdepth = depth;
+  return true;
+}
+
+// Sends the queued reports one at a time. A report is retried a connection
+// interval later when the controller is out of buffers (congested), and the
+// next one waits until the stack reports the notification as sent (onStatus).
+void BleKeyboard::senderTask(void* arg) {
+  BleKeyboard* keyboard = (BleKeyboard*)arg;
+  QueuedReport report;
+
+  for (;;) {
+    if (xQueueReceive(keyboard->reportQueue, &report, portMAX_DELAY) != pdTRUE) continue;
+
+    // Pending until the host is back, a stale report is not typed any more
+    while (!keyboard->linkReady() && millis() - report.queuedAt < BLE_PENDING_MAX_MS) {
+      xSemaphoreTake(keyboard->linkUp, pdMS_TO_TICKS(100));
+    }
+    if (!keyboard->linkReady()) {
+      keyboard->stats.dropped++;
+      continue;
+    }
+
+    // 1.25 ms units, rounded up to whole ticks
+    uint32_t interval_ms = keyboard->_connInterval ? (keyboard->_connInterval * 5 + 3) / 4 : 8;
+    TickType_t interval = pdMS_TO_TICKS(interval_ms) ? pdMS_TO_TICKS(interval_ms) : 1;
+
+    xSemaphoreTake(keyboard->notifyDone, 0); // Forget a late signal of the previous report
+    report.characteristic->setValue(report.data, report.length);
+
+    bool sent = report.characteristic->notify();
+    for (int attempt = 0; !sent && attempt < HID_NOTIFY_RETRIES && keyboard->connected; attempt++) {
+      keyboard->stats.retries++;
+      vTaskDelay(interval);
+      sent = report.characteristic->notify();
+    }
+
+    if (!sent) {
+      keyboard->stats.dropped++;
+      continue;
+    }
+
+    if (keyboard->tracing) {
+      if (keyboard->traceCount < keyboard->traceSize) {
+        HidTraceEntry& entry = keyboard->trace[keyboard->traceCount];
+        entry.queuedUs = report.queuedUs;
+        entry.sentUs = micros();
+        entry.reportId = report.characteristic == keyboard->inputMediaKeys ? MEDIA_KEYS_ID
+                       : report.characteristic == keyboard->inputNkro ? NKRO_ID : KEYBOARD_ID;
+        entry.length = report.length;
+        memcpy(entry.data, report.data, report.length);
+        keyboard->traceCount++;
+      } else {
+        keyboard->traceOverflow++;
+      }
+    }
+
+    xSemaphoreTake(keyboard->notifyDone, interval * 2);
+    keyboard->stats.sent++;
+
+    if (keyboard->measuring && keyboard->firstQueuedAt) {
+      keyboard->measuring = false;
+      keyboard->_link.firstKeyMs = millis() - keyboard->firstQueuedAt;
+      ESP_LOGI(LOG_TAG, "First key after wake sent after %lu ms", (unsigned long)keyboard->_link.firstKeyMs);
+    }
+
+    if (keyboard->_delay_ms) vTaskDelay(pdMS_TO_TICKS(keyboard->_delay_ms));
+  }
+}
+
+// The trace buffer is allocated by the first trace and then kept, so the
+// sender task never writes to freed memory. Later traces reuse its size.
+bool BleKeyboard::startTrace(size_t entries) {
+  tracing = false;
+  if (!trace) {
+    trace = (HidTraceEntry*)calloc(entries, sizeof(HidTraceEntry));
+    traceSize = trace ? entries : 0;
+  }
+  traceCount = 0;
+  traceOverflow = 0;
+  tracing = trace != nullptr;
+  return tracing;
+}
+
+void BleKeyboard::stopTrace(void) {
+  tracing = false;
+}
+
+size_t BleKeyboard::getTrace(const HidTraceEntry** entries, uint32_t* overflow) {
+  if (entries) *entries = trace;
+  if (overflow) *overflow = traceOverflow;
+  return traceCount;
+}
+
+void BleKeyboard::clearReports(void) {
+  if (reportQueue) xQueueReset(reportQueue);
+}
+
+HidQueueStats BleKeyboard::getQueueStats(void) {
+  HidQueueStats current = stats;
+  current.depth = reportQueue ? uxQueueMessagesWaiting(reportQueue) : 0;
+  return current;
+}
+
+// Marks a key as down or up without sending a report. Returns false if the
+// character is not on the layout or the boot report has no free slot.
+bool BleKeyboard::setKey(uint8_t k, bool down) {
+  uint8_t modifiers = 0;
   if (k >= 136) {
     k = k - 136;
   } else if (k >= 128) {
-    _keyReport.modifiers |= (1 << (k - 128));
+    modifiers = 1 << (k - 128);
     k = 0;
   } else {
-    extern const uint8_t _asciimap[128] PROGMEM;
-    k = pgm_read_byte(_asciimap + k);
-    if (!k) { setWriteError(); return 0; }
-    if (k & 0x80) { _keyReport.modifiers |= 0x02; k &= 0x7F; }
+    uint16_t entry = _layout[k];
+    k = entry & 0xFF;
+    if (!k) return false;
+    modifiers = layoutModifiers(entry);
+  }
+
+  if (_nkro) {
+    if (down) _nkroReport.modifiers |= modifiers;
+    else _nkroReport.modifiers &= ~modifiers;
+    if (k == 0 || k >= NKRO_KEY_BYTES * 8) return k == 0;
+    if (down) _nkroReport.keys[k >> 3] |= 1 << (k & 7);
+    else _nkroReport.keys[k >> 3] &= ~(1 << (k & 7));
+    return true;
+  }
+
+  if (down) _keyReport.modifiers |= modifiers;
+  else _keyReport.modifiers &= ~modifiers;
+  if (k == 0) return true;
+
+  uint8_t i;
+  if (!down) {
+    for (i = 0; i < 6; i++) {
+      if (_keyReport.keys[i] == k) _keyReport.keys[i] = 0x00;
+    }
+    return true;
   }
 
   if (_keyReport.keys[0] != k && _keyReport.keys[1] != k &&
@@ -305,42 +578,42 @@ size_t BleKeyboard::press(uint8_t k) {
     for (i = 0; i < 6; i++) {
       if (_keyReport.keys[i] == 0x00) { _keyReport.keys[i] = k; break; }
     }
-    if (i == 6) { setWriteError(); return 0; }
+    if (i == 6) return false;
   }
+  return true;
+}
 
-  sendReport(&_keyReport);
+size_t BleKeyboard::press(uint8_t k) {
+  if (!setKey(k, true)) { setWriteError(); return 0; }
+  sendKeys();
   return 1;
 }
 
 size_t BleKeyboard::release(uint8_t k) {
-  uint8_t i;
-
-  if (k >= 136) {
-    k = k - 136;
-  } else if (k >= 128) {
-    _keyReport.modifiers &= ~(1 << (k - 128));
-    k = 0;
-  } else {
-    extern const uint8_t _asciimap[128] PROGMEM;
-    k = pgm_read_byte(_asciimap + k);
-    if (!k) return 0;
-    if (k & 0x80) { _keyReport.modifiers &= ~(0x02); k &= 0x7F; }
-  }
+  if (!setKey(k, false)) return 0;
+  sendKeys();
+  return 1;
+}
 
-  for (i = 0; i < 6; i++) {
-    if (k != 0 && _keyReport.keys[i] == k) _keyReport.keys[i] = 0x00;
+// A chord goes out as one report instead of one report per key
+size_t BleKeyboard::pressKeys(const uint8_t *keys, size_t count) {
+  size_t n = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (keys[i] == 0) continue;
+    if (!setKey(keys[i], true)) { setWriteError(); break; }
+    n++;
   }
-
-  sendReport(&_keyReport);
-  return 1;
+  if (n) sendKeys();
+  return n;
 }
 
 void BleKeyboard::releaseAll(void) {
   memset(_keyReport.keys, 0, sizeof(_keyReport.keys));
   _keyReport.modifiers = 0;
+  memset(&_nkroReport, 0, sizeof(_nkroReport));
   _mediaKeyReport[0] = 0;
   _mediaKeyReport[1] = 0;
-  sendReport(&_keyReport);
+  sendKeys();
   sendReport(&_mediaKeyReport);
 }
 
@@ -373,43 +646,217 @@ size_t BleKeyboard::write(const MediaKeyReport c) {
 size_t BleKeyboard::write(uint8_t c) {
   uint8_t p = press(c);
   release(c);
+  if (p && c < 128 && (_layout[c] & LAYOUT_DEAD)) {
+    // A dead key waits for the next key, a space makes it type itself
+    press(' ');
+    release(' ');
+  }
   return p;
 }
 
+// Sends text with key rollover: every report adds one key to the ones that are
+// still down, so a character costs one report instead of a press and a release.
+// The keys are only released when all 6 slots are used, a key repeats or shift
+// changes. Keys and modifiers that were already held stay held.
 size_t BleKeyboard::write(const uint8_t *buffer, size_t size) {
+  if (_nkro) return writeNkro(buffer, size);
+
+  KeyReport base = _keyReport;
+  KeyReport report = base;
+  size_t n = 0;
+
+  for (; size > 0; size--, buffer++) {
+    uint8_t c = *buffer;
+    if (c == '\r') continue;
+
+    if (c >= 128 || (_layout[c] & LAYOUT_DEAD)) {
+      // Not a character (e.g. KEY_RETURN) or a dead key, send it the normal way
+      if (memcmp(&report, &base, sizeof(KeyReport)) != 0) sendReport(&base);
+      _keyReport = base;
+      if (!write(c)) break;
+      base = _keyReport;
+      report = base;
+      n++;
+      continue;
+    }
+
+    uint16_t entry = _layout[c];
+    uint8_t k = entry & 0xFF;
+    if (!k) { setWriteError(); break; }
+    uint8_t modifiers = base.modifiers | layoutModifiers(entry);
+
+    int slot = -1;
+    bool down = false;
+    for (int i = 0; i < 6; i++) {
+      if (report.keys[i] == k) down = true;
+      if (report.keys[i] == 0 && slot < 0) slot = i;
+    }
+
+    if (down || slot < 0 || modifiers != report.modifiers) {
+      if (memcmp(&report, &base, sizeof(KeyReport)) != 0) {
+        report = base;
+        if (!sendReport(&report)) break;
+      }
+      slot = -1;
+      for (int i = 0; i < 6; i++) {
+        if (report.keys[i] == 0) { slot = i; break; }
+      }
+      if (slot < 0) { setWriteError(); break; }
+    }
+
+    report.modifiers = modifiers;
+    report.keys[slot] = k;
+    if (!sendReport(&report)) break;
+    n++;
+  }
+
+  if (memcmp(&report, &base, sizeof(KeyReport)) != 0) sendReport(&base);
+  _keyReport = base;
+  return n;
+}
+
+// The rollover above for the NKRO report. Every key has its own bit, so the
+// keys are only released when a key repeats or shift changes.
+size_t BleKeyboard::writeNkro(const uint8_t *buffer, size_t size) {
+  NkroReport base = _nkroReport;
+  NkroReport report = base;
+  size_t n = 0;
+
+  for (; size > 0; size--, buffer++) {
+    uint8_t c = *buffer;
+    if (c == '\r') continue;
+
+    if (c >= 128 || (_layout[c] & LAYOUT_DEAD)) {
+      if (memcmp(&report, &base, sizeof(NkroReport)) != 0) sendReport(&base);
+      _nkroReport = base;
+      if (!write(c)) break;
+      base = _nkroReport;
+      report = base;
+      n++;
+      continue;
+    }
+
+    uint16_t entry = _layout[c];
+    uint8_t k = entry & 0xFF;
+    if (!k || k >= NKRO_KEY_BYTES * 8) { setWriteError(); break; }
+    uint8_t modifiers = base.modifiers | layoutModifiers(entry);
+
+    if (nkroHasKey(report, k) || modifiers != report.modifiers) {
+      if (memcmp(&report, &base, sizeof(NkroReport)) != 0) {
+        report = base;
+        if (!sendReport(&report)) break;
+      }
+    }
+
+    report.modifiers = modifiers;
+    report.keys[k >> 3] |= 1 << (k & 7);
+    if (!sendReport(&report)) break;
+    n++;
+  }
+
+  if (memcmp(&report, &base, sizeof(NkroReport)) != 0) sendReport(&base);
+  _nkroReport = base;
+  return n;
+}
+
+// Only looks the bytes up in the layout. write() would take a byte from 0x80 on
+// as a modifier or a raw usage (0x83 is GUI, 0xC3 is F2), which arbitrary text
+// must never send.
+size_t BleKeyboard::writeText(const uint8_t *buffer, size_t size, uint32_t* skipped) {
+  uint8_t text[32];
   size_t n = 0;
-  while (size--) {
-    if (*buffer != '\r') {
-      if (write(*buffer)) n++;
-      else break;
+  while (size > 0) {
+    size_t length = 0;
+    for (; size > 0 && length < sizeof(text); size--, buffer++) {
+      uint8_t c = *buffer;
+      if (c == '\r' || (c < 128 && (_layout[c] & 0xFF))) {
+        text[length++] = c;
+      } else if (skipped) {
+        (*skipped)++;
+      }
     }
-    buffer++;
+    n += write(text, length);
   }
   return n;
 }
 
 void BleKeyboard::onConnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo) {
   (void)pServer;
-  (void)connInfo;
+  storeLinkInfo(connInfo);
+  _link.txPhy = 1;
+  _link.rxPhy = 1;
+  secured = connInfo.isEncrypted();
+  connectedAt = millis();
   connected = true;
+
+  // Hosts start with whatever interval they like, often 30 to 50 ms
+  requestConnParams();
+#if defined(BLE_HAS_2M_PHY)
+  if (_phy2M) {
+    server->updatePhy(_connHandle, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK, 0);
+  }
+#endif
+}
+
+void BleKeyboard::onConnParamsUpdate(NimBLEConnInfo& connInfo) {
+  storeLinkInfo(connInfo);
 }
 
+#if defined(BLE_HAS_2M_PHY)
+void BleKeyboard::onPhyUpdate(NimBLEConnInfo& connInfo, uint8_t txPhy, uint8_t rxPhy) {
+  (void)connInfo;
+  _link.txPhy = txPhy;
+  _link.rxPhy = rxPhy;
+  ESP_LOGI(LOG_TAG, "PHY tx %u rx %u", txPhy, rxPhy);
+}
+#endif
+
 void BleKeyboard::onDisconnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo, int reason) {
   (void)pServer;
   (void)connInfo;
   (void)reason;
   connected = false;
-  if (advertising) advertising->start();
+  secured = false;
+  _connInterval = 0;
+  _link.interval = 0;
+  startAdvertising();
 }
 
+// The link is encrypted: remember the host for the next wake and send what is pending
+void BleKeyboard::onAuthenticationComplete(NimBLEConnInfo& connInfo) {
+  if (!connInfo.isEncrypted()) return;
+  secured = true;
+
+  if (measuring && !_link.reconnectMs) {
+    _link.reconnectMs = millis() - wakeAt;
+    ESP_LOGI(LOG_TAG, "Host back %lu ms after wake", (unsigned long)_link.reconnectMs);
+  }
+
+  if (connInfo.isBonded()) {
+    ble_addr_t peer = *connInfo.getIdAddress().getBase();
+    ble_addr_t last;
+    Preferences prefs;
+    prefs.begin(BLE_PREFS_NAMESPACE, false);
+    if (prefs.getBytes(BLE_PREFS_LASTPEER, &last, sizeof(last)) != sizeof(last) ||
+        memcmp(&last, &peer, sizeof(peer)) != 0) {
+      prefs.putBytes(BLE_PREFS_LASTPEER, &peer, sizeof(peer));
+    }
+    prefs.end();
+  }
+
+  if (linkUp) xSemaphoreGive(linkUp);
+}
+
+// The host writes its lock LEDs to the keyboard output report
 void BleKeyboard::onWrite(NimBLECharacteristic* pCharacteristic, NimBLEConnInfo& connInfo) {
-  (void)pCharacteristic;
   (void)connInfo;
+  if (pCharacteristic != outputKeyboard) return;
+  NimBLEAttValue value = pCharacteristic->getValue();
+  if (value.size() >= 1) _leds = value[0];
 }
 
-void BleKeyboard::delay_ms(uint64_t ms) {
-  if (!ms) return;
-  uint64_t start = esp_timer_get_time();
-  uint64_t end = start + (ms * 1000ULL);
-  while (esp_timer_get_time() < end) {}
+void BleKeyboard::onStatus(NimBLECharacteristic* pCharacteristic, int code) {
+  (void)pCharacteristic;
+  (void)code;
+  if (notifyDone) xSemaphoreGive(notifyDone);
 }
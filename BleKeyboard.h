@@ -10,9 +10,61 @@
 
 #include "HIDTypes.h"
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+// Reports wait in a queue and are sent by their own task, so callers do not block
+#define HID_REPORT_QUEUE_LENGTH 32
+#define HID_REPORT_MAX 17 // Bytes in the largest input report (NKRO)
+
+struct HidQueueStats {
+  uint32_t sent;     // Reports notified to the host
+  uint32_t dropped;  // Reports lost because the queue stayed full or the controller stayed congested
+  uint32_t retries;  // Notifications retried because the controller was out of buffers
+  uint8_t depth;     // Reports waiting now
+  uint8_t maxdepth;  // Most reports that were ever waiting
+  uint32_t routed;   // Reports that went to the route (e.g. USB) instead
+};
+
+// Another transport that takes the key reports while it is ready, e.g. USB
+// (see UsbKeyboard.h). Its reports skip the BLE queue.
+struct HidRoute {
+  bool (*ready)(void);
+  bool (*sendKeys)(uint8_t modifiers, const uint8_t* keys); // The 6 keys of a boot report
+  bool (*sendMedia)(uint16_t bits);                         // The media key bits, see HIDTypes.h
+};
+
+// One sent report in the trace, see startTrace()
+struct HidTraceEntry {
+  uint32_t queuedUs; // micros() when the report was made
+  uint32_t sentUs;   // micros() when it was handed to the controller
+  uint8_t reportId;  // KEYBOARD_ID, MEDIA_KEYS_ID or NKRO_ID
+  uint8_t length;
+  uint8_t data[HID_REPORT_MAX];
+};
+
+// The negotiated connection, see getLinkInfo()
+struct BleLinkInfo {
+  uint16_t interval; // In units of 1.25 ms
+  uint16_t latency;  // Connection events the host lets us skip
+  uint16_t timeout;  // Supervision timeout in units of 10 ms
+  uint8_t txPhy;     // 1 = 1M, 2 = 2M, 3 = Coded
+  uint8_t rxPhy;
+  bool fast;         // True if the low latency parameters are requested
+  uint32_t reconnectMs; // From begin() or reconnect() until the link was encrypted, 0 if not measured
+  uint32_t firstKeyMs;  // How long the first report after that waited to be sent
+};
+
+// The 2M PHY is not available on the original ESP32
+#if !defined(CONFIG_IDF_TARGET_ESP32)
+  #define BLE_HAS_2M_PHY
+#endif
+
 // Report IDs:
 #define KEYBOARD_ID    0x01
 #define MEDIA_KEYS_ID  0x02
+#define NKRO_ID        0x03
 
 class BleKeyboard : public Print,
                     public NimBLEServerCallbacks,
@@ -22,14 +74,27 @@ public:
               std::string deviceManufacturer = "FreeTouchDeck",
               uint8_t batteryLevel = 100);
 
-  void begin(void);
+  void begin(bool nkro = false); // nkro: send keys in a bitmap report instead of the 6 key boot report
   void end(void);
 
   bool isConnected(void);
+  uint8_t getLeds(void); // Num, Caps and Scroll Lock from the host, bits 0 to 2
 
   void setBatteryLevel(uint8_t level);
   void setName(std::string deviceName);
-  void setDelay(uint32_t ms);
+  void setDelay(uint32_t ms); // Extra gap between reports, 0 by default
+  bool setLayout(const char* name); // "us", "uk", "de" or "fr"
+  void setLowLatency(bool fast);    // Short interval while in use, relaxed parameters in standby
+  void setPhy2M(bool enable);       // Ask for the 2M PHY when a host connects
+
+  // Host 0 is any host (and pairs new ones), 1 to getHostCount() are the bonded hosts
+  bool selectHost(uint8_t host);
+  uint8_t getHost(void);
+  uint8_t getHostCount(void);
+  void reconnect(void); // After a wake: call the last host back quickly, reports wait until it is back
+  void setServicesCallback(void (*callback)(NimBLEServer* server)); // Adds services next to HID in begin()
+  void setRoute(const HidRoute* route);
+  bool isRouted(void); // The reports go to the route right now
 
   void set_vendor_id(uint16_t vid);
   void set_product_id(uint16_t pid);
@@ -38,10 +103,14 @@ public:
   // Print
   size_t write(uint8_t c) override;
   size_t write(const uint8_t *buffer, size_t size) override;
+  // Text only, e.g. from a file: characters that are not on the layout (any
+  // byte from 0x80 on, like UTF-8) are skipped and counted, never sent as keys
+  size_t writeText(const uint8_t *buffer, size_t size, uint32_t* skipped = nullptr);
 
   // Keyboard
   size_t press(uint8_t k);
   size_t release(uint8_t k);
+  size_t pressKeys(const uint8_t *keys, size_t count); // Presses all keys in one report, 0 is skipped
   void releaseAll(void);
 
   // Media keys
@@ -52,32 +121,100 @@ public:
   // Callbacks (NimBLE 2.x signatures)
   void onConnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo) override;
   void onDisconnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo, int reason) override;
+  void onConnParamsUpdate(NimBLEConnInfo& connInfo) override;
+#if defined(BLE_HAS_2M_PHY)
+  void onPhyUpdate(NimBLEConnInfo& connInfo, uint8_t txPhy, uint8_t rxPhy) override;
+#endif
+  void onAuthenticationComplete(NimBLEConnInfo& connInfo) override;
   void onWrite(NimBLECharacteristic* pCharacteristic, NimBLEConnInfo& connInfo) override;
+  void onStatus(NimBLECharacteristic* pCharacteristic, int code) override;
+
+  HidQueueStats getQueueStats(void);
+  void clearReports(void); // Drop the reports that have not been sent yet
+  BleLinkInfo getLinkInfo(void);
+
+  // Records every sent report until the buffer is full or stopTrace().
+  // The buffer of the first trace is kept for the later ones.
+  bool startTrace(size_t entries);
+  void stopTrace(void);
+  size_t getTrace(const HidTraceEntry** entries, uint32_t* overflow = nullptr);
 
 private:
-  void sendReport(KeyReport* keys);
-  void sendReport(MediaKeyReport* keys);
-  void delay_ms(uint64_t ms);
+  struct QueuedReport {
+    NimBLECharacteristic* characteristic;
+    uint32_t queuedAt; // millis()
+    uint32_t queuedUs; // micros(), for the trace
+    uint8_t length;
+    uint8_t data[HID_REPORT_MAX];
+  };
+
+  bool sendReport(KeyReport* keys);
+  bool sendReport(MediaKeyReport* keys);
+  bool sendReport(NkroReport* keys);
+  bool sendKeys(void);
+  bool setKey(uint8_t k, bool down);
+  size_t writeNkro(const uint8_t *buffer, size_t size);
+  static bool nkroHasKey(const NkroReport& report, uint8_t k);
+  bool queueReport(NimBLECharacteristic* characteristic, const uint8_t* data, size_t length);
+  static void senderTask(void* arg);
+  static uint8_t layoutModifiers(uint16_t entry);
+  void requestConnParams(void);
+  void startAdvertising(void);
+  bool linkReady(void);
+  void startMeasuring(void);
+  void storeLinkInfo(NimBLEConnInfo& connInfo);
 
   NimBLEHIDDevice*       hid = nullptr;
   NimBLECharacteristic*  inputKeyboard = nullptr;
   NimBLECharacteristic*  outputKeyboard = nullptr;
   NimBLECharacteristic*  inputMediaKeys = nullptr;
+  NimBLECharacteristic*  inputNkro = nullptr; // Only with begin(true)
 
   NimBLEAdvertising*     advertising = nullptr;
+  NimBLEServer*          server = nullptr;
 
   bool connected = false;
+  volatile uint8_t _leds = 0; // The last LED output report
+  bool secured = false;      // The link is encrypted, reports can go out
+  uint32_t connectedAt = 0;  // millis()
+  bool reconnectBurst = false; // Advertise to the last host before anyone else
+
+  // Time to the first keystroke after a wake
+  bool measuring = false;
+  uint32_t wakeAt = 0;
+  uint32_t firstQueuedAt = 0;
 
   std::string deviceName;
   std::string deviceManufacturer;
 
   uint8_t batteryLevel = 100;
-  uint32_t _delay_ms = 8;
+  uint32_t _delay_ms = 0;
+  uint16_t _connInterval = 0; // In units of 1.25 ms, 0 if not known
+  uint16_t _connHandle = 0;
+  BleLinkInfo _link{0, 0, 0, 1, 1, true, 0, 0};
+  bool _phy2M = false;
+  uint8_t _host = 0;
+  void (*servicesCallback)(NimBLEServer* server) = nullptr;
+  const HidRoute* _route = nullptr;
+  const uint16_t* _layout;    // See KeyLayouts.h
+
+  QueueHandle_t reportQueue = nullptr;
+  SemaphoreHandle_t notifyDone = nullptr; // Given by onStatus() when a notification has been sent
+  SemaphoreHandle_t linkUp = nullptr;     // Given when the link is encrypted, pending reports go out
+  HidQueueStats stats{};
+
+  HidTraceEntry* trace = nullptr;
+  size_t traceSize = 0;
+  volatile size_t traceCount = 0;
+  volatile uint32_t traceOverflow = 0; // Reports sent after the buffer was full
+  volatile bool tracing = false;
 
   uint16_t vid = 0x05AC;     // default-ish
   uint16_t pid = 0x0220;
   uint16_t version = 0x0110;
 
   KeyReport _keyReport{};
+  NkroReport _nkroReport{};
+  bool _nkro = false;
   MediaKeyReport _mediaKeyReport{0,0};
 };
@@ -1,53 +1,290 @@
-// Start as WiFi station
+/*
+ * WiFi bring-up.
+ *
+ * Connecting as a station does not block: wifiStart() calls WiFi.begin() and
+ * returns, the WiFi events tell us when we got an IP or lost the AP, and
+ * wifiTick() (called by the UI task every tick) moves the state machine on.
+ * A failed attempt is tried again after a backoff that starts at
+ * wificonfig.attemptdelay and doubles every attempt. After wificonfig.attempts
+ * failed attempts we give up, unless we were connected before: then we keep
+ * trying in the background.
+ *
+ * With "keepble" in wificonfig.json the BLE keyboard keeps running next to the
+ * configurator. WiFi then uses modem sleep (the radio is shared, WiFi has to
+ * give it up between beacons) and the coexistence arbiter prefers Bluetooth,
+ * so key reports are not held up by web traffic. Config the configurator saves
+ * is applied to the running deck, see configReload().
+ */
+
+#include "esp_coexist.h"
+
+#define WIFI_ATTEMPT_TIMEOUT_MS 10000 // Longest wait for an IP after WiFi.begin()
+#define WIFI_BACKOFF_MAX_MS 8000      // Longest wait between two attempts
+
+enum WifiState : uint8_t
+{
+  WIFI_STATE_OFF,
+  WIFI_STATE_CONNECTING, // Waiting for an IP
+  WIFI_STATE_BACKOFF,    // Waiting to try again
+  WIFI_STATE_CONNECTED,
+  WIFI_STATE_FAILED      // All attempts failed, only with the webserver (config mode)
+};
+
+WifiState wifiState = WIFI_STATE_OFF;
+uint8_t wifiAttempt = 0;
+uint32_t wifiStateSince = 0;
+uint32_t wifiBackoffMs = 0;
+bool wifiStopBle = true;
+bool wifiStartWebserver = true;
+bool wifiServing = false; // We were connected, a lost connection is retried for good
+bool wifiBleStopped = false;
+bool wifiWebserverStarted = false;
+bool wifiEventsAdded = false;
+
+// Set by the WiFi event task, handled by wifiTick()
+volatile bool wifiGotIp = false;
+volatile bool wifiLost = false;
+volatile uint8_t wifiLostReason = 0;
 
-bool startWifiStation(bool stopble, bool startwebserver){
-  
-  Serial.printf("[INFO]: Connecting to %s", wificonfig.ssid);
-  if (String(WiFi.SSID()) != String(wificonfig.ssid))
+/**
+* @brief This function handles the WiFi events of the station.
+*
+* @param event arduino_event_id_t
+* @param info arduino_event_info_t
+*
+* @return none
+*
+* @note Runs on the WiFi event task, so it only sets flags for wifiTick().
+*/
+void wifiEvent(arduino_event_id_t event, arduino_event_info_t info)
+{
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+  {
+    wifiGotIp = true;
+  }
+  else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
   {
-      WiFi.mode(WIFI_STA);
-      WiFi.begin(wificonfig.ssid, wificonfig.password);
-      uint8_t attempts = wificonfig.attempts;
-      while (WiFi.status() != WL_CONNECTED)
+    wifiLostReason = info.wifi_sta_disconnected.reason;
+    wifiLost = true;
+  }
+}
+
+/**
+* @brief This function starts one attempt to connect to wificonfig.ssid.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void wifiBeginAttempt()
+{
+  if (wifiAttempt < UINT8_MAX)
+  {
+    wifiAttempt++;
+  }
+  wifiGotIp = false;
+  wifiLost = false;
+  wifiState = WIFI_STATE_CONNECTING;
+  wifiStateSince = millis();
+  WiFi.begin(wificonfig.ssid, wificonfig.password);
+  Serial.printf("[INFO]: Connecting to %s, attempt %u\n", wificonfig.ssid, wifiAttempt);
+}
+
+/**
+* @brief This function stops BLE and starts mDNS and the webserver if asked
+         to, unless that was done before.
+*
+* @param none
+*
+* @return none
+*
+* @note WiFi may already be up for webhooks (see Webhook.h) when config mode
+         starts, it then only adds the webserver.
+*/
+void wifiConnected()
+{
+  Serial.print("[INFO]: Connected! IP address: ");
+  Serial.println(WiFi.localIP());
+
+  wifiServing = true;
+
+  if (wifiStopBle && !wifiBleStopped)
+  {
+    wifiBleStopped = true;
+
+    // Delete the task bleKeyboard had create to free memory and to not interfere with AsyncWebServer
+    bleKeyboard.end();
+
+    // Stop BLE from interfering with our WIFI signal.
+    // NOTE: Legacy esp_bt_controller_* APIs are not available on Arduino-ESP32 core 3.x
+    // (IDF 5+) and Classic Bluetooth is not supported on ESP32-S3.
+    btStop();
+
+    Serial.println("[INFO]: BLE Stopped");
+  }
+
+  if (wifiStartWebserver && !wifiWebserverStarted)
+  {
+    wifiWebserverStarted = true;
+    // Open port 80
+    MDNS.begin(wificonfig.hostname);
+    MDNS.addService("http", "tcp", 80);
+    // Start the webserver
+    webserver.begin();
+    Serial.println("[INFO]: Webserver started");
+  }
+}
+
+/**
+* @brief This function starts connecting to wificonfig.ssid as a station.
+*
+* @param stopble bool stop BLE once connected
+* @param startwebserver bool start mDNS and the webserver once connected
+*
+* @return none
+*
+* @note Does not block, call wifiTick() until it returns WIFI_STATE_CONNECTED
+         or WIFI_STATE_FAILED. Without the webserver a failed connection turns
+         WiFi off, so wifiTick() returns WIFI_STATE_OFF instead.
+*/
+void wifiStart(bool stopble, bool startwebserver)
+{
+  wifiStopBle = stopble;
+  wifiStartWebserver = startwebserver;
+  wifiAttempt = 0;
+
+  if (!wifiEventsAdded)
+  {
+    WiFi.onEvent(wifiEvent);
+    wifiEventsAdded = true;
+  }
+
+  if (WiFi.status() == WL_CONNECTED && String(WiFi.SSID()) == String(wificonfig.ssid))
+  {
+    wifiState = WIFI_STATE_CONNECTED;
+    wifiConnected();
+    return;
+  }
+
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false); // wifiTick() does the retrying
+  if (!stopble)
+  {
+    // WiFi and BLE share the radio: WiFi must sleep between beacons, and keys go first
+    WiFi.setSleep(WIFI_PS_MIN_MODEM);
+    esp_coex_preference_set(ESP_COEX_PREFER_BT);
+    Serial.println("[INFO]: WiFi and BLE keyboard run side by side");
+  }
+  wifiBeginAttempt();
+}
+
+/**
+* @brief This function disconnects and turns the WiFi radio off.
+*
+* @param none
+*
+* @return none
+*
+* @note Only while BLE is still running and the webserver was not started.
+*/
+void wifiStop()
+{
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+  wifiState = WIFI_STATE_OFF;
+  wifiServing = false;
+}
+
+/**
+* @brief This function stops connecting and turns WiFi off.
+*
+* @param none
+*
+* @return none
+*
+* @note Only for a connection that is not serving yet, BLE is still running then.
+*/
+void wifiCancel()
+{
+  wifiStop();
+  Serial.println("[INFO]: WiFi connection cancelled");
+}
+
+/**
+* @brief This function moves the WiFi state machine on.
+*
+* @param none
+*
+* @return WifiState the state after this tick
+*
+* @note Called by the UI task every tick, also after config mode was left with
+         the keyboard still running. Does not block.
+*/
+WifiState wifiTick()
+{
+  uint32_t now = millis();
+
+  switch (wifiState)
+  {
+  case WIFI_STATE_CONNECTING:
+    if (wifiGotIp)
+    {
+      wifiGotIp = false;
+      wifiState = WIFI_STATE_CONNECTED;
+      wifiConnected();
+    }
+    else if (wifiLost || now - wifiStateSince > WIFI_ATTEMPT_TIMEOUT_MS)
+    {
+      Serial.printf("[WARNING]: WiFi attempt %u failed (reason %u)\n", wifiAttempt, wifiLost ? wifiLostReason : 0);
+      WiFi.disconnect();
+      if (wifiAttempt >= wificonfig.attempts && !wifiServing)
       {
-        if(attempts == 0) {
-          WiFi.disconnect();
-          Serial.println("");
-          return false;
-          
+        if (wifiStartWebserver)
+        {
+          wifiState = WIFI_STATE_FAILED; // Config mode starts its own AP
         }
-        delay(wificonfig.attemptdelay);
-        Serial.print(".");
-        attempts--;
-
+        else
+        {
+          // Left in station mode the radio would keep standby from light sleeping
+          Serial.println("[WARNING]: Could not connect to WiFi, WiFi turned off");
+          wifiStop();
+        }
+        break;
       }
-    }
-      if(stopble){
-      // Delete the task bleKeyboard had create to free memory and to not interfere with AsyncWebServer
-        bleKeyboard.end();
-      
-        // Stop BLE from interfering with our WIFI signal.
-        // NOTE: Legacy esp_bt_controller_* APIs are not available on Arduino-ESP32 core 3.x
-        // (IDF 5+) and Classic Bluetooth is not supported on ESP32-S3.
-        btStop();
-
-        Serial.println("");
-        Serial.println("[INFO]: BLE Stopped");
-        // Set pageNum to 7 so no buttons are displayed and touches are ignored
-        pageNum = 7;
-      }  
-      Serial.print("[INFO]: Connected! IP address: ");
-      Serial.println(WiFi.localIP());
-    
-      if(startwebserver){
-        // Open port 80
-        MDNS.begin(wificonfig.hostname);
-        MDNS.addService("http", "tcp", 80);
-        // Start the webserver
-        webserver.begin();
-        Serial.println("[INFO]: Webserver started");
+      wifiBackoffMs = wificonfig.attemptdelay;
+      for (uint8_t i = 1; i < wifiAttempt && wifiBackoffMs < WIFI_BACKOFF_MAX_MS; i++)
+      {
+        wifiBackoffMs *= 2;
       }
-      return true;
+      wifiBackoffMs = min(wifiBackoffMs, (uint32_t)WIFI_BACKOFF_MAX_MS);
+      wifiState = WIFI_STATE_BACKOFF;
+      wifiStateSince = now;
+    }
+    break;
+
+  case WIFI_STATE_BACKOFF:
+    if (now - wifiStateSince >= wifiBackoffMs)
+    {
+      wifiBeginAttempt();
+    }
+    break;
+
+  case WIFI_STATE_CONNECTED:
+    if (wifiLost)
+    {
+      // The webserver keeps running, it is reachable again once we are back
+      Serial.println("[WARNING]: WiFi connection lost, reconnecting");
+      wifiAttempt = 0;
+      wifiBeginAttempt();
+    }
+    break;
+
+  default:
+    break;
+  }
+  return wifiState;
 }
 
 // Start as WiFi AP
@@ -72,9 +309,6 @@ void startWifiAP(){
    MDNS.begin(wificonfig.hostname);
   MDNS.addService("http", "tcp", 80);
 
-  // Set pageNum to 7 so no buttons are displayed and touches are ignored
-  pageNum = 7;
-
   // Start the webserver
   webserver.begin();
   Serial.println("[INFO]: Webserver started");
@@ -103,19 +337,19 @@ void startDefaultAP(){
   MDNS.begin("freetouchdeck");
   MDNS.addService("http", "tcp", 80);
 
-  // Set pageNum to 7 so no buttons are displayed and touches are ignored
-  pageNum = 7;
-
   // Start the webserver
   webserver.begin();
   Serial.println("[INFO]: Webserver started");
           
 }
 
+// What configModeTick() has drawn
+WifiState configModeShown = WIFI_STATE_OFF;
+uint8_t configModeShownAttempt = 0;
+uint8_t configModeShownDots = 0;
+
 /**
-* @brief This function stops Bluetooth and connects to the given 
-         WiFi network. It the starts mDNS and starts the Async
-         Webserver.
+* @brief This function clears the screen for a config mode message.
 *
 * @param none
 *
@@ -123,68 +357,75 @@ void startDefaultAP(){
 *
 * @note none
 */
-void configmode()
+void configModeClear()
 {
-
   tft.fillScreen(TFT_BLACK);
   tft.setCursor(0, 0);
   tft.setTextFont(2);
   tft.setTextSize(1);
   tft.setTextColor(TFT_WHITE, TFT_BLACK);
+}
+
+/**
+* @brief This function starts the default AP and tells the user how to reach
+         the configurator.
+*
+* @param reason const char * why we started as AP
+*
+* @return none
+*
+* @note none
+*/
+void configModeDefaultAP(const char *reason)
+{
+  startDefaultAP();
+  configModeClear();
+  tft.printf("Started as AP because %s.\n", reason);
+  tft.println("To configure, connect to 'FreeTouchDeck' with password 'defaultpass'");
+  tft.println("Then go to http://freetouchdeck.local");
+  tft.print("The IP is: ");
+  tft.println(WiFi.softAPIP());
+  drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
+}
+
+/**
+* @brief This function stops Bluetooth and connects to the given 
+         WiFi network. It the starts mDNS and starts the Async
+         Webserver.
+*
+* @param none
+*
+* @return none
+*
+* @note In WIFI_STA mode this only starts connecting, configModeTick() draws
+         the progress and what to do once we are connected or have given up.
+*/
+void configmode()
+{
+  configModeClear();
 
   Serial.println("[INFO]: Entering Config Mode");
-  tft.println("Connecting to Wifi...");
 
   if (String(wificonfig.ssid) == "YOUR_WIFI_SSID" || String(wificonfig.password) == "YOUR_WIFI_PASSWORD") // Still default
   {
-    tft.println("WiFi Config still set to default! Starting as AP.");
     Serial.println("[WARNING]: WiFi Config still set to default! Configurator started as AP.");
-    startDefaultAP();
-    tft.println("Started as AP because WiFi settings are still set to default.");
-    tft.println("To configure, connect to 'FreeTouchDeck' with password 'defaultpass'");
-    tft.println("Then go to http://freetouchdeck.local");
-    tft.print("The IP is: ");
-    tft.println(WiFi.softAPIP());
-    drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
+    configModeDefaultAP("WiFi settings are still set to default");
     return;
   }
 
   if (String(wificonfig.ssid) == "FAILED" || String(wificonfig.password) == "FAILED" || String(wificonfig.wifimode) == "FAILED") // The wificonfig.json failed to load
   {
-    tft.println("WiFi Config Failed to load! Starting as AP.");
     Serial.println("[WARNING]: WiFi Config Failed to load! Configurator started as AP.");
-    startDefaultAP();
-    tft.println("Started as AP because WiFi settings failed to load.");
-    tft.println("To configure, connect to 'FreeTouchDeck' with password 'defaultpass'");
-    tft.println("Then go to http://freetouchdeck.local");
-    tft.print("The IP is: ");
-    tft.println(WiFi.softAPIP());
-    drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
+    configModeDefaultAP("WiFi settings failed to load");
     return;
   }
 
   if (strcmp(wificonfig.wifimode, "WIFI_STA") == 0)
   {
-    if(!startWifiStation(true, true)){
-      startDefaultAP();
-      Serial.println("[WARNING]: Could not connect to AP, so started as AP.");
-      tft.println("Started as AP because WiFi connection failed.");
-      tft.println("To configure, connect to 'FreeTouchDeck' with password 'defaultpass'");
-      tft.println("Then go to http://freetouchdeck.local");
-      tft.print("The IP is: ");
-      tft.println(WiFi.softAPIP());
-      drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
-    }
-    else
-    {
-      tft.println("Started as STA and in config mode.");
-      tft.println("To configure:");
-      tft.println("http://freetouchdeck.local");
-      tft.print("The IP is: ");
-      tft.println(WiFi.localIP());
-      drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
-    }
-
+    tft.printf("Connecting to %s\n", wificonfig.ssid);
+    drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Cancel");
+    configModeShown = WIFI_STATE_OFF;
+    wifiStart(!wificonfig.keepble, true);
   }
   else if (strcmp(wificonfig.wifimode, "WIFI_AP") == 0)
   {
@@ -198,6 +439,156 @@ void configmode()
   }
 }
 
+/**
+* @brief This function follows the WiFi connection in config mode.
+*
+* @param none
+*
+* @return none
+*
+* @note Called by the UI task every tick on the config mode page, after
+         wifiTick(). Only redraws the status line when it changes.
+*/
+void configModeTick()
+{
+  WifiState state = wifiState;
+  if (state == WIFI_STATE_OFF)
+  {
+    return;
+  }
+  if (wifiServing && state != WIFI_STATE_CONNECTED)
+  {
+    return; // Reconnecting in the background, the screen keeps the IP
+  }
+
+  if (state == WIFI_STATE_CONNECTED)
+  {
+    if (configModeShown == state)
+    {
+      return;
+    }
+    configModeShown = state;
+    configModeClear();
+    tft.println("Started as STA and in config mode.");
+    tft.println("To configure:");
+    tft.println("http://freetouchdeck.local");
+    tft.print("The IP is: ");
+    tft.println(WiFi.localIP());
+    if (wifiStopBle)
+    {
+      drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
+    }
+    else
+    {
+      tft.println("The keyboard keeps working and changes apply right away.");
+      drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Back");
+    }
+    return;
+  }
+
+  if (state == WIFI_STATE_FAILED)
+  {
+    if (configModeShown == state)
+    {
+      return;
+    }
+    configModeShown = state;
+    Serial.println("[WARNING]: Could not connect to AP, so started as AP.");
+    configModeDefaultAP("WiFi connection failed");
+    return;
+  }
+
+  // Connecting or waiting to try again: one status line under the SSID
+  uint8_t dots = (millis() - wifiStateSince) / 500 % 4;
+  if (state == configModeShown && wifiAttempt == configModeShownAttempt && dots == configModeShownDots)
+  {
+    return;
+  }
+  configModeShown = state;
+  configModeShownAttempt = wifiAttempt;
+  configModeShownDots = dots;
+
+  tft.fillRect(0, 20, tft.width(), 20, TFT_BLACK);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  tft.setTextSize(1);
+  tft.setCursor(0, 20);
+  if (state == WIFI_STATE_CONNECTING)
+  {
+    tft.printf("Attempt %u of %u", wifiAttempt, wificonfig.attempts);
+    for (uint8_t i = 0; i < dots; i++)
+    {
+      tft.print('.');
+    }
+  }
+  else
+  {
+    uint32_t waited = millis() - wifiStateSince;
+    uint32_t left = waited < wifiBackoffMs ? wifiBackoffMs - waited : 0;
+    tft.printf("Attempt %u failed, trying again in %lu s", wifiAttempt, (unsigned long)((left + 999) / 1000));
+  }
+}
+
+/**
+* @brief This function applies a config file the configurator has saved.
+*
+* @param what int16_t a menu page, PAGE_HOME (homescreen.json), RELOAD_GENERAL
+*             or RELOAD_WIFI
+*
+* @return none
+*
+* @note Runs on the UI task, see UI_EVENT_RELOAD. The page on screen is redrawn
+         if it uses the file. WiFi settings are used the next time config mode
+         starts.
+*/
+void pressCancel(); // See PressHandler.h
+
+void configReload(int16_t what)
+{
+  if (what == RELOAD_GENERAL)
+  {
+    if (!loadConfig("general"))
+    {
+      Serial.println("[WARNING]: general.json seems to be corrupted, not applied.");
+      return;
+    }
+    setLatched(PAGE_SETTINGS, 3, generalconfig.sleepenable);
+    if (generalconfig.sleepenable)
+    {
+      Interval = generalconfig.sleeptimer * 60000;
+    }
+    bleKeyboard.setLayout(generalconfig.keyboardlayout);
+  }
+  else if (what == PAGE_HOME)
+  {
+    if (!loadConfig("homescreen"))
+    {
+      Serial.println("[WARNING]: homescreen.json seems to be corrupted, not applied.");
+      return;
+    }
+  }
+  else if (what == RELOAD_WIFI)
+  {
+    loadMainConfig();
+    return;
+  }
+  else if (isMenuPage(what))
+  {
+    pressCancel(); // A held button points into the cache
+    menuCacheClear(); // Loaded again when it is shown
+  }
+  else
+  {
+    return;
+  }
+  Serial.printf("[INFO]: Config %d applied\n", what);
+
+  bool buttonpage = pageNum == PAGE_HOME || pageNum == PAGE_SETTINGS || isMenuPage(pageNum);
+  if (buttonpage && (what == RELOAD_GENERAL || what == pageNum))
+  {
+    tft.fillScreen(generalconfig.backgroundColour);
+    routerGo(pageNum);
+  }
+}
 
 /**
 * @brief This function allows for saving (updating) the WiFi SSID
@@ -225,6 +616,7 @@ bool saveWifiSSID(String ssid)
   wificonfigobject["wifihostname"] = wificonfig.hostname;
   wificonfigobject["attempts"] = wificonfig.attempts;
   wificonfigobject["attemptdelay"] = wificonfig.attemptdelay;
+  wificonfigobject["keepble"] = wificonfig.keepble;
 
 
   if (serializeJsonPretty(doc, file) == 0)
@@ -262,6 +654,7 @@ bool saveWifiPW(String password)
   wificonfigobject["wifihostname"] = wificonfig.hostname;
   wificonfigobject["attempts"] = wificonfig.attempts;
   wificonfigobject["attemptdelay"] = wificonfig.attemptdelay;
+  wificonfigobject["keepble"] = wificonfig.keepble;
 
 
   if (serializeJsonPretty(doc, file) == 0)
@@ -305,6 +698,7 @@ bool saveWifiMode(String wifimode)
   wificonfigobject["wifihostname"] = wificonfig.hostname;
   wificonfigobject["attempts"] = wificonfig.attempts;
   wificonfigobject["attemptdelay"] = wificonfig.attemptdelay;
+  wificonfigobject["keepble"] = wificonfig.keepble;
 
 
   if (serializeJsonPretty(doc, file) == 0)
@@ -349,13 +743,15 @@ bool checkfile(const char *filename)
 
 bool resetconfig(String file){
 
- if (file != "menu1" && file != "menu2" && file != "menu3" && file != "menu4" && file != "menu5" && file != "homescreen" && file != "general")
+ bool ismenu = file.startsWith("menu") && isMenuPage(file.substring(4).toInt());
+
+ if (!ismenu && file != "homescreen" && file != "general")
   {
-    Serial.println("[WARNING]: Invalid reset option. Choose: menu1, menu2, menu3, menu4, menu5, homescreen, or general");
+    Serial.printf("[WARNING]: Invalid reset option. Choose: menu1 to menu%d, homescreen, or general\n", MENU_MAX);
     return false;
   }
 
- if (file == "menu1" || file == "menu2" || file == "menu3" || file == "menu4" || file == "menu5")
+ if (ismenu)
  {
    // Reset a menu config
   
@@ -382,6 +778,7 @@ bool resetconfig(String file){
         }
         // Close the newly created file
         newfile.close();
+        queueCompile(file.substring(4).toInt());
       }
       Serial.println("[INFO]: Done resetting.");
       Serial.println("[INFO]: Type \"restart\" to reload configuration.");
@@ -441,6 +838,8 @@ bool resetconfig(String file){
     newfile.println("\"background\": \"#000000\",");
     newfile.println("\"sleepenable\": true,");
     newfile.println("\"sleeptimer\": 10,");
+    newfile.println("\"deepsleeptimer\": 60,");
+    newfile.println("\"keyboardlayout\": \"us\",");
     newfile.println("\"beep\": true,");
     newfile.println("\"modifier1\": 130,");
     newfile.println("\"modifier2\": 129,");
@@ -17,7 +17,7 @@ bool loadMainConfig()
   }
   File configfile = FILESYSTEM.open("/config/wificonfig.json");
 
-  DynamicJsonDocument doc(256);
+  DynamicJsonDocument doc(384);
 
   DeserializationError error = deserializeJson(doc, configfile);
 
@@ -32,6 +32,112 @@ bool loadMainConfig()
   uint16_t attemptdelay = doc["attemptdelay"] | 500 ;
   wificonfig.attemptdelay = attemptdelay;
 
+  wificonfig.keepble = doc["keepble"] | false;
+
+  configfile.close();
+
+  if (error)
+  {
+    Serial.println("[ERROR]: deserializeJson() error");
+    Serial.println(error.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+/**
+* @brief This function loads the press mode of a button. A button without a
+*        "pressmode" is a normal tap button.
+*
+* @param button JsonObject the "buttonX" object from a menu config
+* @param target struct Button *
+*
+* @return none
+*
+* @note "holddelay" is the long-press threshold or the delay before the first
+*       repeat. "repeatrate" is the time between repeats. Both are in ms.
+*       A long-press button uses "longactionarray" and "longvaluearray"
+*       (or "longmacro").
+*/
+void loadPressMode(JsonObject button, struct Button *target)
+{
+  target->pressmode = button["pressmode"] | PRESSMODE_TAP;
+  target->holddelay = button["holddelay"] | 500;
+  target->repeatrate = button["repeatrate"] | 100;
+
+  if (target->pressmode > PRESSMODE_REPEAT)
+  {
+    Serial.printf("[WARNING]: Unknown pressmode %u, using tap.\n", target->pressmode);
+    target->pressmode = PRESSMODE_TAP;
+  }
+
+  // Repeating faster than a BLE report round-trip only floods the host
+  if (target->repeatrate < 20)
+  {
+    target->repeatrate = 20;
+  }
+
+  if (target->pressmode == PRESSMODE_LONGPRESS && macroStops(button, true))
+  {
+    target->flags |= BUTTON_LONGSTOPS;
+  }
+}
+
+/**
+* @brief This function loads the logos and buttons of a menu.
+*
+* @param page int the menu (1 to MENU_MAX)
+* @param menu struct Menu * where to load it
+*
+* @return True if the config was loaded. False otherwise.
+*
+* @note Reads /config/menuX.json. Called by getMenu() when the menu is not
+         in the cache. Compiles the macros if /config/menuX.ftm is out of date.
+*/
+bool loadMenuConfig(int page, struct Menu *menu)
+{
+  char filename[24];
+  snprintf(filename, sizeof(filename), "/config/menu%d.json", page);
+  if (!FILESYSTEM.exists(filename))
+  {
+    Serial.printf("[WARNING]: %s not found!\n", filename);
+    return false;
+  }
+  File configfile = FILESYSTEM.open(filename, "r");
+
+  // Macros can make a menu config much longer than the 3 actions per button it used to have
+  DynamicJsonDocument doc(2048 + configfile.size() * 2);
+
+  DeserializationError error = deserializeJson(doc, configfile);
+
+  for (int b = 0; b < BUTTONS_PER_PAGE - 1; b++)
+  {
+    char key[8];
+
+    snprintf(key, sizeof(key), "logo%d", b);
+    const char *logo = doc[key] | "question.bmp";
+    snprintf(menu->logos.logo[b], sizeof(menu->logos.logo[b]), "%s%s", logopath, logo);
+
+    snprintf(key, sizeof(key), "button%d", b);
+    JsonObject buttonconfig = doc[key];
+    struct Button *button = &menu->button[b];
+
+    button->latch = buttonconfig["latch"] | false;
+
+    const char *led = buttonconfig["ledstate"] | "";
+    button->led = !strcmp(led, "num") ? LED_NUM_LOCK : !strcmp(led, "caps") ? LED_CAPS_LOCK : !strcmp(led, "scroll") ? LED_SCROLL_LOCK : 0;
+
+    const char *latchlogo = buttonconfig["latchlogo"] | "question.bmp";
+    snprintf(button->latchlogo, sizeof(button->latchlogo), "%s%s", logopath, latchlogo);
+
+    button->flags = macroStops(buttonconfig, false) ? BUTTON_STOPS : 0;
+    loadPressMode(buttonconfig, button);
+  }
+
+  // Logo 5 is the back home button, it is not part of the menu config
+  strlcpy(menu->logos.logo[5], generallogo.homebutton, sizeof(menu->logos.logo[5]));
+
   configfile.close();
 
   if (error)
@@ -41,6 +147,12 @@ bool loadMainConfig()
     return false;
   }
 
+  uint32_t sourcecrc = macroSourceCrc(filename);
+  if (!macroUpToDate(page, sourcecrc))
+  {
+    macroCompile(doc, page, sourcecrc);
+  }
+
   return true;
 }
 
@@ -51,8 +163,8 @@ bool loadMainConfig()
 *
 * @return none
 *
-* @note Options for values are: colors, homescreen, menu1, menu2, menu3
-         menu4, and menu5
+* @note Options for values are: general and homescreen. The menus are
+         loaded when they are shown, see getMenu().
 */
 bool loadConfig(String value)
 {
@@ -97,7 +209,7 @@ bool loadConfig(String value)
       if (sleepenable)
       {
         generalconfig.sleepenable = true;
-        islatched[28] = 1;
+        setLatched(PAGE_SETTINGS, 3, true);
       }
       else
       {
@@ -107,6 +219,12 @@ bool loadConfig(String value)
       //uint16_t sleeptimer = doc["sleeptimer"];
       uint16_t sleeptimer = doc["sleeptimer"] | 60 ;
       generalconfig.sleeptimer = sleeptimer;
+
+      // Minutes in standby before deep sleep, 0 stays in standby
+      generalconfig.deepsleeptimer = doc["deepsleeptimer"] | 60;
+
+      // Layout of the host keyboard, used to type text
+      strlcpy(generalconfig.keyboardlayout, doc["keyboardlayout"] | "us", sizeof(generalconfig.keyboardlayout));
     
       bool beep = doc["beep"] | false;
       generalconfig.beep = beep;
@@ -141,338 +259,23 @@ bool loadConfig(String value)
 
     DeserializationError error = deserializeJson(doc, configfile);
 
-    const char *logo00 = doc["logo0"] | "question.bmp";
-    const char *logo01 = doc["logo1"] | "question.bmp";
-    const char *logo02 = doc["logo2"] | "question.bmp";
-    const char *logo03 = doc["logo3"] | "question.bmp";
-    const char *logo04 = doc["logo4"] | "question.bmp";
-    const char *logo05 = doc["logo5"] | "question.bmp"; // Only screen 0 has 6 buttons
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo00);
-    strcpy(screen0.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo01);
-    strcpy(screen0.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo02);
-    strcpy(screen0.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo03);
-    strcpy(screen0.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo04);
-    strcpy(screen0.logo4, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo05);
-    strcpy(screen0.logo5, templogopath);
-
-    configfile.close();
-
-    if (error)
-    {
-      Serial.println("[ERROR]: deserializeJson() error");
-      Serial.println(error.c_str());
-      return false;
-    }
-    return true;
-
-    // --------------------- Loading menu 1 ----------------------
-  }
-  else if (value == "menu1")
-  {
-    File configfile = FILESYSTEM.open("/config/menu1.json", "r");
-
-    DynamicJsonDocument doc(1500);
-
-    DeserializationError error = deserializeJson(doc, configfile);
-
-    const char *logo10 = doc["logo0"] | "question.bmp";
-    const char *logo11 = doc["logo1"] | "question.bmp";
-    const char *logo12 = doc["logo2"] | "question.bmp";
-    const char *logo13 = doc["logo3"] | "question.bmp";
-    const char *logo14 = doc["logo4"] | "question.bmp";
-
-    const char *latchlogo10 = doc["button0"]["latchlogo"] | "question.bmp";
-    const char *latchlogo11 = doc["button1"]["latchlogo"] | "question.bmp";
-    const char *latchlogo12 = doc["button2"]["latchlogo"] | "question.bmp";
-    const char *latchlogo13 = doc["button3"]["latchlogo"] | "question.bmp";
-    const char *latchlogo14 = doc["button4"]["latchlogo"] | "question.bmp";
-
-    menu1.button0.latch = doc["button0"]["latch"] | false;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo10);
-    strcpy(menu1.button0.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo11);
-    strcpy(menu1.button1.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo12);
-    strcpy(menu1.button2.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo13);
-    strcpy(menu1.button3.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo14);
-    strcpy(menu1.button4.latchlogo, templogopath);
-
-    JsonArray button0_actionarray = doc["button0"]["actionarray"];
-
-    int button0_actionarray_0 = button0_actionarray[0];
-    int button0_actionarray_1 = button0_actionarray[1];
-    int button0_actionarray_2 = button0_actionarray[2];
-
-    JsonArray button0_valuearray = doc["button0"]["valuearray"];
-
-    if (button0_actionarray_0 == 4 || button0_actionarray_0 == 8)
-    {
-      const char *button0_symbolarray_0 = button0_valuearray[0];
-      strcpy(menu1.button0.actions.symbol0, button0_symbolarray_0);
-    }
-    else
-    {
-      int button0_valuearray_0 = button0_valuearray[0];
-      menu1.button0.actions.value0 = button0_valuearray_0;
-    }
-
-    if (button0_actionarray_1 == 4 || button0_actionarray_1 == 8)
-    {
-      const char *button0_symbolarray_1 = button0_valuearray[1];
-      strcpy(menu1.button0.actions.symbol1, button0_symbolarray_1);
-    }
-    else
-    {
-      int button0_valuearray_1 = button0_valuearray[1];
-      menu1.button0.actions.value1 = button0_valuearray_1;
-    }
-
-    if (button0_actionarray_2 == 4 || button0_actionarray_2 == 8)
-    {
-      const char *button0_symbolarray_2 = button0_valuearray[2];
-      strcpy(menu1.button0.actions.symbol2, button0_symbolarray_2);
-    }
-    else
-    {
-      int button0_valuearray_2 = button0_valuearray[2];
-      menu1.button0.actions.value2 = button0_valuearray_2;
-    }
-
-    menu1.button0.actions.action0 = button0_actionarray_0;
-    menu1.button0.actions.action1 = button0_actionarray_1;
-    menu1.button0.actions.action2 = button0_actionarray_2;
-
-    menu1.button1.latch = doc["button1"]["latch"] | false;
-
-    JsonArray button1_actionarray = doc["button1"]["actionarray"];
-    int button1_actionarray_0 = button1_actionarray[0];
-    int button1_actionarray_1 = button1_actionarray[1];
-    int button1_actionarray_2 = button1_actionarray[2];
-
-    JsonArray button1_valuearray = doc["button1"]["valuearray"];
-
-    if (button1_actionarray_0 == 4 || button1_actionarray_0 == 8)
-    {
-      const char *button1_symbolarray_0 = button1_valuearray[0];
-      strcpy(menu1.button1.actions.symbol0, button1_symbolarray_0);
-    }
-    else
-    {
-      int button1_valuearray_0 = button1_valuearray[0];
-      menu1.button1.actions.value0 = button1_valuearray_0;
-    }
-
-    if (button1_actionarray_1 == 4 || button1_actionarray_1 == 8)
-    {
-      const char *button1_symbolarray_1 = button1_valuearray[1];
-      strcpy(menu1.button1.actions.symbol1, button1_symbolarray_1);
-    }
-    else
-    {
-      int button1_valuearray_1 = button1_valuearray[1];
-      menu1.button1.actions.value1 = button1_valuearray_1;
-    }
-
-    if (button1_actionarray_2 == 4 || button1_actionarray_2 == 8)
-    {
-      const char *button1_symbolarray_2 = button1_valuearray[2];
-      strcpy(menu1.button1.actions.symbol2, button1_symbolarray_2);
-    }
-    else
-    {
-      int button1_valuearray_2 = button1_valuearray[2];
-      menu1.button1.actions.value2 = button1_valuearray_2;
-    }
-
-    menu1.button1.actions.action0 = button1_actionarray_0;
-    menu1.button1.actions.action1 = button1_actionarray_1;
-    menu1.button1.actions.action2 = button1_actionarray_2;
-
-    menu1.button2.latch = doc["button2"]["latch"] | false;
-
-    JsonArray button2_actionarray = doc["button2"]["actionarray"];
-    int button2_actionarray_0 = button2_actionarray[0];
-    int button2_actionarray_1 = button2_actionarray[1];
-    int button2_actionarray_2 = button2_actionarray[2];
-
-    JsonArray button2_valuearray = doc["button2"]["valuearray"];
-
-    if (button2_actionarray_0 == 4 || button2_actionarray_0 == 8)
-    {
-      const char *button2_symbolarray_0 = button2_valuearray[0];
-      strcpy(menu1.button2.actions.symbol0, button2_symbolarray_0);
-    }
-    else
-    {
-      int button2_valuearray_0 = button2_valuearray[0];
-      menu1.button2.actions.value0 = button2_valuearray_0;
-    }
-
-    if (button2_actionarray_1 == 4 || button2_actionarray_1 == 8)
-    {
-      const char *button2_symbolarray_1 = button2_valuearray[1];
-      strcpy(menu1.button2.actions.symbol1, button2_symbolarray_1);
-    }
-    else
-    {
-      int button2_valuearray_1 = button2_valuearray[1];
-      menu1.button2.actions.value1 = button2_valuearray_1;
-    }
-
-    if (button2_actionarray_2 == 4 || button2_actionarray_2 == 8)
-    {
-      const char *button2_symbolarray_2 = button2_valuearray[2];
-      strcpy(menu1.button2.actions.symbol2, button2_symbolarray_2);
-    }
-    else
-    {
-      int button2_valuearray_2 = button2_valuearray[2];
-      menu1.button2.actions.value2 = button2_valuearray_2;
-    }
-
-    menu1.button2.actions.action0 = button2_actionarray_0;
-    menu1.button2.actions.action1 = button2_actionarray_1;
-    menu1.button2.actions.action2 = button2_actionarray_2;
-
-    menu1.button3.latch = doc["button3"]["latch"] | false;
-
-    JsonArray button3_actionarray = doc["button3"]["actionarray"];
-    int button3_actionarray_0 = button3_actionarray[0]; // 3
-    int button3_actionarray_1 = button3_actionarray[1]; // 0
-    int button3_actionarray_2 = button3_actionarray[2]; // 0
-
-    JsonArray button3_valuearray = doc["button3"]["valuearray"];
-
-    if (button3_actionarray_0 == 4 || button3_actionarray_0 == 8)
-    {
-      const char *button3_symbolarray_0 = button3_valuearray[0];
-      strcpy(menu1.button3.actions.symbol0, button3_symbolarray_0);
-    }
-    else
-    {
-      int button3_valuearray_0 = button3_valuearray[0]; // 1
-      menu1.button3.actions.value0 = button3_valuearray_0;
-    }
-
-    if (button3_actionarray_1 == 4 || button3_actionarray_1 == 8)
-    {
-      const char *button3_symbolarray_1 = button3_valuearray[1]; // 1
-      strcpy(menu1.button3.actions.symbol1, button3_symbolarray_1);
-    }
-    else
-    {
-      int button3_valuearray_1 = button3_valuearray[1]; // 1
-      menu1.button3.actions.value1 = button3_valuearray_1;
-    }
-
-    if (button3_actionarray_2 == 4 || button3_actionarray_2 == 8)
+    // Only screen 0 has 6 configurable logos
+    for (int b = 0; b < BUTTONS_PER_PAGE; b++)
     {
-      const char *button3_symbolarray_2 = button3_valuearray[2]; // 1
-      strcpy(menu1.button3.actions.symbol2, button3_symbolarray_2);
-    }
-    else
-    {
-      int button3_valuearray_2 = button3_valuearray[2]; // 1
-      menu1.button3.actions.value2 = button3_valuearray_2;
-    }
-
-    menu1.button3.actions.action0 = button3_actionarray_0;
-    menu1.button3.actions.action1 = button3_actionarray_1;
-    menu1.button3.actions.action2 = button3_actionarray_2;
-
-    menu1.button4.latch = doc["button4"]["latch"] | false;
-
-    JsonArray button4_actionarray = doc["button4"]["actionarray"];
-    int button4_actionarray_0 = button4_actionarray[0]; // 3
-    int button4_actionarray_1 = button4_actionarray[1]; // 0
-    int button4_actionarray_2 = button4_actionarray[2]; // 0
-
-    JsonArray button4_valuearray = doc["button4"]["valuearray"];
-
-    if (button4_actionarray_0 == 4 || button4_actionarray_0 == 8)
-    {
-      const char *button4_symbolarray_0 = button4_valuearray[0]; // 1
-      strcpy(menu1.button4.actions.symbol0, button4_symbolarray_0);
-    }
-    else
-    {
-      int button4_valuearray_0 = button4_valuearray[0]; // 1
-      menu1.button4.actions.value0 = button4_valuearray_0;
-    }
-
-    if (button4_actionarray_1 == 4 || button4_actionarray_1 == 8)
-    {
-      const char *button4_symbolarray_1 = button4_valuearray[1]; // 1
-      strcpy(menu1.button4.actions.symbol1, button4_symbolarray_1);
-    }
-    else
-    {
-      int button4_valuearray_1 = button4_valuearray[1]; // 1
-      menu1.button4.actions.value1 = button4_valuearray_1;
+      char logokey[8];
+      snprintf(logokey, sizeof(logokey), "logo%d", b);
+      const char *logo = doc[logokey] | "question.bmp";
+      snprintf(homescreen.logo[b], sizeof(homescreen.logo[b]), "%s%s", logopath, logo);
     }
 
-    if (button4_actionarray_2 == 4 || button4_actionarray_2 == 8)
+    // Buttons 0-4 open menu 1-5, unless "pageX" links them to another menu
+    for (int b = 0; b < BUTTONS_PER_PAGE - 1; b++)
     {
-      const char *button4_symbolarray_2 = button4_valuearray[2]; // 1
-      strcpy(menu1.button4.actions.symbol2, button4_symbolarray_2);
+      char pagekey[8];
+      snprintf(pagekey, sizeof(pagekey), "page%d", b);
+      int link = doc[pagekey] | (b + 1);
+      homelinks[b] = isMenuPage(link) ? link : b + 1;
     }
-    else
-    {
-      int button4_valuearray_2 = button4_valuearray[2]; // 1
-      menu1.button4.actions.value2 = button4_valuearray_2;
-    }
-    menu1.button4.actions.action0 = button4_actionarray_0;
-    menu1.button4.actions.action1 = button4_actionarray_1;
-    menu1.button4.actions.action2 = button4_actionarray_2;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo10);
-    strcpy(screen1.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo11);
-    strcpy(screen1.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo12);
-    strcpy(screen1.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo13);
-    strcpy(screen1.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo14);
-    strcpy(screen1.logo4, templogopath);
 
     configfile.close();
 
@@ -484,1212 +287,6 @@ bool loadConfig(String value)
     }
     return true;
 
-    // --------------------- Loading menu 2 ----------------------
-  }
-  else if (value == "menu2")
-  {
-    File configfile = FILESYSTEM.open("/config/menu2.json", "r");
-
-    DynamicJsonDocument doc(1500);
-
-    DeserializationError error = deserializeJson(doc, configfile);
-
-    const char *logo20 = doc["logo0"] | "question.bmp";
-    const char *logo21 = doc["logo1"] | "question.bmp";
-    const char *logo22 = doc["logo2"] | "question.bmp";
-    const char *logo23 = doc["logo3"] | "question.bmp";
-    const char *logo24 = doc["logo4"] | "question.bmp";
-
-    const char *latchlogo20 = doc["button0"]["latchlogo"] | "question.bmp";
-    const char *latchlogo21 = doc["button1"]["latchlogo"] | "question.bmp";
-    const char *latchlogo22 = doc["button2"]["latchlogo"] | "question.bmp";
-    const char *latchlogo23 = doc["button3"]["latchlogo"] | "question.bmp";
-    const char *latchlogo24 = doc["button4"]["latchlogo"] | "question.bmp";
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo20);
-    strcpy(menu2.button0.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo21);
-    strcpy(menu2.button1.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo22);
-    strcpy(menu2.button2.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo23);
-    strcpy(menu2.button3.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo24);
-    strcpy(menu2.button4.latchlogo, templogopath);
-
-    menu2.button0.latch = doc["button0"]["latch"] | false;
-
-    JsonArray button0_actionarray = doc["button0"]["actionarray"];
-
-    int button0_actionarray_0 = button0_actionarray[0];
-    int button0_actionarray_1 = button0_actionarray[1];
-    int button0_actionarray_2 = button0_actionarray[2];
-
-    JsonArray button0_valuearray = doc["button0"]["valuearray"];
-
-    if (button0_actionarray_0 == 4 || button0_actionarray_0 == 8)
-    {
-      const char *button0_symbolarray_0 = button0_valuearray[0];
-      strcpy(menu2.button0.actions.symbol0, button0_symbolarray_0);
-    }
-    else
-    {
-      int button0_valuearray_0 = button0_valuearray[0];
-      menu2.button0.actions.value0 = button0_valuearray_0;
-    }
-
-    if (button0_actionarray_1 == 4 || button0_actionarray_1 == 8)
-    {
-      const char *button0_symbolarray_1 = button0_valuearray[1];
-      strcpy(menu2.button0.actions.symbol1, button0_symbolarray_1);
-    }
-    else
-    {
-      int button0_valuearray_1 = button0_valuearray[1];
-      menu2.button0.actions.value1 = button0_valuearray_1;
-    }
-
-    if (button0_actionarray_2 == 4 || button0_actionarray_2 == 8)
-    {
-      const char *button0_symbolarray_2 = button0_valuearray[2];
-      strcpy(menu2.button0.actions.symbol2, button0_symbolarray_2);
-    }
-    else
-    {
-      int button0_valuearray_2 = button0_valuearray[2];
-      menu2.button0.actions.value2 = button0_valuearray_2;
-    }
-
-    menu2.button0.actions.action0 = button0_actionarray_0;
-    menu2.button0.actions.action1 = button0_actionarray_1;
-    menu2.button0.actions.action2 = button0_actionarray_2;
-
-    menu2.button1.latch = doc["button1"]["latch"] | false;
-
-    JsonArray button1_actionarray = doc["button1"]["actionarray"];
-    int button1_actionarray_0 = button1_actionarray[0];
-    int button1_actionarray_1 = button1_actionarray[1];
-    int button1_actionarray_2 = button1_actionarray[2];
-
-    JsonArray button1_valuearray = doc["button1"]["valuearray"];
-
-    if (button1_actionarray_0 == 4 || button1_actionarray_0 == 8)
-    {
-      const char *button1_symbolarray_0 = button1_valuearray[0];
-      strcpy(menu2.button1.actions.symbol0, button1_symbolarray_0);
-    }
-    else
-    {
-      int button1_valuearray_0 = button1_valuearray[0];
-      menu2.button1.actions.value0 = button1_valuearray_0;
-    }
-
-    if (button1_actionarray_1 == 4 || button1_actionarray_1 == 8)
-    {
-      const char *button1_symbolarray_1 = button1_valuearray[1];
-      strcpy(menu2.button1.actions.symbol1, button1_symbolarray_1);
-    }
-    else
-    {
-      int button1_valuearray_1 = button1_valuearray[1];
-      menu2.button1.actions.value1 = button1_valuearray_1;
-    }
-
-    if (button1_actionarray_2 == 4 || button1_actionarray_2 == 8)
-    {
-      const char *button1_symbolarray_2 = button1_valuearray[2];
-      strcpy(menu2.button1.actions.symbol2, button1_symbolarray_2);
-    }
-    else
-    {
-      int button1_valuearray_2 = button1_valuearray[2];
-      menu2.button1.actions.value2 = button1_valuearray_2;
-    }
-
-    menu2.button1.actions.action0 = button1_actionarray_0;
-    menu2.button1.actions.action1 = button1_actionarray_1;
-    menu2.button1.actions.action2 = button1_actionarray_2;
-
-    menu2.button2.latch = doc["button2"]["latch"] | false;
-
-    JsonArray button2_actionarray = doc["button2"]["actionarray"];
-    int button2_actionarray_0 = button2_actionarray[0];
-    int button2_actionarray_1 = button2_actionarray[1];
-    int button2_actionarray_2 = button2_actionarray[2];
-
-    JsonArray button2_valuearray = doc["button2"]["valuearray"];
-
-    if (button2_actionarray_0 == 4 || button2_actionarray_0 == 8)
-    {
-      const char *button2_symbolarray_0 = button2_valuearray[0];
-      strcpy(menu2.button2.actions.symbol0, button2_symbolarray_0);
-    }
-    else
-    {
-      int button2_valuearray_0 = button2_valuearray[0];
-      menu2.button2.actions.value0 = button2_valuearray_0;
-    }
-
-    if (button2_actionarray_1 == 4 || button2_actionarray_1 == 8)
-    {
-      const char *button2_symbolarray_1 = button2_valuearray[1];
-      strcpy(menu2.button2.actions.symbol1, button2_symbolarray_1);
-    }
-    else
-    {
-      int button2_valuearray_1 = button2_valuearray[1];
-      menu2.button2.actions.value1 = button2_valuearray_1;
-    }
-
-    if (button2_actionarray_2 == 4 || button2_actionarray_2 == 8)
-    {
-      const char *button2_symbolarray_2 = button2_valuearray[2];
-      strcpy(menu2.button2.actions.symbol2, button2_symbolarray_2);
-    }
-    else
-    {
-      int button2_valuearray_2 = button2_valuearray[2];
-      menu2.button2.actions.value2 = button2_valuearray_2;
-    }
-
-    menu2.button2.actions.action0 = button2_actionarray_0;
-    menu2.button2.actions.action1 = button2_actionarray_1;
-    menu2.button2.actions.action2 = button2_actionarray_2;
-
-    menu2.button3.latch = doc["button3"]["latch"] | false;
-
-    JsonArray button3_actionarray = doc["button3"]["actionarray"];
-    int button3_actionarray_0 = button3_actionarray[0]; // 3
-    int button3_actionarray_1 = button3_actionarray[1]; // 0
-    int button3_actionarray_2 = button3_actionarray[2]; // 0
-
-    JsonArray button3_valuearray = doc["button3"]["valuearray"];
-
-    if (button3_actionarray_0 == 4 || button3_actionarray_0 == 8)
-    {
-      const char *button3_symbolarray_0 = button3_valuearray[0];
-      strcpy(menu2.button3.actions.symbol0, button3_symbolarray_0);
-    }
-    else
-    {
-      int button3_valuearray_0 = button3_valuearray[0]; // 1
-      menu2.button3.actions.value0 = button3_valuearray_0;
-    }
-
-    if (button3_actionarray_1 == 4 || button3_actionarray_1 == 8)
-    {
-      const char *button3_symbolarray_1 = button3_valuearray[1]; // 1
-      strcpy(menu2.button3.actions.symbol1, button3_symbolarray_1);
-    }
-    else
-    {
-      int button3_valuearray_1 = button3_valuearray[1]; // 1
-      menu2.button3.actions.value1 = button3_valuearray_1;
-    }
-
-    if (button3_actionarray_2 == 4 || button3_actionarray_2 == 8)
-    {
-      const char *button3_symbolarray_2 = button3_valuearray[2]; // 1
-      strcpy(menu2.button3.actions.symbol2, button3_symbolarray_2);
-    }
-    else
-    {
-      int button3_valuearray_2 = button3_valuearray[2]; // 1
-      menu2.button3.actions.value2 = button3_valuearray_2;
-    }
-
-    menu2.button3.actions.action0 = button3_actionarray_0;
-    menu2.button3.actions.action1 = button3_actionarray_1;
-    menu2.button3.actions.action2 = button3_actionarray_2;
-
-    menu2.button4.latch = doc["button4"]["latch"] | false;
-
-    JsonArray button4_actionarray = doc["button4"]["actionarray"];
-    int button4_actionarray_0 = button4_actionarray[0]; // 3
-    int button4_actionarray_1 = button4_actionarray[1]; // 0
-    int button4_actionarray_2 = button4_actionarray[2]; // 0
-
-    JsonArray button4_valuearray = doc["button4"]["valuearray"];
-
-    if (button4_actionarray_0 == 4 || button4_actionarray_0 == 8)
-    {
-      const char *button4_symbolarray_0 = button4_valuearray[0]; // 1
-      strcpy(menu2.button4.actions.symbol0, button4_symbolarray_0);
-    }
-    else
-    {
-      int button4_valuearray_0 = button4_valuearray[0]; // 1
-      menu2.button4.actions.value0 = button4_valuearray_0;
-    }
-
-    if (button4_actionarray_1 == 4 || button4_actionarray_1 == 8)
-    {
-      const char *button4_symbolarray_1 = button4_valuearray[1]; // 1
-      strcpy(menu2.button4.actions.symbol1, button4_symbolarray_1);
-    }
-    else
-    {
-      int button4_valuearray_1 = button4_valuearray[1]; // 1
-      menu2.button4.actions.value1 = button4_valuearray_1;
-    }
-
-    if (button4_actionarray_2 == 4 || button4_actionarray_2 == 8)
-    {
-      const char *button4_symbolarray_2 = button4_valuearray[2]; // 1
-      strcpy(menu2.button4.actions.symbol2, button4_symbolarray_2);
-    }
-    else
-    {
-      int button4_valuearray_2 = button4_valuearray[2]; // 1
-      menu2.button4.actions.value2 = button4_valuearray_2;
-    }
-    menu2.button4.actions.action0 = button4_actionarray_0;
-    menu2.button4.actions.action1 = button4_actionarray_1;
-    menu2.button4.actions.action2 = button4_actionarray_2;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo20);
-    strcpy(screen2.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo21);
-    strcpy(screen2.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo22);
-    strcpy(screen2.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo23);
-    strcpy(screen2.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo24);
-    strcpy(screen2.logo4, templogopath);
-
-    configfile.close();
-
-    if (error)
-    {
-      Serial.println("[ERROR]: deserializeJson() error");
-      Serial.println(error.c_str());
-      return false;
-    }
-    return true;
-
-    // --------------------- Loading menu 3 ----------------------
-  }
-  else if (value == "menu3")
-  {
-    File configfile = FILESYSTEM.open("/config/menu3.json", "r");
-
-    DynamicJsonDocument doc(1500);
-
-    DeserializationError error = deserializeJson(doc, configfile);
-
-    const char *logo30 = doc["logo0"] | "question.bmp";
-    const char *logo31 = doc["logo1"] | "question.bmp";
-    const char *logo32 = doc["logo2"] | "question.bmp";
-    const char *logo33 = doc["logo3"] | "question.bmp";
-    const char *logo34 = doc["logo4"] | "question.bmp";
-
-    const char *latchlogo30 = doc["button0"]["latchlogo"] | "question.bmp";
-    const char *latchlogo31 = doc["button1"]["latchlogo"] | "question.bmp";
-    const char *latchlogo32 = doc["button2"]["latchlogo"] | "question.bmp";
-    const char *latchlogo33 = doc["button3"]["latchlogo"] | "question.bmp";
-    const char *latchlogo34 = doc["button4"]["latchlogo"] | "question.bmp";
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo30);
-    strcpy(menu3.button0.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo31);
-    strcpy(menu3.button1.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo32);
-    strcpy(menu3.button2.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo33);
-    strcpy(menu3.button3.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo34);
-    strcpy(menu3.button4.latchlogo, templogopath);
-
-    menu3.button0.latch = doc["button0"]["latch"] | false;
-
-    JsonArray button0_actionarray = doc["button0"]["actionarray"];
-
-    int button0_actionarray_0 = button0_actionarray[0];
-    int button0_actionarray_1 = button0_actionarray[1];
-    int button0_actionarray_2 = button0_actionarray[2];
-
-    JsonArray button0_valuearray = doc["button0"]["valuearray"];
-
-    if (button0_actionarray_0 == 4 || button0_actionarray_0 == 8)
-    {
-      const char *button0_symbolarray_0 = button0_valuearray[0];
-      strcpy(menu3.button0.actions.symbol0, button0_symbolarray_0);
-    }
-    else
-    {
-      int button0_valuearray_0 = button0_valuearray[0];
-      menu3.button0.actions.value0 = button0_valuearray_0;
-    }
-
-    if (button0_actionarray_1 == 4 || button0_actionarray_1 == 8)
-    {
-      const char *button0_symbolarray_1 = button0_valuearray[1];
-      strcpy(menu3.button0.actions.symbol1, button0_symbolarray_1);
-    }
-    else
-    {
-      int button0_valuearray_1 = button0_valuearray[1];
-      menu3.button0.actions.value1 = button0_valuearray_1;
-    }
-
-    if (button0_actionarray_2 == 4 || button0_actionarray_2 == 8)
-    {
-      const char *button0_symbolarray_2 = button0_valuearray[2];
-      strcpy(menu3.button0.actions.symbol2, button0_symbolarray_2);
-    }
-    else
-    {
-      int button0_valuearray_2 = button0_valuearray[2];
-      menu3.button0.actions.value2 = button0_valuearray_2;
-    }
-
-    menu3.button0.actions.action0 = button0_actionarray_0;
-    menu3.button0.actions.action1 = button0_actionarray_1;
-    menu3.button0.actions.action2 = button0_actionarray_2;
-
-    menu3.button1.latch = doc["button1"]["latch"] | false;
-
-    JsonArray button1_actionarray = doc["button1"]["actionarray"];
-    int button1_actionarray_0 = button1_actionarray[0];
-    int button1_actionarray_1 = button1_actionarray[1];
-    int button1_actionarray_2 = button1_actionarray[2];
-
-    JsonArray button1_valuearray = doc["button1"]["valuearray"];
-
-    if (button1_actionarray_0 == 4 || button1_actionarray_0 == 8)
-    {
-      const char *button1_symbolarray_0 = button1_valuearray[0];
-      strcpy(menu3.button1.actions.symbol0, button1_symbolarray_0);
-    }
-    else
-    {
-      int button1_valuearray_0 = button1_valuearray[0];
-      menu3.button1.actions.value0 = button1_valuearray_0;
-    }
-
-    if (button1_actionarray_1 == 4 || button1_actionarray_1 == 8)
-    {
-      const char *button1_symbolarray_1 = button1_valuearray[1];
-      strcpy(menu3.button1.actions.symbol1, button1_symbolarray_1);
-    }
-    else
-    {
-      int button1_valuearray_1 = button1_valuearray[1];
-      menu3.button1.actions.value1 = button1_valuearray_1;
-    }
-
-    if (button1_actionarray_2 == 4 || button1_actionarray_2 == 8)
-    {
-      const char *button1_symbolarray_2 = button1_valuearray[2];
-      strcpy(menu3.button1.actions.symbol2, button1_symbolarray_2);
-    }
-    else
-    {
-      int button1_valuearray_2 = button1_valuearray[2];
-      menu3.button1.actions.value2 = button1_valuearray_2;
-    }
-
-    menu3.button1.actions.action0 = button1_actionarray_0;
-    menu3.button1.actions.action1 = button1_actionarray_1;
-    menu3.button1.actions.action2 = button1_actionarray_2;
-
-    menu3.button2.latch = doc["button2"]["latch"] | false;
-
-    JsonArray button2_actionarray = doc["button2"]["actionarray"];
-    int button2_actionarray_0 = button2_actionarray[0];
-    int button2_actionarray_1 = button2_actionarray[1];
-    int button2_actionarray_2 = button2_actionarray[2];
-
-    JsonArray button2_valuearray = doc["button2"]["valuearray"];
-
-    if (button2_actionarray_0 == 4 || button2_actionarray_0 == 8)
-    {
-      const char *button2_symbolarray_0 = button2_valuearray[0];
-      strcpy(menu3.button2.actions.symbol0, button2_symbolarray_0);
-    }
-    else
-    {
-      int button2_valuearray_0 = button2_valuearray[0];
-      menu3.button2.actions.value0 = button2_valuearray_0;
-    }
-
-    if (button2_actionarray_1 == 4 || button2_actionarray_1 == 8)
-    {
-      const char *button2_symbolarray_1 = button2_valuearray[1];
-      strcpy(menu3.button2.actions.symbol1, button2_symbolarray_1);
-    }
-    else
-    {
-      int button2_valuearray_1 = button2_valuearray[1];
-      menu3.button2.actions.value1 = button2_valuearray_1;
-    }
-
-    if (button2_actionarray_2 == 4 || button2_actionarray_2 == 8)
-    {
-      const char *button2_symbolarray_2 = button2_valuearray[2];
-      strcpy(menu3.button2.actions.symbol2, button2_symbolarray_2);
-    }
-    else
-    {
-      int button2_valuearray_2 = button2_valuearray[2];
-      menu3.button2.actions.value2 = button2_valuearray_2;
-    }
-
-    menu3.button2.actions.action0 = button2_actionarray_0;
-    menu3.button2.actions.action1 = button2_actionarray_1;
-    menu3.button2.actions.action2 = button2_actionarray_2;
-
-    JsonArray button3_actionarray = doc["button3"]["actionarray"];
-    int button3_actionarray_0 = button3_actionarray[0]; // 3
-    int button3_actionarray_1 = button3_actionarray[1]; // 0
-    int button3_actionarray_2 = button3_actionarray[2]; // 0
-
-    JsonArray button3_valuearray = doc["button3"]["valuearray"];
-
-    if (button3_actionarray_0 == 4 || button3_actionarray_0 == 8)
-    {
-      const char *button3_symbolarray_0 = button3_valuearray[0];
-      strcpy(menu3.button3.actions.symbol0, button3_symbolarray_0);
-    }
-    else
-    {
-      int button3_valuearray_0 = button3_valuearray[0]; // 1
-      menu3.button3.actions.value0 = button3_valuearray_0;
-    }
-
-    if (button3_actionarray_1 == 4 || button3_actionarray_1 == 8)
-    {
-      const char *button3_symbolarray_1 = button3_valuearray[1]; // 1
-      strcpy(menu3.button3.actions.symbol1, button3_symbolarray_1);
-    }
-    else
-    {
-      int button3_valuearray_1 = button3_valuearray[1]; // 1
-      menu3.button3.actions.value1 = button3_valuearray_1;
-    }
-
-    if (button3_actionarray_2 == 4 || button3_actionarray_2 == 8)
-    {
-      const char *button3_symbolarray_2 = button3_valuearray[2]; // 1
-      strcpy(menu3.button3.actions.symbol2, button3_symbolarray_2);
-    }
-    else
-    {
-      int button3_valuearray_2 = button3_valuearray[2]; // 1
-      menu3.button3.actions.value2 = button3_valuearray_2;
-    }
-
-    menu3.button3.actions.action0 = button3_actionarray_0;
-    menu3.button3.actions.action1 = button3_actionarray_1;
-    menu3.button3.actions.action2 = button3_actionarray_2;
-
-    menu3.button4.latch = doc["button4"]["latch"] | false;
-
-    JsonArray button4_actionarray = doc["button4"]["actionarray"];
-    int button4_actionarray_0 = button4_actionarray[0]; // 3
-    int button4_actionarray_1 = button4_actionarray[1]; // 0
-    int button4_actionarray_2 = button4_actionarray[2]; // 0
-
-    JsonArray button4_valuearray = doc["button4"]["valuearray"];
-
-    if (button4_actionarray_0 == 4 || button4_actionarray_0 == 8)
-    {
-      const char *button4_symbolarray_0 = button4_valuearray[0]; // 1
-      strcpy(menu3.button4.actions.symbol0, button4_symbolarray_0);
-    }
-    else
-    {
-      int button4_valuearray_0 = button4_valuearray[0]; // 1
-      menu3.button4.actions.value0 = button4_valuearray_0;
-    }
-
-    if (button4_actionarray_1 == 4 || button4_actionarray_1 == 8)
-    {
-      const char *button4_symbolarray_1 = button4_valuearray[1]; // 1
-      strcpy(menu3.button4.actions.symbol1, button4_symbolarray_1);
-    }
-    else
-    {
-      int button4_valuearray_1 = button4_valuearray[1]; // 1
-      menu3.button4.actions.value1 = button4_valuearray_1;
-    }
-
-    if (button4_actionarray_2 == 4 || button4_actionarray_2 == 8)
-    {
-      const char *button4_symbolarray_2 = button4_valuearray[2]; // 1
-      strcpy(menu3.button4.actions.symbol2, button4_symbolarray_2);
-    }
-    else
-    {
-      int button4_valuearray_2 = button4_valuearray[2]; // 1
-      menu3.button4.actions.value2 = button4_valuearray_2;
-    }
-    menu3.button4.actions.action0 = button4_actionarray_0;
-    menu3.button4.actions.action1 = button4_actionarray_1;
-    menu3.button4.actions.action2 = button4_actionarray_2;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo30);
-    strcpy(screen3.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo31);
-    strcpy(screen3.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo32);
-    strcpy(screen3.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo33);
-    strcpy(screen3.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo34);
-    strcpy(screen3.logo4, templogopath);
-
-    configfile.close();
-
-    if (error)
-    {
-      Serial.println("[ERROR]: deserializeJson() error");
-      Serial.println(error.c_str());
-      return false;
-    }
-    return true;
-
-    // --------------------- Loading menu 4 ----------------------
-  }
-  else if (value == "menu4")
-  {
-    File configfile = FILESYSTEM.open("/config/menu4.json", "r");
-
-    DynamicJsonDocument doc(1500);
-
-    DeserializationError error = deserializeJson(doc, configfile);
-
-    const char *logo40 = doc["logo0"] | "question.bmp";
-    const char *logo41 = doc["logo1"] | "question.bmp";
-    const char *logo42 = doc["logo2"] | "question.bmp";
-    const char *logo43 = doc["logo3"] | "question.bmp";
-    const char *logo44 = doc["logo4"] | "question.bmp";
-
-    const char *latchlogo40 = doc["button0"]["latchlogo"] | "question.bmp";
-    const char *latchlogo41 = doc["button1"]["latchlogo"] | "question.bmp";
-    const char *latchlogo42 = doc["button2"]["latchlogo"] | "question.bmp";
-    const char *latchlogo43 = doc["button3"]["latchlogo"] | "question.bmp";
-    const char *latchlogo44 = doc["button4"]["latchlogo"] | "question.bmp";
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo40);
-    strcpy(menu4.button0.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo41);
-    strcpy(menu4.button1.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo42);
-    strcpy(menu4.button2.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo43);
-    strcpy(menu4.button3.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo44);
-    strcpy(menu4.button4.latchlogo, templogopath);
-
-    menu4.button0.latch = doc["button0"]["latch"] | false;
-
-    JsonArray button0_actionarray = doc["button0"]["actionarray"];
-
-    int button0_actionarray_0 = button0_actionarray[0];
-    int button0_actionarray_1 = button0_actionarray[1];
-    int button0_actionarray_2 = button0_actionarray[2];
-
-    JsonArray button0_valuearray = doc["button0"]["valuearray"];
-
-    if (button0_actionarray_0 == 4 || button0_actionarray_0 == 8)
-    {
-      const char *button0_symbolarray_0 = button0_valuearray[0];
-      strcpy(menu4.button0.actions.symbol0, button0_symbolarray_0);
-    }
-    else
-    {
-      int button0_valuearray_0 = button0_valuearray[0];
-      menu4.button0.actions.value0 = button0_valuearray_0;
-    }
-
-    if (button0_actionarray_1 == 4 || button0_actionarray_1 == 8)
-    {
-      const char *button0_symbolarray_1 = button0_valuearray[1];
-      strcpy(menu4.button0.actions.symbol1, button0_symbolarray_1);
-    }
-    else
-    {
-      int button0_valuearray_1 = button0_valuearray[1];
-      menu4.button0.actions.value1 = button0_valuearray_1;
-    }
-
-    if (button0_actionarray_2 == 4 || button0_actionarray_2 == 8)
-    {
-      const char *button0_symbolarray_2 = button0_valuearray[2];
-      strcpy(menu4.button0.actions.symbol2, button0_symbolarray_2);
-    }
-    else
-    {
-      int button0_valuearray_2 = button0_valuearray[2];
-      menu4.button0.actions.value2 = button0_valuearray_2;
-    }
-
-    menu4.button0.actions.action0 = button0_actionarray_0;
-    menu4.button0.actions.action1 = button0_actionarray_1;
-    menu4.button0.actions.action2 = button0_actionarray_2;
-
-    menu4.button1.latch = doc["button1"]["latch"] | false;
-
-    JsonArray button1_actionarray = doc["button1"]["actionarray"];
-    int button1_actionarray_0 = button1_actionarray[0];
-    int button1_actionarray_1 = button1_actionarray[1];
-    int button1_actionarray_2 = button1_actionarray[2];
-
-    JsonArray button1_valuearray = doc["button1"]["valuearray"];
-
-    if (button1_actionarray_0 == 4 || button1_actionarray_0 == 8)
-    {
-      const char *button1_symbolarray_0 = button1_valuearray[0];
-      strcpy(menu4.button1.actions.symbol0, button1_symbolarray_0);
-    }
-    else
-    {
-      int button1_valuearray_0 = button1_valuearray[0];
-      menu4.button1.actions.value0 = button1_valuearray_0;
-    }
-
-    if (button1_actionarray_1 == 4 || button1_actionarray_1 == 8)
-    {
-      const char *button1_symbolarray_1 = button1_valuearray[1];
-      strcpy(menu4.button1.actions.symbol1, button1_symbolarray_1);
-    }
-    else
-    {
-      int button1_valuearray_1 = button1_valuearray[1];
-      menu4.button1.actions.value1 = button1_valuearray_1;
-    }
-
-    if (button1_actionarray_2 == 4 || button1_actionarray_2 == 8)
-    {
-      const char *button1_symbolarray_2 = button1_valuearray[2];
-      strcpy(menu4.button1.actions.symbol2, button1_symbolarray_2);
-    }
-    else
-    {
-      int button1_valuearray_2 = button1_valuearray[2];
-      menu4.button1.actions.value2 = button1_valuearray_2;
-    }
-
-    menu4.button1.actions.action0 = button1_actionarray_0;
-    menu4.button1.actions.action1 = button1_actionarray_1;
-    menu4.button1.actions.action2 = button1_actionarray_2;
-
-    menu4.button2.latch = doc["button2"]["latch"] | false;
-
-    JsonArray button2_actionarray = doc["button2"]["actionarray"];
-    int button2_actionarray_0 = button2_actionarray[0];
-    int button2_actionarray_1 = button2_actionarray[1];
-    int button2_actionarray_2 = button2_actionarray[2];
-
-    JsonArray button2_valuearray = doc["button2"]["valuearray"];
-
-    if (button2_actionarray_0 == 4 || button2_actionarray_0 == 8)
-    {
-      const char *button2_symbolarray_0 = button2_valuearray[0];
-      strcpy(menu4.button2.actions.symbol0, button2_symbolarray_0);
-    }
-    else
-    {
-      int button2_valuearray_0 = button2_valuearray[0];
-      menu4.button2.actions.value0 = button2_valuearray_0;
-    }
-
-    if (button2_actionarray_1 == 4 || button2_actionarray_1 == 8)
-    {
-      const char *button2_symbolarray_1 = button2_valuearray[1];
-      strcpy(menu4.button2.actions.symbol1, button2_symbolarray_1);
-    }
-    else
-    {
-      int button2_valuearray_1 = button2_valuearray[1];
-      menu4.button2.actions.value1 = button2_valuearray_1;
-    }
-
-    if (button2_actionarray_2 == 4 || button2_actionarray_2 == 8)
-    {
-      const char *button2_symbolarray_2 = button2_valuearray[2];
-      strcpy(menu4.button2.actions.symbol2, button2_symbolarray_2);
-    }
-    else
-    {
-      int button2_valuearray_2 = button2_valuearray[2];
-      menu4.button2.actions.value2 = button2_valuearray_2;
-    }
-
-    menu4.button2.actions.action0 = button2_actionarray_0;
-    menu4.button2.actions.action1 = button2_actionarray_1;
-    menu4.button2.actions.action2 = button2_actionarray_2;
-
-    menu4.button3.latch = doc["button3"]["latch"] | false;
-
-    JsonArray button3_actionarray = doc["button3"]["actionarray"];
-    int button3_actionarray_0 = button3_actionarray[0]; // 3
-    int button3_actionarray_1 = button3_actionarray[1]; // 0
-    int button3_actionarray_2 = button3_actionarray[2]; // 0
-
-    JsonArray button3_valuearray = doc["button3"]["valuearray"];
-
-    if (button3_actionarray_0 == 4 || button3_actionarray_0 == 8)
-    {
-      const char *button3_symbolarray_0 = button3_valuearray[0];
-      strcpy(menu4.button3.actions.symbol0, button3_symbolarray_0);
-    }
-    else
-    {
-      int button3_valuearray_0 = button3_valuearray[0]; // 1
-      menu4.button3.actions.value0 = button3_valuearray_0;
-    }
-
-    if (button3_actionarray_1 == 4 || button3_actionarray_1 == 8)
-    {
-      const char *button3_symbolarray_1 = button3_valuearray[1]; // 1
-      strcpy(menu4.button3.actions.symbol1, button3_symbolarray_1);
-    }
-    else
-    {
-      int button3_valuearray_1 = button3_valuearray[1]; // 1
-      menu4.button3.actions.value1 = button3_valuearray_1;
-    }
-
-    if (button3_actionarray_2 == 4 || button3_actionarray_2 == 8)
-    {
-      const char *button3_symbolarray_2 = button3_valuearray[2]; // 1
-      strcpy(menu4.button3.actions.symbol2, button3_symbolarray_2);
-    }
-    else
-    {
-      int button3_valuearray_2 = button3_valuearray[2]; // 1
-      menu4.button3.actions.value2 = button3_valuearray_2;
-    }
-
-    menu4.button3.actions.action0 = button3_actionarray_0;
-    menu4.button3.actions.action1 = button3_actionarray_1;
-    menu4.button3.actions.action2 = button3_actionarray_2;
-
-    menu4.button4.latch = doc["button4"]["latch"] | false;
-
-    JsonArray button4_actionarray = doc["button4"]["actionarray"];
-    int button4_actionarray_0 = button4_actionarray[0]; // 3
-    int button4_actionarray_1 = button4_actionarray[1]; // 0
-    int button4_actionarray_2 = button4_actionarray[2]; // 0
-
-    JsonArray button4_valuearray = doc["button4"]["valuearray"];
-
-    if (button4_actionarray_0 == 4 || button4_actionarray_0 == 8)
-    {
-      const char *button4_symbolarray_0 = button4_valuearray[0]; // 1
-      strcpy(menu4.button4.actions.symbol0, button4_symbolarray_0);
-    }
-    else
-    {
-      int button4_valuearray_0 = button4_valuearray[0]; // 1
-      menu4.button4.actions.value0 = button4_valuearray_0;
-    }
-
-    if (button4_actionarray_1 == 4 || button4_actionarray_1 == 8)
-    {
-      const char *button4_symbolarray_1 = button4_valuearray[1]; // 1
-      strcpy(menu4.button4.actions.symbol1, button4_symbolarray_1);
-    }
-    else
-    {
-      int button4_valuearray_1 = button4_valuearray[1]; // 1
-      menu4.button4.actions.value1 = button4_valuearray_1;
-    }
-
-    if (button4_actionarray_2 == 4 || button4_actionarray_2 == 8)
-    {
-      const char *button4_symbolarray_2 = button4_valuearray[2]; // 1
-      strcpy(menu4.button4.actions.symbol2, button4_symbolarray_2);
-    }
-    else
-    {
-      int button4_valuearray_2 = button4_valuearray[2]; // 1
-      menu4.button4.actions.value2 = button4_valuearray_2;
-    }
-    menu4.button4.actions.action0 = button4_actionarray_0;
-    menu4.button4.actions.action1 = button4_actionarray_1;
-    menu4.button4.actions.action2 = button4_actionarray_2;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo40);
-    strcpy(screen4.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo41);
-    strcpy(screen4.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo42);
-    strcpy(screen4.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo43);
-    strcpy(screen4.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo44);
-    strcpy(screen4.logo4, templogopath);
-
-    configfile.close();
-
-    if (error)
-    {
-      Serial.println("[ERROR]: deserializeJson() error");
-      Serial.println(error.c_str());
-      return false;
-    }
-    return true;
-
-    // --------------------- Loading menu 5 ----------------------
-  }
-  else if (value == "menu5")
-  {
-    File configfile = FILESYSTEM.open("/config/menu5.json", "r");
-
-    DynamicJsonDocument doc(1500);
-
-    DeserializationError error = deserializeJson(doc, configfile);
-
-    const char *logo50 = doc["logo0"] | "question.bmp";
-    const char *logo51 = doc["logo1"] | "question.bmp";
-    const char *logo52 = doc["logo2"] | "question.bmp";
-    const char *logo53 = doc["logo3"] | "question.bmp";
-    const char *logo54 = doc["logo4"] | "question.bmp";
-
-    const char *latchlogo50 = doc["button0"]["latchlogo"] | "question.bmp";
-    const char *latchlogo51 = doc["button1"]["latchlogo"] | "question.bmp";
-    const char *latchlogo52 = doc["button2"]["latchlogo"] | "question.bmp";
-    const char *latchlogo53 = doc["button3"]["latchlogo"] | "question.bmp";
-    const char *latchlogo54 = doc["button4"]["latchlogo"] | "question.bmp";
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo50);
-    strcpy(menu5.button0.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo51);
-    strcpy(menu5.button1.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo52);
-    strcpy(menu5.button2.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo53);
-    strcpy(menu5.button3.latchlogo, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, latchlogo54);
-    strcpy(menu5.button4.latchlogo, templogopath);
-
-    menu5.button0.latch = doc["button0"]["latch"] | false;
-
-    JsonArray button0_actionarray = doc["button0"]["actionarray"];
-
-    int button0_actionarray_0 = button0_actionarray[0];
-    int button0_actionarray_1 = button0_actionarray[1];
-    int button0_actionarray_2 = button0_actionarray[2];
-
-    JsonArray button0_valuearray = doc["button0"]["valuearray"];
-
-    if (button0_actionarray_0 == 4 || button0_actionarray_0 == 8)
-    {
-      const char *button0_symbolarray_0 = button0_valuearray[0];
-      strcpy(menu5.button0.actions.symbol0, button0_symbolarray_0);
-    }
-    else
-    {
-      int button0_valuearray_0 = button0_valuearray[0];
-      menu5.button0.actions.value0 = button0_valuearray_0;
-    }
-
-    if (button0_actionarray_1 == 4 || button0_actionarray_1 == 8)
-    {
-      const char *button0_symbolarray_1 = button0_valuearray[1];
-      strcpy(menu5.button0.actions.symbol1, button0_symbolarray_1);
-    }
-    else
-    {
-      int button0_valuearray_1 = button0_valuearray[1];
-      menu5.button0.actions.value1 = button0_valuearray_1;
-    }
-
-    if (button0_actionarray_2 == 4 || button0_actionarray_2 == 8)
-    {
-      const char *button0_symbolarray_2 = button0_valuearray[2];
-      strcpy(menu5.button0.actions.symbol2, button0_symbolarray_2);
-    }
-    else
-    {
-      int button0_valuearray_2 = button0_valuearray[2];
-      menu5.button0.actions.value2 = button0_valuearray_2;
-    }
-
-    menu5.button0.actions.action0 = button0_actionarray_0;
-    menu5.button0.actions.action1 = button0_actionarray_1;
-    menu5.button0.actions.action2 = button0_actionarray_2;
-
-    menu5.button1.latch = doc["button1"]["latch"] | false;
-
-    JsonArray button1_actionarray = doc["button1"]["actionarray"];
-    int button1_actionarray_0 = button1_actionarray[0];
-    int button1_actionarray_1 = button1_actionarray[1];
-    int button1_actionarray_2 = button1_actionarray[2];
-
-    JsonArray button1_valuearray = doc["button1"]["valuearray"];
-
-    if (button1_actionarray_0 == 4 || button1_actionarray_0 == 8)
-    {
-      const char *button1_symbolarray_0 = button1_valuearray[0];
-      strcpy(menu5.button1.actions.symbol0, button1_symbolarray_0);
-    }
-    else
-    {
-      int button1_valuearray_0 = button1_valuearray[0];
-      menu5.button1.actions.value0 = button1_valuearray_0;
-    }
-
-    if (button1_actionarray_1 == 4 || button1_actionarray_1 == 8)
-    {
-      const char *button1_symbolarray_1 = button1_valuearray[1];
-      strcpy(menu5.button1.actions.symbol1, button1_symbolarray_1);
-    }
-    else
-    {
-      int button1_valuearray_1 = button1_valuearray[1];
-      menu5.button1.actions.value1 = button1_valuearray_1;
-    }
-
-    if (button1_actionarray_2 == 4 || button1_actionarray_2 == 8)
-    {
-      const char *button1_symbolarray_2 = button1_valuearray[2];
-      strcpy(menu5.button1.actions.symbol2, button1_symbolarray_2);
-    }
-    else
-    {
-      int button1_valuearray_2 = button1_valuearray[2];
-      menu5.button1.actions.value2 = button1_valuearray_2;
-    }
-
-    menu5.button1.actions.action0 = button1_actionarray_0;
-    menu5.button1.actions.action1 = button1_actionarray_1;
-    menu5.button1.actions.action2 = button1_actionarray_2;
-
-    menu5.button2.latch = doc["button2"]["latch"] | false;
-
-    JsonArray button2_actionarray = doc["button2"]["actionarray"];
-    int button2_actionarray_0 = button2_actionarray[0];
-    int button2_actionarray_1 = button2_actionarray[1];
-    int button2_actionarray_2 = button2_actionarray[2];
-
-    JsonArray button2_valuearray = doc["button2"]["valuearray"];
-
-    if (button2_actionarray_0 == 4 || button2_actionarray_0 == 8)
-    {
-      const char *button2_symbolarray_0 = button2_valuearray[0];
-      strcpy(menu5.button2.actions.symbol0, button2_symbolarray_0);
-    }
-    else
-    {
-      int button2_valuearray_0 = button2_valuearray[0];
-      menu5.button2.actions.value0 = button2_valuearray_0;
-    }
-
-    if (button2_actionarray_1 == 4 || button2_actionarray_1 == 8)
-    {
-      const char *button2_symbolarray_1 = button2_valuearray[1];
-      strcpy(menu5.button2.actions.symbol1, button2_symbolarray_1);
-    }
-    else
-    {
-      int button2_valuearray_1 = button2_valuearray[1];
-      menu5.button2.actions.value1 = button2_valuearray_1;
-    }
-
-    if (button2_actionarray_2 == 4 || button2_actionarray_2 == 8)
-    {
-      const char *button2_symbolarray_2 = button2_valuearray[2];
-      strcpy(menu5.button2.actions.symbol2, button2_symbolarray_2);
-    }
-    else
-    {
-      int button2_valuearray_2 = button2_valuearray[2];
-      menu5.button2.actions.value2 = button2_valuearray_2;
-    }
-
-    menu5.button2.actions.action0 = button2_actionarray_0;
-    menu5.button2.actions.action1 = button2_actionarray_1;
-    menu5.button2.actions.action2 = button2_actionarray_2;
-
-    menu5.button3.latch = doc["button3"]["latch"] | false;
-
-    JsonArray button3_actionarray = doc["button3"]["actionarray"];
-    int button3_actionarray_0 = button3_actionarray[0]; // 3
-    int button3_actionarray_1 = button3_actionarray[1]; // 0
-    int button3_actionarray_2 = button3_actionarray[2]; // 0
-
-    JsonArray button3_valuearray = doc["button3"]["valuearray"];
-
-    if (button3_actionarray_0 == 4 || button3_actionarray_0 == 8)
-    {
-      const char *button3_symbolarray_0 = button3_valuearray[0];
-      strcpy(menu5.button3.actions.symbol0, button3_symbolarray_0);
-    }
-    else
-    {
-      int button3_valuearray_0 = button3_valuearray[0]; // 1
-      menu5.button3.actions.value0 = button3_valuearray_0;
-    }
-
-    if (button3_actionarray_1 == 4 || button3_actionarray_1 == 8)
-    {
-      const char *button3_symbolarray_1 = button3_valuearray[1]; // 1
-      strcpy(menu5.button3.actions.symbol1, button3_symbolarray_1);
-    }
-    else
-    {
-      int button3_valuearray_1 = button3_valuearray[1]; // 1
-      menu5.button3.actions.value1 = button3_valuearray_1;
-    }
-
-    if (button3_actionarray_2 == 4 || button3_actionarray_2 == 8)
-    {
-      const char *button3_symbolarray_2 = button3_valuearray[2]; // 1
-      strcpy(menu5.button3.actions.symbol2, button3_symbolarray_2);
-    }
-    else
-    {
-      int button3_valuearray_2 = button3_valuearray[2]; // 1
-      menu5.button3.actions.value2 = button3_valuearray_2;
-    }
-
-    menu5.button3.actions.action0 = button3_actionarray_0;
-    menu5.button3.actions.action1 = button3_actionarray_1;
-    menu5.button3.actions.action2 = button3_actionarray_2;
-
-    menu5.button4.latch = doc["button4"]["latch"] | false;
-
-    JsonArray button4_actionarray = doc["button4"]["actionarray"];
-    int button4_actionarray_0 = button4_actionarray[0]; // 3
-    int button4_actionarray_1 = button4_actionarray[1]; // 0
-    int button4_actionarray_2 = button4_actionarray[2]; // 0
-
-    JsonArray button4_valuearray = doc["button4"]["valuearray"];
-
-    if (button4_actionarray_0 == 4 || button4_actionarray_0 == 8)
-    {
-      const char *button4_symbolarray_0 = button4_valuearray[0]; // 1
-      strcpy(menu5.button4.actions.symbol0, button4_symbolarray_0);
-    }
-    else
-    {
-      int button4_valuearray_0 = button4_valuearray[0]; // 1
-      menu5.button4.actions.value0 = button4_valuearray_0;
-    }
-
-    if (button4_actionarray_1 == 4 || button4_actionarray_1 == 8)
-    {
-      const char *button4_symbolarray_1 = button4_valuearray[1]; // 1
-      strcpy(menu5.button4.actions.symbol1, button4_symbolarray_1);
-    }
-    else
-    {
-      int button4_valuearray_1 = button4_valuearray[1]; // 1
-      menu5.button4.actions.value1 = button4_valuearray_1;
-    }
-
-    if (button4_actionarray_2 == 4 || button4_actionarray_2 == 8)
-    {
-      const char *button4_symbolarray_2 = button4_valuearray[2]; // 1
-      strcpy(menu5.button4.actions.symbol2, button4_symbolarray_2);
-    }
-    else
-    {
-      int button4_valuearray_2 = button4_valuearray[2]; // 1
-      menu5.button4.actions.value2 = button4_valuearray_2;
-    }
-    menu5.button4.actions.action0 = button4_actionarray_0;
-    menu5.button4.actions.action1 = button4_actionarray_1;
-    menu5.button4.actions.action2 = button4_actionarray_2;
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo50);
-    strcpy(screen5.logo0, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo51);
-    strcpy(screen5.logo1, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo52);
-    strcpy(screen5.logo2, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo53);
-    strcpy(screen5.logo3, templogopath);
-
-    strcpy(templogopath, logopath);
-    strcat(templogopath, logo54);
-    strcpy(screen5.logo4, templogopath);
-
-    configfile.close();
-
-    if (error)
-    {
-      Serial.println("[ERROR]: deserializeJson() error");
-      Serial.println(error.c_str());
-      return false;
-    }
-
-    return true;
   }
   else
   {
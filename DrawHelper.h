@@ -41,1266 +41,98 @@ void drawlatched(int b, int col, int row)
 */
 void drawlogo(int logonumber, int col, int row, bool transparent, bool latch)
 {
-
-  if (pageNum == 0)
-  {
-    //Draw Home screen logo's
-    if (logonumber == 0)
-    {
-      if (transparent == true)
-      {
-
-        drawBmpTransparent(screen0.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-    else if (logonumber == 1)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(screen0.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(screen0.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(screen0.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-    else if (logonumber == 4)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(screen0.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(screen0.logo5, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(screen0.logo5, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-  }
-  else if (pageNum == 1)
-  {
-    // --------------------------------- MENU 1 --------------------------------------
-    if (logonumber == 0)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu1.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu1.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen1.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen1.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu1.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu1.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen1.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen1.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 1)
-    {
-      if (transparent == true)
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu1.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu1.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen1.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen1.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu1.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu1.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen1.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen1.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu1.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu1.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen1.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen1.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu1.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu1.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen1.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen1.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu1.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu1.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen1.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen1.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu1.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu1.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen1.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen1.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 4)
-    {
-
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu1.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu1.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen1.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen1.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu1.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu1.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen1.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen1.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-  }
-  else if (pageNum == 2)
-  {
-    // --------------------------------- MENU 2 --------------------------------------
-    if (logonumber == 0)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu2.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu2.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen2.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen2.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu2.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu2.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen2.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen2.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 1)
-    {
-      if (transparent == true)
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu2.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu2.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-
-            drawBmpTransparent(screen2.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen2.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu2.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu2.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen2.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen2.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu2.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu2.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen2.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen2.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu2.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu2.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen2.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen2.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu2.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu2.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen2.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen2.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu2.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu2.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen2.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen2.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 4)
-    {
-
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu2.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu2.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen2.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen2.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu2.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu2.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen2.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen2.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-  }
-  else if (pageNum == 3)
-  {
-    // --------------------------------- MENU 3 --------------------------------------
-    if (logonumber == 0)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu3.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu3.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen3.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen3.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu3.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu3.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen3.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen3.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 1)
-    {
-      if (transparent == true)
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu3.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu3.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-
-            drawBmpTransparent(screen3.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen3.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu3.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu3.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen3.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen3.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu3.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu3.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen3.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen3.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu3.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu3.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen3.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen3.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu3.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu3.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen3.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen3.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu3.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu3.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen3.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen3.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 4)
-    {
-
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu3.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu3.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen3.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen3.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu3.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu3.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen3.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen3.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
-  }
-  else if (pageNum == 4)
-  {
-    // --------------------------------- MENU 4 --------------------------------------
-    if (logonumber == 0)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu4.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu4.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen4.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen4.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu4.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu4.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen4.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen4.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 1)
-    {
-      if (transparent == true)
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu4.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu4.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-
-            drawBmpTransparent(screen4.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen4.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu4.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu4.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen4.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen4.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu4.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu4.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen4.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen4.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu4.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu4.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen4.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen4.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu4.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu4.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen4.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen4.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu4.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu4.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen4.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen4.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 4)
-    {
-
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu4.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu4.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen4.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen4.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu4.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu4.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen4.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen4.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
+  const char *logo = getLogo(pageNum, logonumber);
+  if (logo == nullptr)
+  {
+    return;
   }
-  else if (pageNum == 5)
+
+  // A latched menu button shows its latch logo, or the normal logo with a dot if it has none
+  bool drawdot = false;
+  if (latch == true)
   {
-    // --------------------------------- MENU 5 --------------------------------------
-    if (logonumber == 0)
+    struct Button *button = getMenuButton(pageNum, logonumber);
+    if (button && strcmp(button->latchlogo, "/logos/") != 0)
     {
-      if (transparent == true)
-      {
-
-        if (latch == true)
-        {
-          if (strcmp(menu5.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu5.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen5.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen5.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-
-          if (strcmp(menu5.button0.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu5.button0.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen5.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen5.logo0, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
+      logo = button->latchlogo;
     }
-    else if (logonumber == 1)
+    else
     {
-      if (transparent == true)
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu5.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu5.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-
-            drawBmpTransparent(screen5.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen5.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
-          if (strcmp(menu5.button1.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu5.button1.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen5.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen5.logo1, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
+      drawdot = true;
     }
-    else if (logonumber == 2)
-    {
-      if (transparent == true)
-      {
+  }
 
-        if (latch == true)
-        {
-          if (strcmp(menu5.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu5.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen5.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen5.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
+  // The settings logos are always drawn transparent, except for the home button
+  if (pageNum == PAGE_SETTINGS && logonumber < 5)
+  {
+    transparent = true;
+  }
 
-          if (strcmp(menu5.button2.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu5.button2.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen5.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen5.logo2, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 3)
-    {
-      if (transparent == true)
-      {
+  int x = KEY_X - 36 + col * (KEY_W + KEY_SPACING_X);
+  int y = KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y);
 
-        if (latch == true)
-        {
-          if (strcmp(menu5.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu5.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen5.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen5.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
+  if (transparent == true)
+  {
+    drawBmpTransparent(logo, x, y);
+  }
+  else
+  {
+    drawBmp(logo, x, y);
+  }
 
-          if (strcmp(menu5.button3.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu5.button3.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen5.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen5.logo3, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 4)
-    {
+  if (drawdot)
+  {
+    drawlatched(logonumber, col, row);
+  }
+}
 
-      if (transparent == true)
-      {
+/**
+* @brief This function draws one of the 5 function buttons of a page with its
+         latch state.
+*
+* @param b uint8_t the button (0 to 4)
+*
+* @return none
+*
+* @note Used to redraw a single button when only its latch changed.
+*/
+void drawLatchButton(uint8_t b)
+{
+  uint8_t col = colArray[b];
+  uint8_t row = rowArray[b];
 
-        if (latch == true)
-        {
-          if (strcmp(menu5.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmpTransparent(menu5.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmpTransparent(screen5.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmpTransparent(screen5.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-      else
-      {
-        if (latch == true)
-        {
+  bool latched = isLatched(pageNum, b);
 
-          if (strcmp(menu5.button4.latchlogo, "/logos/") != 0)
-          {
-            drawBmp(menu5.button4.latchlogo, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-          }
-          else
-          {
-            drawBmp(screen5.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-            drawlatched(logonumber, col, row);
-          }
-        }
-        else
-        {
-          drawBmp(screen5.logo4, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-        }
-      }
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
+  uint16_t buttonBG;
+  bool drawTransparent;
+  uint16_t imageBGColor;
+  if (latched)
+  {
+    imageBGColor = getLatchImageBG(b);
   }
-  else if (pageNum == 6)
+  else
   {
-    // pageNum6 contains settings logos
-    if (logonumber == 0)
-    {
-      drawBmpTransparent(generallogo.configurator, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-    }
-    else if (logonumber == 1)
-    {
-      drawBmpTransparent("/logos/brightnessdown.bmp", KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-    }
-    else if (logonumber == 2)
-    {
-      drawBmpTransparent("/logos/brightnessup.bmp", KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-    }
-    else if (logonumber == 3)
-    {
-      drawBmpTransparent("/logos/sleep.bmp", KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      if (latch)
-      {
-        drawlatched(logonumber, col, row);
-      }
-    }
-    else if (logonumber == 4)
-    {
-      drawBmpTransparent("/logos/info.bmp", KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-    }
-    else if (logonumber == 5)
-    {
-      if (transparent == true)
-      {
-        drawBmpTransparent(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-      else
-      {
-        drawBmp(generallogo.homebutton, KEY_X - 36 + col * (KEY_W + KEY_SPACING_X), KEY_Y - 36 + row * (KEY_H + KEY_SPACING_Y));
-      }
-    }
+    imageBGColor = getImageBG(b);
+  }
+
+  if (imageBGColor > 0)
+  {
+    buttonBG = imageBGColor;
+    drawTransparent = false;
+  }
+  else
+  {
+    buttonBG = generalconfig.functionButtonColour;
+    drawTransparent = true;
   }
+  tft.setFreeFont(LABEL_FONT);
+  key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
+                    KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
+                    KEY_W, KEY_H, TFT_WHITE, buttonBG, TFT_WHITE,
+                    "", KEY_TEXTSIZE);
+  key[b].drawButton();
+  // After drawing the button outline we call this to draw a logo.
+  drawlogo(b, col, row, drawTransparent, latched);
 }
 
 /**
@@ -1311,13 +143,13 @@ void drawlogo(int logonumber, int col, int row, bool transparent, bool latch)
 *
 * @return none
 *
-* @note Three possibilities: pagenumber = 0 means homescreen,
-         pagenumber = 7 means config mode, anything else is a menu.
+* @note Two possibilities: PAGE_HOME uses the menu button colour, the menus
+         and the settings page use the function button colour.
 */
 void drawKeypad()
 {
   // Draw the home screen button outlines and fill them with colours
-  if (pageNum == 0)
+  if (pageNum == PAGE_HOME)
   {
     for (uint8_t row = 0; row < 2; row++)
     {
@@ -1348,21 +180,6 @@ void drawKeypad()
       }
     }
   }
-  
-  else if (pageNum == 10)
-  {
-    // Pagenum 10 means that a JSON config failed to load completely.
-    tft.fillScreen(TFT_BLACK);
-    tft.setCursor(0, 0);
-    tft.setTextFont(2);
-    tft.setTextSize(1);
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-
-    tft.printf("  %s failed to load and might be corrupted.\n", jsonfilefail);
-    tft.println("  You can reset that specific file to default by opening the serial monitor");
-    tft.printf("  and typing \"reset %s\"\n", jsonfilefail);
-    tft.println("  If you don't do this, the configurator will fail to load.");
-  }
   else
   {
     // Draw the button outlines and fill them with colours
@@ -1406,71 +223,7 @@ void drawKeypad()
         else
         {
           // Otherwise use functionButtonColour
-
-          int index;
-
-          if (pageNum == 2)
-          {
-            index = b + 5;
-          }
-          else if (pageNum == 3)
-          {
-            index = b + 10;
-          }
-          else if (pageNum == 4)
-          {
-            index = b + 15;
-          }
-          else if (pageNum == 5)
-          {
-            index = b + 20;
-          }
-          else if (pageNum == 6)
-          {
-            index = b + 25;
-          }
-          else
-          {
-            index = b;
-          }
-
-          uint16_t buttonBG;
-          bool drawTransparent;
-          uint16_t imageBGColor;
-          if (islatched[index] && b < 5)
-          {
-            imageBGColor = getLatchImageBG(b);
-          }
-          else
-          {
-            imageBGColor = getImageBG(b);
-          }
-
-          if (imageBGColor > 0)
-          {
-            buttonBG = imageBGColor;
-            drawTransparent = false;
-          }
-          else
-          {
-            buttonBG = generalconfig.functionButtonColour;
-            drawTransparent = true;
-          }
-          tft.setFreeFont(LABEL_FONT);
-          key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
-                            KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
-                            KEY_W, KEY_H, TFT_WHITE, buttonBG, TFT_WHITE,
-                            "", KEY_TEXTSIZE);
-          key[b].drawButton();
-          // After drawing the button outline we call this to draw a logo.
-          if (islatched[index] && b < 5)
-          {
-            drawlogo(b, col, row, drawTransparent, true);
-          }
-          else
-          {
-            drawlogo(b, col, row, drawTransparent, false);
-          }
+          drawLatchButton(b);
         }
       }
     }
@@ -1561,6 +314,7 @@ void printinfo()
   {
     tft.println("Sleep: Enabled");
     tft.printf("Sleep timer: %u minutes\n", generalconfig.sleeptimer);
+    tft.printf("Deep sleep after: %u minutes\n", generalconfig.deepsleeptimer);
   }
   else
   {
@@ -1587,11 +341,19 @@ void printinfo()
   tft.print(freemem / 1000);
   tft.println(" kB");
 #if defined(USEUSBHID)
-  tft.println("Using USB Keyboard");
-#else
+  tft.println(usbKeyboardReady() ? "USB Keyboard: in use" : "USB Keyboard: not connected, using BLE");
+#endif //if defined(USEUSBHID)
   tft.print("BLE Keyboard version: ");
   tft.println(BLE_KEYBOARD_VERSION);
-#endif //if defined(USEUSBHID)
+  HidQueueStats hidstats = bleKeyboard.getQueueStats();
+  tft.printf("HID reports: %lu sent, %lu dropped, max queued %u\n",
+             (unsigned long)hidstats.sent, (unsigned long)hidstats.dropped, hidstats.maxdepth);
+  BleLinkInfo link = bleKeyboard.getLinkInfo();
+  tft.printf("BLE interval: %u.%02u ms, latency %u, PHY %s\n",
+             link.interval * 125 / 100, link.interval * 125 % 100, link.latency, link.txPhy == 2 ? "2M" : "1M");
+  tft.printf("BLE host: %u of %u paired\n", bleKeyboard.getHost(), bleKeyboard.getHostCount());
+  tft.printf("Wake: host back in %lu ms, first key in %lu ms\n",
+             (unsigned long)link.reconnectMs, (unsigned long)link.firstKeyMs);
   
   tft.print("ArduinoJson version: ");
   tft.println(ARDUINOJSON_VERSION);
@@ -1599,8 +361,6 @@ void printinfo()
   tft.println(TFT_ESPI_VERSION);
   tft.println("ESP-IDF: ");
   tft.println(esp_get_idf_version());
-
-  displayinginfo = true;
 }
 
 /**
@@ -51,6 +51,7 @@
 #define WAVESHARE_ESP32S3_TOUCH_LCD_43B
 
 // ------- If your board is capapble of USB HID you can uncomment this -
+// Keys then go over USB while a computer is connected to it, and over BLE otherwise.
 
 //#define USEUSBHID
 
@@ -65,6 +66,13 @@
 // ------- Uncomment the define below if you want to use a piezo buzzer and specify the pin where the speaker is connected -------
 //#define speakerPin 26
 
+// ------- Uncomment the next line to ask the host for the 2M PHY (ESP32-S3 and C3 only) -------
+//#define BLE_2M_PHY
+
+// ------- Uncomment the next line to send keys in an NKRO report (any number of keys at once) -------
+// Remove and pair FreeTouchDeck again on the computer after changing this.
+//#define BLE_NKRO
+
 // ------- NimBLE definition, use only if the NimBLE library is installed 
 // and if you are using the original ESP32-BLE-Keyboard library by T-VK -------
 #define USE_NIMBLE 1
@@ -81,13 +89,38 @@ const char *versionnumber = "0.9.18a";
   /* Version 0.9.18a.
    * 
    * Added option to start WiFi, without stopping BLE and starting webserver
-   *  startWifiStation(false, false) will keep Keyboard in combination with WiFi
+   *  wifiStart(false, false) will keep Keyboard in combination with WiFi
    *  this is to try and add API calls together with BLE Keyboard. For this, use
    *  the original T-vK BLE Keyboard library. 
    * Adding ESP32-S3 support
    * Trying to add LitteFS Support
    * Fix #89
    * Fix #90
+   * Added long-press and hold-to-repeat button modes
+   * Split loop() into input, UI, HID and housekeeping tasks (see Tasks.h)
+   * Menus are stored as arrays and buttons are dispatched by lookup (see Menus.h)
+   * Pages are screens with their own handlers and back navigation (see Router.h)
+   * Any number of menus and folders, loaded when first shown and kept in a small cache
+   * The sleep timer now enters a light sleep standby, deep sleep follows after "deepsleeptimer"
+   * Waking from deep sleep restores a snapshot from RTC memory instead of parsing the config
+   * Delays in actions can be interrupted, "Stop running actions" cancels a running macro
+   * Button actions are compiled to bytecode macros of any length (see Macro.h)
+   * Action keycodes come from constexpr lookup tables (see Keytables.h)
+   * Text is typed with key rollover, paced by the BLE connection interval
+   * New action 15 types a text file from /uploads, a touch stops it
+   * Text is typed for the host keyboard layout set in "keyboardlayout" (us, uk, de, fr)
+   * HID reports are queued and sent by their own task instead of busy-waiting 8 ms each
+   * BLE asks for a 7.5-15 ms connection interval, relaxed parameters in standby, optional 2M PHY
+   * Optional NKRO key report, chords are sent in one report (BLE_NKRO)
+   * Switch between bonded hosts with special functions 6 and 7 or the serial command "host"
+   * After a wake the last host is called back first, keys pressed before it is back are sent when it is
+   * A BLE control service lets an app switch pages, run buttons, read latches and patch the config (see BleControl.h)
+   * Latches can follow the host's Num, Caps and Scroll Lock LEDs ("ledstate" in a menu button)
+   * The serial command "trace" records the HID reports a button sends, with timing and a signature
+   * USEUSBHID keeps BLE: keys go over USB while it is connected, media keys work over USB too
+   * Config mode connects to WiFi in the background with retries, shows its progress and can be cancelled
+   * With "keepble" in wificonfig.json the keyboard keeps running in config mode and saved config applies right away
+   * Action 16 and the macro step "http" send an HTTP request (webhook) described in a file in /uploads
   */
 
 #ifndef TFT_ESPI_VERSION
@@ -103,25 +136,22 @@ const char *versionnumber = "0.9.18a";
   #include <TFT_eSPI.h> // The TFT_eSPI library
 #endif
 
+#include <BleKeyboard.h> // BleKeyboard is used to communicate over BLE
+BleKeyboard bleKeyboard("FreeTouchDeck", "Made by me");
+
+  // Checking for BLE Keyboard version
+#ifndef BLE_KEYBOARD_VERSION
+  #warning Old BLE Keyboard version detected. Please update.
+  #define BLE_KEYBOARD_VERSION "Outdated"
+#endif // !defined(BLE_KEYBOARD_VERSION) 
+
 #if defined(USEUSBHID)
 
-  #include "USB.h"
-  #include "USBHIDKeyboard.h"
-  #include "Keydefines.h"
-  USBHIDKeyboard bleKeyboard;
-  
-#else
-  
-  #include <BleKeyboard.h> // BleKeyboard is used to communicate over BLE
-  BleKeyboard bleKeyboard("FreeTouchDeck", "Made by me");
-
-    // Checking for BLE Keyboard version
-  #ifndef BLE_KEYBOARD_VERSION
-    #warning Old BLE Keyboard version detected. Please update.
-    #define BLE_KEYBOARD_VERSION "Outdated"
-  #endif // !defined(BLE_KEYBOARD_VERSION) 
-  
-#endif // if
+  // The reports bleKeyboard makes go to USB while it is mounted
+  #include "UsbKeyboard.h"
+  const HidRoute usbRoute = {usbKeyboardReady, usbKeyboardSendKeys, usbKeyboardSendMedia};
+
+#endif // if defined(USEUSBHID)
 
 #if defined(USE_NIMBLE)
 
@@ -218,7 +248,7 @@ Preferences savedStates;
 // Text Button Label Font
 #define LABEL_FONT &FreeSansBold12pt7b
 
-// placeholder for the pagenumber we are on (0 indicates home)
+// placeholder for the pagenumber we are on, one of the PAGE_* pages (see Router.h)
 int pageNum = 0;
 
 // Initial LED brightness
@@ -235,48 +265,53 @@ char logopath[64] = "/logos/";
 // templogopath is used to hold the complete path of an image. It is empty for now.
 char templogopath[64] = "";
 
+// Highest menu page number (menus are pages 1 to MENU_MAX). Page 0 is the home screen.
+// Menu N is loaded from /config/menuN.json the first time it is shown.
+#define MENU_MAX 100
+
+// Number of menus kept in RAM. The least recently shown menu is dropped first.
+#define MENU_CACHE_SIZE 4
+
+// Every page has 6 buttons. On the menus the last one is the back home button.
+#define BUTTONS_PER_PAGE 6
+
 // Struct to hold the logos per screen
 struct Logos
 {
-  char logo0[32];
-  char logo1[32];
-  char logo2[32];
-  char logo3[32];
-  char logo4[32];
-  char logo5[32];
+  char logo[BUTTONS_PER_PAGE][32];
 };
 
-// Struct Action: 3 actions and 3 values per button
-struct Actions
-{
-  uint8_t action0;
-  uint8_t value0;
-  char symbol0[64];
-  uint8_t action1;
-  uint8_t value1;
-  char symbol1[64];
-  uint8_t action2;
-  uint8_t value2;
-  char symbol2[64];
-};
+// Press modes a button can be configured with
+#define PRESSMODE_TAP 0       // Fire the actions once when pressed
+#define PRESSMODE_LONGPRESS 1 // Fire the actions on a short press, the long actions when held
+#define PRESSMODE_REPEAT 2    // Fire the actions when pressed and keep repeating them while held
+
+// Flags of a button
+#define BUTTON_STOPS 0x01     // The actions are "Stop running actions"
+#define BUTTON_LONGSTOPS 0x02 // The long-press actions are "Stop running actions"
 
-// Each button has an action struct in it
+// Host keyboard LEDs a button latch can follow, the bits of the HID LED output report
+#define LED_NUM_LOCK 0x01
+#define LED_CAPS_LOCK 0x02
+#define LED_SCROLL_LOCK 0x04
+
+// Each button runs a macro (see Macro.h), the macros themselves stay in flash
 struct Button
 {
-  struct Actions actions;
+  uint8_t flags;
   bool latch;
+  uint8_t led; // LED_* the latch follows instead of toggling, 0 for none
   char latchlogo[32];
+  uint8_t pressmode;
+  uint16_t holddelay;
+  uint16_t repeatrate;
 };
 
-// Each menu has 6 buttons
+// Each menu has 5 buttons with actions and their logos (logo 5 is the home button)
 struct Menu
 {
-  struct Button button0;
-  struct Button button1;
-  struct Button button2;
-  struct Button button3;
-  struct Button button4;
-  struct Button button5;
+  struct Logos logos;
+  struct Button button[BUTTONS_PER_PAGE - 1];
 };
 
 // Struct to hold the general logos.
@@ -295,11 +330,13 @@ struct Config
   uint16_t latchedColour;
   bool sleepenable;
   uint16_t sleeptimer;
+  uint16_t deepsleeptimer;
   bool beep;
   uint8_t modifier1;
   uint8_t modifier2;
   uint8_t modifier3;
   uint16_t helperdelay;
+  char keyboardlayout[4]; // Layout of the host keyboard, see KeyLayouts.h
 };
 
 struct Wificonfig
@@ -310,10 +347,14 @@ struct Wificonfig
   char hostname[64];
   uint8_t attempts;
   uint16_t attemptdelay;
+  bool keepble; // Keep the BLE keyboard running next to the configurator (STA only)
 };
 
-// Array to hold all the latching statuses
-bool islatched[30] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+// Number of latch states: 5 per menu plus 5 for the settings page, see latchIndex()
+#define LATCH_COUNT ((MENU_MAX + 1) * 5)
+
+// Bit array to hold all the latching statuses, see isLatched() and toggleLatch()
+uint8_t latchbits[(LATCH_COUNT + 7) / 8] = {0};
 
 // Create instances of the structs
 Wificonfig wificonfig;
@@ -322,24 +363,21 @@ Config generalconfig;
 
 Generallogos generallogo;
 
-Logos screen0;
-Logos screen1;
-Logos screen2;
-Logos screen3;
-Logos screen4;
-Logos screen5;
-Logos screen6;
-
-Menu menu1;
-Menu menu2;
-Menu menu3;
-Menu menu4;
-Menu menu5;
-Menu menu6;
+// The home screen logos
+Logos homescreen;
+
+// The page each of the home screen buttons 0-4 opens
+uint8_t homelinks[BUTTONS_PER_PAGE - 1] = {1, 2, 3, 4, 5};
+
+// The settings page logos, these are fixed
+Logos settingsscreen;
+
+// The menus that are loaded, see getMenu()
+Menu menuCache[MENU_CACHE_SIZE];
 
 unsigned long previousMillis = 0;
 unsigned long Interval = 0;
-bool displayinginfo;
+bool ignoreTouch = false; // Set after waking from standby until the screen is released
 char* jsonfilefail = "";
 
 // Button helper (TFT_eSPI provides TFT_eSPI_Button; Waveshare build uses a minimal compat class)
@@ -353,12 +391,23 @@ char* jsonfilefail = "";
 
 //--------- Internal references ------------
 // (this needs to be below all structs etc..)
+#include "Tasks.h"
+#include "Router.h"
+#include "Menus.h"
+#include "Snapshot.h"
 #include "ScreenHelper.h"
+#include "Macro.h"
 #include "ConfigLoad.h"
 #include "DrawHelper.h"
 #include "ConfigHelper.h"
+#include "Webhook.h"
 #include "UserActions.h"
+#include "Keytables.h"
 #include "Action.h"
+#include "PressHandler.h"
+#include "Standby.h"
+#include "Screens.h"
+#include "BleControl.h"
 #include "Webserver.h"
 #include "TouchCompat.h"
 #ifndef ESP32TouchDownS3
@@ -379,15 +428,8 @@ void setup()
   
   ledBrightness = savedStates.getInt("ledBrightness", 255);
 
-  Serial.println("[INFO]: Reading latch stated back from memory:");
-  savedStates.getBytes("latched", islatched, sizeof(islatched));
-
-  for(int i = 0; i < sizeof(islatched); i++){
-
-  Serial.print(islatched[i]);
-    
-  }
-  Serial.println("");
+  Serial.println("[INFO]: Reading latch stated back from memory");
+  loadLatchStates();
 
 #if defined(USECAPTOUCH) && !defined(WAVESHARE_ESP32S3_TOUCH_LCD_43B)
   #ifdef CUSTOM_TOUCH_SDA
@@ -438,6 +480,9 @@ void setup()
   esp_sleep_wakeup_cause_t wakeup_reason;
   wakeup_reason = esp_sleep_get_wakeup_cause();
 
+  // After a deep sleep wake we can skip all config parsing if the snapshot is valid
+  bool warmresume = snapshotRestore();
+
 
   // -------------- Start filesystem ----------------------
 
@@ -457,14 +502,17 @@ void setup()
 
   //------------------ Load Wifi Config ----------------------------------------------
 
-  Serial.println("[INFO]: Loading Wifi Config");
-  if (!loadMainConfig())
+  if (!warmresume)
   {
-    Serial.println("[WARNING]: Failed to load WiFi Credentials!");
-  }
-  else
-  {
-    Serial.println("[INFO]: WiFi Credentials Loaded");
+    Serial.println("[INFO]: Loading Wifi Config");
+    if (!loadMainConfig())
+    {
+      Serial.println("[WARNING]: Failed to load WiFi Credentials!");
+    }
+    else
+    {
+      Serial.println("[INFO]: WiFi Credentials Loaded");
+    }
   }
 
   // ----------------- Load webserver ---------------------
@@ -500,62 +548,31 @@ void setup()
   Serial.println("[INFO]: Touch calibration completed!");
 #endif // !defined(USECAPTOUCH)
 
-  // Let's first check if all the files we need exist
-  if (!checkfile("/config/general.json"))
+  // On a warm resume the config comes from the snapshot
+  if (!warmresume)
   {
-    Serial.println("[ERROR]: /config/general.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
-
-  if (!checkfile("/config/homescreen.json"))
-  {
-    Serial.println("[ERROR]: /config/homescreen.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
-
-  if (!checkfile("/config/menu1.json"))
-  {
-    Serial.println("[ERROR]: /config/menu1.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
-
-  if (!checkfile("/config/menu2.json"))
-  {
-    Serial.println("[ERROR]: /config/menu2.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
-
-  if (!checkfile("/config/menu3.json"))
-  {
-    Serial.println("[ERROR]: /config/menu3.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
-
-  if (!checkfile("/config/menu4.json"))
-  {
-    Serial.println("[ERROR]: /config/menu4.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
+    // Let's first check if all the files we need exist
+    if (!checkfile("/config/general.json"))
+    {
+      Serial.println("[ERROR]: /config/general.json not found!");
+      while (1)
+        yield(); // Stop!
+    }
 
-  if (!checkfile("/config/menu5.json"))
-  {
-    Serial.println("[ERROR]: /config/menu5.json not found!");
-    while (1)
-      yield(); // Stop!
-  }
+    if (!checkfile("/config/homescreen.json"))
+    {
+      Serial.println("[ERROR]: /config/homescreen.json not found!");
+      while (1)
+        yield(); // Stop!
+    }
 
-  // After checking the config files exist, actually load them
-  if(!loadConfig("general")){
-    Serial.println("[WARNING]: general.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset general'.");
-    jsonfilefail = "general";
-    pageNum = 10;
+    // After checking the config files exist, actually load them
+    if(!loadConfig("general")){
+      Serial.println("[WARNING]: general.json seems to be corrupted!");
+      Serial.println("[WARNING]: To reset to default type 'reset general'.");
+      jsonfilefail = "general";
+      pageNum = PAGE_JSONERROR;
+    }
   }
 
     // Setup PWM channel for Piezo speaker
@@ -585,43 +602,17 @@ if(generalconfig.beep){
 
 #endif // defined(speakerPin)
 
-  if(!loadConfig("homescreen")){
-    Serial.println("[WARNING]: homescreen.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset homescreen'.");
-    jsonfilefail = "homescreen";
-    pageNum = 10;
-  }
-  if(!loadConfig("menu1")){
-    Serial.println("[WARNING]: menu1.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset menu1'.");
-    jsonfilefail = "menu1";
-    pageNum = 10;
-  }
-  if(!loadConfig("menu2")){
-    Serial.println("[WARNING]: menu2.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset menu2'.");
-    jsonfilefail = "menu2";
-    pageNum = 10;
-  }
-  if(!loadConfig("menu3")){
-    Serial.println("[WARNING]: menu3.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset menu3'.");
-    jsonfilefail = "menu3";
-    pageNum = 10;
-  }
-  if(!loadConfig("menu4")){
-    Serial.println("[WARNING]: menu4.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset menu4'.");
-    jsonfilefail = "menu4";
-    pageNum = 10;
-  }
-  if(!loadConfig("menu5")){
-    Serial.println("[WARNING]: menu5.json seems to be corrupted!");
-    Serial.println("[WARNING]: To reset to default type 'reset menu5'.");
-    jsonfilefail = "menu5";
-    pageNum = 10;
+  if (!warmresume)
+  {
+    if(!loadConfig("homescreen")){
+      Serial.println("[WARNING]: homescreen.json seems to be corrupted!");
+      Serial.println("[WARNING]: To reset to default type 'reset homescreen'.");
+      jsonfilefail = "homescreen";
+      pageNum = PAGE_JSONERROR;
+    }
+    // The menus are loaded when they are first shown, see getMenu()
+    Serial.println("[INFO]: All configs loaded");
   }
-  Serial.println("[INFO]: All configs loaded");
 
   
 
@@ -629,32 +620,43 @@ if(generalconfig.beep){
   strcpy(generallogo.configurator, "/logos/wifi.bmp");
   Serial.println("[INFO]: General logos loaded.");
 
+  // The settings page is not configurable, fill in its logos
+  menusSetup();
+
+  // Create the timer used for long-press and hold-to-repeat buttons
+  pressSetup();
+
   // Setup the Font used for plain text
   tft.setFreeFont(LABEL_FONT);
 
   //------------------BLE Initialization ------------------------------------------------------------------------
 
-#if defined(USEUSBHID)
-
-  // initialize control over the keyboard:
-  bleKeyboard.begin();
-  USB.begin();  
-
-#else
-
   Serial.println("[INFO]: Starting BLE");
+#ifdef BLE_2M_PHY
+  bleKeyboard.setPhy2M(true);
+#endif
+  bleKeyboard.selectHost(savedStates.getUChar("blehost", 0));
+  bleKeyboard.setServicesCallback(bleControlSetup);
+#ifdef BLE_NKRO
+  bleKeyboard.begin(true);
+#else
   bleKeyboard.begin();
+#endif
+  if (!bleKeyboard.setLayout(generalconfig.keyboardlayout))
+  {
+    Serial.printf("[WARNING]: Unknown keyboard layout \"%s\", using \"us\".\n", generalconfig.keyboardlayout);
+  }
 
+#if defined(USEUSBHID)
+  Serial.println("[INFO]: Starting USB");
+  usbKeyboardBegin();
+  bleKeyboard.setRoute(&usbRoute);
 #endif //if defined(USEUSBHID)
 
   // ---------------- Printing version numbers -----------------------------------------------
   
-#if defined(USEUSBHID)
-  Serial.println("[INFO]: Using USB Keyboard");
-#else
   Serial.print("[INFO]: BLE Keyboard version: ");
   Serial.println(BLE_KEYBOARD_VERSION);
-#endif //if defined(USEUSBHID)
 
   Serial.print("[INFO]: ArduinoJson version: ");
   Serial.println(ARDUINOJSON_VERSION);
@@ -670,9 +672,10 @@ if(generalconfig.beep){
   // Draw background
   tft.fillScreen(generalconfig.backgroundColour);
 
-  // Draw keypad
+  // Draw the first page
   Serial.println("[INFO]: Drawing keypad");
-  drawKeypad();
+  screensSetup();
+  routerStart(pageNum);
 
 #ifdef touchInterruptPin
   if (generalconfig.sleepenable)
@@ -683,10 +686,13 @@ if(generalconfig.beep){
     Serial.print("[INFO]: Sleep timer = ");
     Serial.print(generalconfig.sleeptimer);
     Serial.println(" minutes");
-    islatched[28] = 1;
+    setLatched(PAGE_SETTINGS, 3, true);
   }
 #endif // defined(touchInterruptPin)
 
+  // Hand over to the input, UI, HID and housekeeping tasks
+  startTasks();
+
   Serial.println("[INFO]: Boot completed and successful!");
 
 }
@@ -695,1016 +701,516 @@ if(generalconfig.beep){
 
 void loop(void)
 {
-  
-  // Check if there is data available on the serial input that needs to be handled.
-  
-  if (Serial.available())
-  {
+  // All work is done by the tasks started in setup(), so the Arduino loop task is not needed.
+  vTaskDelete(NULL);
+}
 
-    String command = Serial.readStringUntil(' ');
+//--------------------- TASKS --------------------------------------------------------------------
+
+/**
+* @brief This task samples the touch screen at a fixed rate and sends every sample
+         to the UI task. Once the touch is released, one released sample is sent.
+*
+* @param pvParameters void * (unused)
+*
+* @return none
+*
+* @note Resistive touch shares the SPI bus with the display, so in that case the
+         UI task samples touch itself and this task is not started.
+*/
+void inputTask(void *pvParameters)
+{
+  TickType_t lastWake = xTaskGetTickCount();
+  bool wasPressed = false;
 
-    if (command == "cal")
-    {
-      FILESYSTEM.remove(CALIBRATION_FILE);
-      ESP.restart();
-    }
-    else if (command == "setssid")
-    {
+  for (;;)
+  {
+    UiEvent event = {UI_EVENT_TOUCH, false, 0, 0, 0};
+    event.pressed = read_touch(event.x, event.y);
 
-      String value = Serial.readString();
-      if (saveWifiSSID(value))
-      {
-        Serial.printf("[INFO]: Saved new SSID: %s\n", value.c_str());
-        loadMainConfig();
-        Serial.println("[INFO]: New configuration loaded");
-      }
-    }
-    else if (command == "setpassword")
-    {
-      String value = Serial.readString();
-      if (saveWifiPW(value))
-      {
-        Serial.printf("[INFO]: Saved new Password: %s\n", value.c_str());
-        loadMainConfig();
-        Serial.println("[INFO]: New configuration loaded");
-      }
-    }
-    else if (command == "setwifimode")
+    if (event.pressed || wasPressed)
     {
-      String value = Serial.readString();
-      if (saveWifiMode(value))
-      {
-        Serial.printf("[INFO]: Saved new WiFi Mode: %s\n", value.c_str());
-        loadMainConfig();
-        Serial.println("[INFO]: New configuration loaded");
-      }
+      // Never block on a full queue, a newer sample will follow shortly
+      xQueueSend(uiQueue, &event, 0);
     }
-    else if (command == "restart")
+    wasPressed = event.pressed;
+
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(INPUT_POLL_MS));
+  }
+}
+
+/**
+* @brief This task owns the display. It handles touch samples, page switches
+         and the special functions, and draws everything.
+*
+* @param pvParameters void * (unused)
+*
+* @return none
+*
+* @note none
+*/
+void uiTask(void *pvParameters)
+{
+  UiEvent event;
+
+  for (;;)
+  {
+    if (xQueueReceive(uiQueue, &event, pdMS_TO_TICKS(UI_TICK_MS)) == pdTRUE)
     {
-      Serial.println("[WARNING]: Restarting");
-      ESP.restart();
+      handleUiEvent(event);
     }
 
-    else if (command == "reset")
+    wifiTick();
+    routerTick();
+    hostLedsSync();
+    bleControlSync();
+
+#ifndef USECAPTOUCH
+    // Resistive touch is read over the display's SPI bus, so sample it here.
+    uint16_t t_x = 0, t_y = 0;
+    dispatchTouch(read_touch(t_x, t_y), t_x, t_y);
+#endif // !defined(USECAPTOUCH)
+  }
+}
+
+/**
+* @brief This task sends the actions of pressed buttons to the host. Long macros
+         and delays only hold up this task, not touch handling or drawing.
+*
+* @param pvParameters void * (unused)
+*
+* @return none
+*
+* @note none
+*/
+void hidTask(void *pvParameters)
+{
+  HidJob job;
+
+  for (;;)
+  {
+    if (xQueueReceive(hidQueue, &job, portMAX_DELAY) != pdTRUE)
     {
-      String file = Serial.readString();
-      Serial.printf("[INFO]: Resetting %s.json now\n", file.c_str());
-      resetconfig(file);
+      continue;
     }
-    
-    else if(command == "menu1" && pageNum !=1 && pageNum != 7)
+    if (job.slot == HID_SLOT_COMPILE)
     {
-      pageNum = 1;
-      drawKeypad();
-      Serial.println("Auto Switched to Menu 1");
+      // Never while a macro runs from the file, see queueCompile()
+      macroCompileMenu(job.page);
+      postUiEvent(UI_EVENT_RELOAD, job.page);
     }
-  
-    else if(command == "menu2" && pageNum !=2 && pageNum != 7)
+    else if (job.generation == hidCancelGeneration)
     {
-
-      pageNum = 2;
-      drawKeypad();
-      Serial.println("Auto Switched to Menu 2");
+      // A cancel made after the job was queued stops it, an older one does not
+      hidRunningGeneration = job.generation;
+      macroRun(job.page, job.slot, job.repeat);
     }
-   
-    else if(command == "menu3" && pageNum !=3 && pageNum != 7)
-    {
+  }
+}
 
-      pageNum = 3;
-      drawKeypad();
-      Serial.println("Auto Switched to Menu 3");
-    }
+/**
+* @brief This task handles the serial commands and the sleep timer.
+*
+* @param pvParameters void * (unused)
+*
+* @return none
+*
+* @note Reading a serial command may block for the Serial timeout, which only
+         delays this task.
+*/
+void housekeepingTask(void *pvParameters)
+{
+  bool sleepRequested = false;
 
-    else if(command == "menu4" && pageNum !=4 && pageNum != 7)
+  for (;;)
+  {
+    if (Serial.available())
     {
-
-      pageNum = 4;
-      drawKeypad();
-      Serial.println("Auto Switched to Menu 4");
+      String command = Serial.readStringUntil(' ');
+      handleSerialCommand(command);
     }
 
-    else if(command == "menu5" && pageNum !=5 && pageNum != 7)
+#ifdef touchInterruptPin
+    // Check if sleep is enabled and if our timer has ended. Sleep is only
+    // entered from the screens that allow it (the button pages).
+    if (generalconfig.sleepenable && !sleepRequested && routerCanSleep() && millis() > previousMillis + Interval)
     {
-
-      pageNum = 5;
-      drawKeypad();
-      Serial.println("Auto Switched to Menu 5");
+      sleepRequested = postUiEvent(UI_EVENT_SLEEP, 0);
     }
-  }
-  
-  if (pageNum == 7)
-  {
-      uint16_t t_x = 0, t_y = 0;
-      boolean pressed = false;
-
-    // If pageNum = 7, we are in STA or AP mode.
-    // We no check if the button is pressed, and if so restart.
-    pressed = read_touch(t_x, t_y);
-
-    if (pressed)
-    {     
-      // If pressed check if the touch falls within the restart button
-      // drawSingleButton(140, 180, 200, 80, generalconfig.menuButtonColour, TFT_WHITE, "Restart");
-      if (t_x > 140 && t_x < 340){
-        if (t_y > 180 && t_y < 260){
-          // Touch falls within the boundaries of our button so we restart
-          Serial.println("[WARNING]: Restarting");
-          ESP.restart();
-        }
-      }
-
+    else if (millis() <= previousMillis + Interval)
+    {
+      // We woke from standby (or were touched before it started)
+      sleepRequested = false;
     }
+#endif // defined(touchInterruptPin)
 
+    vTaskDelay(pdMS_TO_TICKS(HOUSEKEEPING_PERIOD_MS));
   }
-  else if (pageNum == 8)
+}
+
+/**
+* @brief This function creates the queues and starts all tasks.
+*
+* @param none
+*
+* @return none
+*
+* @note Call once at the end of setup().
+*/
+void startTasks()
+{
+  uiQueue = xQueueCreate(UI_QUEUE_LENGTH, sizeof(UiEvent));
+  hidQueue = xQueueCreate(HID_QUEUE_LENGTH, sizeof(HidJob));
+
+  xTaskCreatePinnedToCore(uiTask, "ftd_ui", UI_TASK_STACK, NULL, UI_TASK_PRIORITY, &uiTaskHandle, UI_TASK_CORE);
+  xTaskCreatePinnedToCore(hidTask, "ftd_hid", HID_TASK_STACK, NULL, HID_TASK_PRIORITY, &hidTaskHandle, HID_TASK_CORE);
+  xTaskCreatePinnedToCore(housekeepingTask, "ftd_house", HOUSEKEEPING_TASK_STACK, NULL, HOUSEKEEPING_TASK_PRIORITY, &housekeepingTaskHandle, HOUSEKEEPING_TASK_CORE);
+  webhookQueueHandle = xQueueCreate(WEBHOOK_QUEUE_LENGTH, sizeof(WebhookJob));
+  xTaskCreatePinnedToCore(webhookTask, "ftd_webhook", WEBHOOK_TASK_STACK, NULL, WEBHOOK_TASK_PRIORITY, &webhookTaskHandle, WEBHOOK_TASK_CORE);
+#ifdef USECAPTOUCH
+  xTaskCreatePinnedToCore(inputTask, "ftd_input", INPUT_TASK_STACK, NULL, INPUT_TASK_PRIORITY, &inputTaskHandle, INPUT_TASK_CORE);
+#endif // defined(USECAPTOUCH)
+
+  Serial.println("[INFO]: Tasks started");
+}
+
+//--------------------- SERIAL COMMANDS ----------------------------------------------------------
+
+// How many reports the "trace" serial command records (24 bytes each)
+#define HID_TRACE_ENTRIES 256
+
+/**
+* @brief This function prints the HID reports recorded by "trace start".
+*
+* @param none
+*
+* @return none
+*
+* @note Times are relative to the first report. The signature is a CRC over the
+         report IDs and contents only, so two runs of the same button can be
+         compared without the timing.
+*/
+void printHidTrace()
+{
+  const HidTraceEntry *trace;
+  uint32_t overflow;
+  size_t count = bleKeyboard.getTrace(&trace, &overflow);
+  if (count == 0)
   {
+    Serial.println("[INFO]: The HID trace is empty.");
+    return;
+  }
 
-    if (!displayinginfo)
+  uint32_t signature = 0;
+  uint32_t reports[4] = {0};
+  uint32_t start = trace[0].queuedUs;
+  for (size_t i = 0; i < count; i++)
+  {
+    const HidTraceEntry &entry = trace[i];
+    Serial.printf("%4u +%8lu us (waited %6lu us) id %u:", i, (unsigned long)(entry.sentUs - start),
+                  (unsigned long)(entry.sentUs - entry.queuedUs), entry.reportId);
+    for (uint8_t j = 0; j < entry.length; j++)
     {
-      printinfo();
+      Serial.printf(" %02x", entry.data[j]);
     }
+    Serial.println();
 
-    uint16_t t_x = 0, t_y = 0;
-
-    //At the beginning of a new loop, make sure we do not use last loop's touch.
-    boolean pressed = false;
-
-    pressed = read_touch(t_x, t_y);
-
-    if (pressed)
-    {     
-      displayinginfo = false;
-      pageNum = 6;
-      tft.fillScreen(generalconfig.backgroundColour);
-      drawKeypad();
+    signature = esp_rom_crc32_le(signature, &entry.reportId, 2 + entry.length);
+    if (entry.reportId < 4)
+    {
+      reports[entry.reportId]++;
     }
   }
-  else if (pageNum == 9)
-  {
-
-    // We were unable to connect to WiFi. Waiting for touch to get back to the settings menu.
-    uint16_t t_x = 0, t_y = 0;
 
-    //At the beginning of a new loop, make sure we do not use last loop's touch.
-    boolean pressed = false;
+  Serial.printf("[INFO]: %u reports (keyboard %lu, media %lu, NKRO %lu), %lu not recorded, %lu us from the first to the last\n",
+                count, (unsigned long)reports[KEYBOARD_ID], (unsigned long)reports[MEDIA_KEYS_ID],
+                (unsigned long)reports[NKRO_ID], (unsigned long)overflow, (unsigned long)(trace[count - 1].sentUs - start));
+  Serial.printf("[INFO]: Trace signature: %08lx\n", (unsigned long)signature);
+}
 
-    pressed = read_touch(t_x, t_y);
+/**
+* @brief This function handles a command received over serial.
+*
+* @param command String
+*
+* @return none
+*
+* @note Runs on the housekeeping task. Anything that draws is sent to the UI task.
+*/
+void handleSerialCommand(String command)
+{
+  if (command == "cal")
+  {
+    FILESYSTEM.remove(CALIBRATION_FILE);
+    ESP.restart();
+  }
+  else if (command == "setssid")
+  {
 
-    if (pressed)
-    {     
-      // Return to Settings page
-      displayinginfo = false;
-      pageNum = 6;
-      tft.fillScreen(generalconfig.backgroundColour);
-      drawKeypad();
+    String value = Serial.readString();
+    if (saveWifiSSID(value))
+    {
+      Serial.printf("[INFO]: Saved new SSID: %s\n", value.c_str());
+      loadMainConfig();
+      Serial.println("[INFO]: New configuration loaded");
     }
   }
-  else if (pageNum == 10)
+  else if (command == "setpassword")
   {
-
-    // A JSON file failed to load. We are drawing an error message. And waiting for a touch.
-    uint16_t t_x = 0, t_y = 0;
-
-    //At the beginning of a new loop, make sure we do not use last loop's touch.
-    boolean pressed = false;
-
-    pressed = read_touch(t_x, t_y);
-
-    if (pressed)
-    {     
-      // Load home screen
-      displayinginfo = false;
-      pageNum = 0;
-      tft.fillScreen(generalconfig.backgroundColour);
-      drawKeypad();
+    String value = Serial.readString();
+    if (saveWifiPW(value))
+    {
+      Serial.printf("[INFO]: Saved new Password: %s\n", value.c_str());
+      loadMainConfig();
+      Serial.println("[INFO]: New configuration loaded");
     }
   }
-  else
+  else if (command == "setwifimode")
   {
-
-    // Check if sleep is enabled and if our timer has ended.
-
-#ifdef touchInterruptPin
-    if (generalconfig.sleepenable)
+    String value = Serial.readString();
+    if (saveWifiMode(value))
     {
-      if (millis() > previousMillis + Interval)
-      {
-
-        // The timer has ended and we are going to sleep  .
-        tft.fillScreen(TFT_BLACK);
-        Serial.println("[INFO]: Going to sleep.");
-#ifdef speakerPin
-        if(generalconfig.beep){
-        ledcAttachPin(speakerPin, 2);
-        ledcWriteTone(2, 1200);
-        delay(150);
-        ledcDetachPin(speakerPin);
-        ledcWrite(2, 0);
-
-        ledcAttachPin(speakerPin, 2);
-        ledcWriteTone(2, 800);
-        delay(150);
-        ledcDetachPin(speakerPin);
-        ledcWrite(2, 0);
-
-        ledcAttachPin(speakerPin, 2);
-        ledcWriteTone(2, 600);
-        delay(150);
-        ledcDetachPin(speakerPin);
-        ledcWrite(2, 0);
-        }
-#endif // defined(speakerPin)
-        Serial.println("[INFO]: Saving latched states");
-
-//        You could uncomment this to see the latch stated before going to sleep
-//        for(int i = 0; i < sizeof(islatched); i++){
-//      
-//        Serial.print(islatched[i]);
-//          
-//        }
-//        Serial.println("");
-
-        savedStates.putBytes("latched", &islatched, sizeof(islatched));
-        esp_sleep_enable_ext0_wakeup(touchInterruptPin, 0);
-        esp_deep_sleep_start();
-      }
+      Serial.printf("[INFO]: Saved new WiFi Mode: %s\n", value.c_str());
+      loadMainConfig();
+      Serial.println("[INFO]: New configuration loaded");
     }
-#endif // defined(touchInterruptPin)
-
-    // Touch coordinates are stored here
-    uint16_t t_x = 0, t_y = 0;
-
-    //At the beginning of a new loop, make sure we do not use last loop's touch.
-    boolean pressed = false;
+  }
+  else if (command == "restart")
+  {
+    Serial.println("[WARNING]: Restarting");
+    ESP.restart();
+  }
 
-    pressed = read_touch(t_x, t_y);
+  else if (command == "cancel")
+  {
+    cancelActions();
+  }
 
-    // Check if the X and Y coordinates of the touch are within one of our buttons
-    for (uint8_t b = 0; b < 6; b++)
+  else if (command == "hidstats")
+  {
+    HidQueueStats hidstats = bleKeyboard.getQueueStats();
+    Serial.printf("[INFO]: HID reports sent: %lu, dropped: %lu, retried: %lu, queued: %u (max %u), over USB: %lu\n",
+                  (unsigned long)hidstats.sent, (unsigned long)hidstats.dropped, (unsigned long)hidstats.retries,
+                  hidstats.depth, hidstats.maxdepth, (unsigned long)hidstats.routed);
+  }
+  else if (command == "blelink")
+  {
+    BleLinkInfo link = bleKeyboard.getLinkInfo();
+    Serial.printf("[INFO]: BLE interval: %u.%02u ms, latency: %u, timeout: %u ms, PHY tx %u rx %u, %s parameters\n",
+                  link.interval * 125 / 100, link.interval * 125 % 100, link.latency, link.timeout * 10,
+                  link.txPhy, link.rxPhy, link.fast ? "fast" : "relaxed");
+    Serial.printf("[INFO]: After the last wake the host was back after %lu ms, the first key waited %lu ms\n",
+                  (unsigned long)link.reconnectMs, (unsigned long)link.firstKeyMs);
+  }
+  else if (command == "trace")
+  {
+    String value = Serial.readString();
+    value.trim();
+    if (value == "start")
     {
-      if (pressed && key[b].contains(t_x, t_y))
+      if (bleKeyboard.startTrace(HID_TRACE_ENTRIES))
       {
-        key[b].press(true); // tell the button it is pressed
-
-        // After receiving a valid touch reset the sleep timer
-        previousMillis = millis();
+        Serial.println("[INFO]: Recording HID reports.");
       }
       else
       {
-        key[b].press(false); // tell the button it is NOT pressed
+        Serial.println("[WARNING]: Not enough memory for the HID trace.");
       }
     }
+    else if (value == "stop")
+    {
+      bleKeyboard.stopTrace();
+      printHidTrace();
+    }
+    else
+    {
+      printHidTrace();
+    }
+  }
+  else if (command == "host")
+  {
+    String value = Serial.readString();
+    switchHost(value.toInt());
+  }
+  else if (command == "webhook")
+  {
+    String value = Serial.readString();
+    value.trim();
+    webhookQueue(value.c_str());
+  }
+  else if (command == "webhooks")
+  {
+    uint32_t average = webhookStats.sent ? webhookStats.totalMs / webhookStats.sent : 0;
+    Serial.printf("[INFO]: Webhooks sent: %lu (%lu over a kept-open connection), HTTP errors: %lu, failed: %lu, dropped: %lu\n",
+                  (unsigned long)webhookStats.sent, (unsigned long)webhookStats.reused, (unsigned long)webhookStats.errors,
+                  (unsigned long)webhookStats.failed, (unsigned long)webhookStats.dropped);
+    Serial.printf("[INFO]: Webhook latency last: %lu ms, average: %lu ms, max: %lu ms\n",
+                  (unsigned long)webhookStats.lastMs, (unsigned long)average, (unsigned long)webhookStats.maxMs);
+  }
 
-    // Check if any key has changed state
-    for (uint8_t b = 0; b < 6; b++)
+  else if (command == "reset")
+  {
+    String file = Serial.readString();
+    Serial.printf("[INFO]: Resetting %s.json now\n", file.c_str());
+    resetconfig(file);
+  }
+  
+  else if (command.startsWith("menu"))
+  {
+    int page = command.substring(4).toInt();
+    if (isMenuPage(page))
     {
-      if (key[b].justReleased())
-      {
+      // Drawing is done by the UI task
+      postUiEvent(UI_EVENT_PAGE, page);
+    }
+  }
+}
 
-        // Draw normal button space (non inverted)
-
-        int col, row;
-
-        if (b == 0)
-        {
-          col = 0;
-          row = 0;
-        }
-        else if (b == 1)
-        {
-          col = 1;
-          row = 0;
-        }
-        else if (b == 2)
-        {
-          col = 2;
-          row = 0;
-        }
-        else if (b == 3)
-        {
-          col = 0;
-          row = 1;
-        }
-        else if (b == 4)
-        {
-          col = 1;
-          row = 1;
-        }
-        else if (b == 5)
-        {
-          col = 2;
-          row = 1;
-        }
-
-        int index;
-
-        if (pageNum == 2)
-        {
-          index = b + 5;
-        }
-        else if (pageNum == 3)
-        {
-          index = b + 10;
-        }
-        else if (pageNum == 4)
-        {
-          index = b + 15;
-        }
-        else if (pageNum == 5)
-        {
-          index = b + 20;
-        }
-        else if (pageNum == 6)
-        {
-          index = b + 25;
-        }
-        else
-        {
-          index = b;
-        }
-
-        uint16_t buttonBG;
-        bool drawTransparent;
-
-        uint16_t imageBGColor;
-        if (islatched[index] && b < 5)
-        {
-          imageBGColor = getLatchImageBG(b);
-        }
-        else
-        {
-          imageBGColor = getImageBG(b);
-        }
-
-        if (imageBGColor > 0)
-        {
-          buttonBG = imageBGColor;
-          drawTransparent = false;
-        }
-        else
-        {
-          if (pageNum == 0)
-          {
-            buttonBG = generalconfig.menuButtonColour;
-            drawTransparent = true;
-          }
-          else
-          {
-            if (pageNum == 6 && b == 5)
-            {
-              buttonBG = generalconfig.menuButtonColour;
-              drawTransparent = true;
-            }
-            else
-            {
-              buttonBG = generalconfig.functionButtonColour;
-              drawTransparent = true;
-            }
-          }
-        }
-        tft.setFreeFont(LABEL_FONT);
-        key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
-                          KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
-                          KEY_W, KEY_H, TFT_WHITE, buttonBG, TFT_WHITE,
-                          "", KEY_TEXTSIZE);
-        key[b].drawButton();
-
-        // After drawing the button outline we call this to draw a logo.
-        if (islatched[index] && b < 5)
-        {
-          drawlogo(b, col, row, drawTransparent, true);
-        }
-        else
-        {
-          drawlogo(b, col, row, drawTransparent, false);
-        }
-      }
+//--------------------- UI -----------------------------------------------------------------------
 
-      if (key[b].justPressed())
-      {
-        
-        // Beep
-        #ifdef speakerPin
-        if(generalconfig.beep){
-          ledcAttachPin(speakerPin, 2);
-          ledcWriteTone(2, 600);
-          delay(50);
-          ledcDetachPin(speakerPin);
-          ledcWrite(2, 0);
-        }
-        #endif 
-        
-        int col, row;
-
-        if (b == 0)
-        {
-          col = 0;
-          row = 0;
-        }
-        else if (b == 1)
-        {
-          col = 1;
-          row = 0;
-        }
-        else if (b == 2)
-        {
-          col = 2;
-          row = 0;
-        }
-        else if (b == 3)
-        {
-          col = 0;
-          row = 1;
-        }
-        else if (b == 4)
-        {
-          col = 1;
-          row = 1;
-        }
-        else if (b == 5)
-        {
-          col = 2;
-          row = 1;
-        }
-
-        tft.setFreeFont(LABEL_FONT);
-        key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
-                          KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
-                          KEY_W, KEY_H, TFT_WHITE, TFT_WHITE, TFT_WHITE,
-                          "", KEY_TEXTSIZE);
-        key[b].drawButton();
-
-        //---------------------------------------- Button press handeling --------------------------------------------------
-
-        if (pageNum == 0) //Home menu
-        {
-          if (b == 0) // Button 0
-          {
-            pageNum = 1;
-            drawKeypad();
-          }
-          else if (b == 1) // Button 1
-          {
-            pageNum = 2;
-            drawKeypad();
-          }
-          else if (b == 2) // Button 2
-          {
-            pageNum = 3;
-            drawKeypad();
-          }
-          else if (b == 3) // Button 3
-          {
-            pageNum = 4;
-            drawKeypad();
-          }
-          else if (b == 4) // Button 4
-          {
-            pageNum = 5;
-            drawKeypad();
-          }
-          else if (b == 5) // Button 5
-          {
-            pageNum = 6;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 1) // Menu 1
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(menu1.button0.actions.action0, menu1.button0.actions.value0, menu1.button0.actions.symbol0);
-            bleKeyboardAction(menu1.button0.actions.action1, menu1.button0.actions.value1, menu1.button0.actions.symbol1);
-            bleKeyboardAction(menu1.button0.actions.action2, menu1.button0.actions.value2, menu1.button0.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu1.button0.latch)
-            {
-              if (islatched[0])
-              {
-                islatched[0] = 0;
-              }
-              else
-              {
-                islatched[0] = 1;
-              }
-            }
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(menu1.button1.actions.action0, menu1.button1.actions.value0, menu1.button1.actions.symbol0);
-            bleKeyboardAction(menu1.button1.actions.action1, menu1.button1.actions.value1, menu1.button1.actions.symbol1);
-            bleKeyboardAction(menu1.button1.actions.action2, menu1.button1.actions.value2, menu1.button1.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu1.button1.latch)
-            {
-              if (islatched[1])
-              {
-                islatched[1] = 0;
-              }
-              else
-              {
-                islatched[1] = 1;
-              }
-            }
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(menu1.button2.actions.action0, menu1.button2.actions.value0, menu1.button2.actions.symbol0);
-            bleKeyboardAction(menu1.button2.actions.action1, menu1.button2.actions.value1, menu1.button2.actions.symbol1);
-            bleKeyboardAction(menu1.button2.actions.action2, menu1.button2.actions.value2, menu1.button2.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu1.button2.latch)
-            {
-              if (islatched[2])
-              {
-                islatched[2] = 0;
-              }
-              else
-              {
-                islatched[2] = 1;
-              }
-            }
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(menu1.button3.actions.action0, menu1.button3.actions.value0, menu1.button3.actions.symbol0);
-            bleKeyboardAction(menu1.button3.actions.action1, menu1.button3.actions.value1, menu1.button3.actions.symbol1);
-            bleKeyboardAction(menu1.button3.actions.action2, menu1.button3.actions.value2, menu1.button3.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu1.button3.latch)
-            {
-              if (islatched[3])
-              {
-                islatched[3] = 0;
-              }
-              else
-              {
-                islatched[3] = 1;
-              }
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            bleKeyboardAction(menu1.button4.actions.action0, menu1.button4.actions.value0, menu1.button4.actions.symbol0);
-            bleKeyboardAction(menu1.button4.actions.action1, menu1.button4.actions.value1, menu1.button4.actions.symbol1);
-            bleKeyboardAction(menu1.button4.actions.action2, menu1.button4.actions.value2, menu1.button4.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu1.button4.latch)
-            {
-              if (islatched[4])
-              {
-                islatched[4] = 0;
-              }
-              else
-              {
-                islatched[4] = 1;
-              }
-            }
-          }
-          else if (b == 5) // Button 5 / Back home
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 2) // Menu 2
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(menu2.button0.actions.action0, menu2.button0.actions.value0, menu2.button0.actions.symbol0);
-            bleKeyboardAction(menu2.button0.actions.action1, menu2.button0.actions.value1, menu2.button0.actions.symbol1);
-            bleKeyboardAction(menu2.button0.actions.action2, menu2.button0.actions.value2, menu2.button0.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu2.button0.latch)
-            {
-              if (islatched[5])
-              {
-                islatched[5] = 0;
-              }
-              else
-              {
-                islatched[5] = 1;
-              }
-            }
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(menu2.button1.actions.action0, menu2.button1.actions.value0, menu2.button1.actions.symbol0);
-            bleKeyboardAction(menu2.button1.actions.action1, menu2.button1.actions.value1, menu2.button1.actions.symbol1);
-            bleKeyboardAction(menu2.button1.actions.action2, menu2.button1.actions.value2, menu2.button1.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu2.button1.latch)
-            {
-              if (islatched[6])
-              {
-                islatched[6] = 0;
-              }
-              else
-              {
-                islatched[6] = 1;
-              }
-            }
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(menu2.button2.actions.action0, menu2.button2.actions.value0, menu2.button2.actions.symbol0);
-            bleKeyboardAction(menu2.button2.actions.action1, menu2.button2.actions.value1, menu2.button2.actions.symbol1);
-            bleKeyboardAction(menu2.button2.actions.action2, menu2.button2.actions.value2, menu2.button2.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu2.button2.latch)
-            {
-              if (islatched[7])
-              {
-                islatched[7] = 0;
-              }
-              else
-              {
-                islatched[7] = 1;
-              }
-            }
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(menu2.button3.actions.action0, menu2.button3.actions.value0, menu2.button3.actions.symbol0);
-            bleKeyboardAction(menu2.button3.actions.action1, menu2.button3.actions.value1, menu2.button3.actions.symbol1);
-            bleKeyboardAction(menu2.button3.actions.action2, menu2.button3.actions.value2, menu2.button3.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu2.button3.latch)
-            {
-              if (islatched[8])
-              {
-                islatched[8] = 0;
-              }
-              else
-              {
-                islatched[8] = 1;
-              }
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            bleKeyboardAction(menu2.button4.actions.action0, menu2.button4.actions.value0, menu2.button4.actions.symbol0);
-            bleKeyboardAction(menu2.button4.actions.action1, menu2.button4.actions.value1, menu2.button4.actions.symbol1);
-            bleKeyboardAction(menu2.button4.actions.action2, menu2.button4.actions.value2, menu2.button4.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu2.button4.latch)
-            {
-              if (islatched[9])
-              {
-                islatched[9] = 0;
-              }
-              else
-              {
-                islatched[9] = 1;
-              }
-            }
-          }
-          else if (b == 5) // Button 5 / Back home
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 3) // Menu 3
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(menu3.button0.actions.action0, menu3.button0.actions.value0, menu3.button0.actions.symbol0);
-            bleKeyboardAction(menu3.button0.actions.action1, menu3.button0.actions.value1, menu3.button0.actions.symbol1);
-            bleKeyboardAction(menu3.button0.actions.action2, menu3.button0.actions.value2, menu3.button0.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu3.button0.latch)
-            {
-              if (islatched[10])
-              {
-                islatched[10] = 0;
-              }
-              else
-              {
-                islatched[10] = 1;
-              }
-            }
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(menu3.button1.actions.action0, menu3.button1.actions.value0, menu3.button1.actions.symbol0);
-            bleKeyboardAction(menu3.button1.actions.action1, menu3.button1.actions.value1, menu3.button1.actions.symbol1);
-            bleKeyboardAction(menu3.button1.actions.action2, menu3.button1.actions.value2, menu3.button1.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu3.button1.latch)
-            {
-              if (islatched[11])
-              {
-                islatched[11] = 0;
-              }
-              else
-              {
-                islatched[11] = 1;
-              }
-            }
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(menu3.button2.actions.action0, menu3.button2.actions.value0, menu3.button2.actions.symbol0);
-            bleKeyboardAction(menu3.button2.actions.action1, menu3.button2.actions.value1, menu3.button2.actions.symbol1);
-            bleKeyboardAction(menu3.button2.actions.action2, menu3.button2.actions.value2, menu3.button2.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu3.button2.latch)
-            {
-              if (islatched[12])
-              {
-                islatched[12] = 0;
-              }
-              else
-              {
-                islatched[12] = 1;
-              }
-            }
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(menu3.button3.actions.action0, menu3.button3.actions.value0, menu3.button3.actions.symbol0);
-            bleKeyboardAction(menu3.button3.actions.action1, menu3.button3.actions.value1, menu3.button3.actions.symbol1);
-            bleKeyboardAction(menu3.button3.actions.action2, menu3.button3.actions.value2, menu3.button3.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu3.button3.latch)
-            {
-              if (islatched[13])
-              {
-                islatched[13] = 0;
-              }
-              else
-              {
-                islatched[13] = 1;
-              }
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            bleKeyboardAction(menu3.button4.actions.action0, menu3.button4.actions.value0, menu3.button4.actions.symbol0);
-            bleKeyboardAction(menu3.button4.actions.action1, menu3.button4.actions.value1, menu3.button4.actions.symbol1);
-            bleKeyboardAction(menu3.button4.actions.action2, menu3.button4.actions.value2, menu3.button4.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu3.button4.latch)
-            {
-              if (islatched[14])
-              {
-                islatched[14] = 0;
-              }
-              else
-              {
-                islatched[14] = 1;
-              }
-            }
-          }
-          else if (b == 5) // Button 5 / Back home
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 4) // Menu 4
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(menu4.button0.actions.action0, menu4.button0.actions.value0, menu4.button0.actions.symbol0);
-            bleKeyboardAction(menu4.button0.actions.action1, menu4.button0.actions.value1, menu4.button0.actions.symbol1);
-            bleKeyboardAction(menu4.button0.actions.action2, menu4.button0.actions.value2, menu4.button0.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu4.button0.latch)
-            {
-              if (islatched[15])
-              {
-                islatched[15] = 0;
-              }
-              else
-              {
-                islatched[15] = 1;
-              }
-            }
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(menu4.button1.actions.action0, menu4.button1.actions.value0, menu4.button1.actions.symbol0);
-            bleKeyboardAction(menu4.button1.actions.action1, menu4.button1.actions.value1, menu4.button1.actions.symbol1);
-            bleKeyboardAction(menu4.button1.actions.action2, menu4.button1.actions.value2, menu4.button1.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu4.button1.latch)
-            {
-              if (islatched[16])
-              {
-                islatched[16] = 0;
-              }
-              else
-              {
-                islatched[16] = 1;
-              }
-            }
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(menu4.button2.actions.action0, menu4.button2.actions.value0, menu4.button2.actions.symbol0);
-            bleKeyboardAction(menu4.button2.actions.action1, menu4.button2.actions.value1, menu4.button2.actions.symbol1);
-            bleKeyboardAction(menu4.button2.actions.action2, menu4.button2.actions.value2, menu4.button2.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu4.button2.latch)
-            {
-              if (islatched[17])
-              {
-                islatched[17] = 0;
-              }
-              else
-              {
-                islatched[17] = 1;
-              }
-            }
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(menu4.button3.actions.action0, menu4.button3.actions.value0, menu4.button3.actions.symbol0);
-            bleKeyboardAction(menu4.button3.actions.action1, menu4.button3.actions.value1, menu4.button3.actions.symbol1);
-            bleKeyboardAction(menu4.button3.actions.action2, menu4.button3.actions.value2, menu4.button3.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu4.button3.latch)
-            {
-              if (islatched[18])
-              {
-                islatched[18] = 0;
-              }
-              else
-              {
-                islatched[18] = 1;
-              }
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            bleKeyboardAction(menu4.button4.actions.action0, menu4.button4.actions.value0, menu4.button4.actions.symbol0);
-            bleKeyboardAction(menu4.button4.actions.action1, menu4.button4.actions.value1, menu4.button4.actions.symbol1);
-            bleKeyboardAction(menu4.button4.actions.action2, menu4.button4.actions.value2, menu4.button4.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu4.button4.latch)
-            {
-              if (islatched[19])
-              {
-                islatched[19] = 0;
-              }
-              else
-              {
-                islatched[19] = 1;
-              }
-            }
-          }
-          else if (b == 5) // Button 5 / Back home
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 5) // Menu 5
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(menu5.button0.actions.action0, menu5.button0.actions.value0, menu5.button0.actions.symbol0);
-            bleKeyboardAction(menu5.button0.actions.action1, menu5.button0.actions.value1, menu5.button0.actions.symbol1);
-            bleKeyboardAction(menu5.button0.actions.action2, menu5.button0.actions.value2, menu5.button0.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu5.button0.latch)
-            {
-              if (islatched[20])
-              {
-                islatched[20] = 0;
-              }
-              else
-              {
-                islatched[20] = 1;
-              }
-            }
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(menu5.button1.actions.action0, menu5.button1.actions.value0, menu5.button1.actions.symbol0);
-            bleKeyboardAction(menu5.button1.actions.action1, menu5.button1.actions.value1, menu5.button1.actions.symbol1);
-            bleKeyboardAction(menu5.button1.actions.action2, menu5.button1.actions.value2, menu5.button1.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu5.button1.latch)
-            {
-              if (islatched[21])
-              {
-                islatched[21] = 0;
-              }
-              else
-              {
-                islatched[21] = 1;
-              }
-            }
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(menu5.button2.actions.action0, menu5.button2.actions.value0, menu5.button2.actions.symbol0);
-            bleKeyboardAction(menu5.button2.actions.action1, menu5.button2.actions.value1, menu5.button2.actions.symbol1);
-            bleKeyboardAction(menu5.button2.actions.action2, menu5.button2.actions.value2, menu5.button2.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu5.button2.latch)
-            {
-              if (islatched[22])
-              {
-                islatched[22] = 0;
-              }
-              else
-              {
-                islatched[22] = 1;
-              }
-            }
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(menu5.button3.actions.action0, menu5.button3.actions.value0, menu5.button3.actions.symbol0);
-            bleKeyboardAction(menu5.button3.actions.action1, menu5.button3.actions.value1, menu5.button3.actions.symbol1);
-            bleKeyboardAction(menu5.button3.actions.action2, menu5.button3.actions.value2, menu5.button3.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu5.button3.latch)
-            {
-              if (islatched[23])
-              {
-                islatched[23] = 0;
-              }
-              else
-              {
-                islatched[23] = 1;
-              }
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            bleKeyboardAction(menu5.button4.actions.action0, menu5.button4.actions.value0, menu5.button4.actions.symbol0);
-            bleKeyboardAction(menu5.button4.actions.action1, menu5.button4.actions.value1, menu5.button4.actions.symbol1);
-            bleKeyboardAction(menu5.button4.actions.action2, menu5.button4.actions.value2, menu5.button4.actions.symbol2);
-            bleKeyboard.releaseAll();
-            if (menu5.button4.latch)
-            {
-              if (islatched[24])
-              {
-                islatched[24] = 0;
-              }
-              else
-              {
-                islatched[24] = 1;
-              }
-            }
-          }
-          else if (b == 5) // Button 5 / Back home
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        else if (pageNum == 6) // Settings page
-        {
-          if (b == 0) // Button 0
-          {
-            bleKeyboardAction(11, 1, 0);
-          }
-          else if (b == 1) // Button 1
-          {
-            bleKeyboardAction(11, 2, 0);
-          }
-          else if (b == 2) // Button 2
-          {
-            bleKeyboardAction(11, 3, 0);
-          }
-          else if (b == 3) // Button 3
-          {
-            bleKeyboardAction(11, 4, 0);
-            if (islatched[28])
-            {
-              islatched[28] = 0;
-            }
-            else
-            {
-              islatched[28] = 1;
-            }
-          }
-          else if (b == 4) // Button 4
-          {
-            pageNum = 8;
-            drawKeypad();
-          }
-          else if (b == 5)
-          {
-            pageNum = 0;
-            drawKeypad();
-          }
-        }
-
-        delay(10); // UI debouncing
-      }
+/**
+* @brief This function handles an event sent to the UI task.
+*
+* @param event UiEvent
+*
+* @return none
+*
+* @note none
+*/
+void handleUiEvent(UiEvent &event)
+{
+  switch (event.type)
+  {
+  case UI_EVENT_TOUCH:
+    dispatchTouch(event.pressed, event.x, event.y);
+    break;
+  case UI_EVENT_PAGE:
+    // Switching pages is not possible while in config mode
+    if (pageNum != event.value && pageNum != PAGE_CONFIGMODE)
+    {
+      routerGo(event.value);
+      Serial.printf("Auto Switched to Menu %d\n", event.value);
+    }
+    break;
+  case UI_EVENT_SPECIAL:
+    bleKeyboardAction(11, event.value, 0);
+    break;
+  case UI_EVENT_SLEEP:
+#ifdef touchInterruptPin
+    if (standby())
+    {
+      // Back on the same page. The touch that woke us is not a button press.
+      ignoreTouch = true;
+      previousMillis = millis();
+    }
+    else
+    {
+      goToSleep();
+    }
+#endif // defined(touchInterruptPin)
+    break;
+  case UI_EVENT_OPEN:
+    if (isMenuPage(event.value) && pageNum != event.value && pageNum != PAGE_CONFIGMODE)
+    {
+      routerPush(event.value);
     }
+    break;
+  case UI_EVENT_TRIGGER:
+    bleControlTrigger(event.value);
+    break;
+  case UI_EVENT_CONFIG:
+    bleControlApplyPatches();
+    break;
+  case UI_EVENT_RELOAD:
+    configReload(event.value);
+    break;
+  case UI_EVENT_WIFI:
+    webhookStartWifi();
+    break;
+  case UI_EVENT_WIFIOFF:
+    webhookStopWifi();
+    break;
+  }
+}
+
+/**
+* @brief This function hands a touch sample to the active screen, unless it
+         belongs to the touch that woke us from standby or stopped a file
+         being typed.
+*
+* @param pressed bool whether the screen is touched
+* @param t_x uint16_t
+* @param t_y uint16_t
+*
+* @return none
+*
+* @note none
+*/
+void dispatchTouch(bool pressed, uint16_t t_x, uint16_t t_y)
+{
+  static bool wasPressed = false;
+  bool newTouch = pressed && !wasPressed;
+  wasPressed = pressed;
+
+  if (newTouch && hidTypingFile)
+  {
+    // Typing a long file is stopped by touching the screen anywhere
+    cancelActions();
+    ignoreTouch = true;
   }
+
+  if (ignoreTouch)
+  {
+    // Wait for the finger to be lifted
+    ignoreTouch = pressed;
+    return;
+  }
+  routerTouch(pressed, t_x, t_y);
+}
+
+/**
+* @brief This function puts FreeTouchDeck in deep sleep. It saves the latched
+         states first, we wake up on a touch.
+*
+* @param none
+*
+* @return none
+*
+* @note Does not return.
+*/
+void goToSleep()
+{
+#ifdef touchInterruptPin
+  tft.fillScreen(TFT_BLACK);
+  Serial.println("[INFO]: Going to sleep.");
+#ifdef speakerPin
+  if (generalconfig.beep)
+  {
+    ledcAttachPin(speakerPin, 2);
+    ledcWriteTone(2, 1200);
+    delay(150);
+    ledcDetachPin(speakerPin);
+    ledcWrite(2, 0);
+
+    ledcAttachPin(speakerPin, 2);
+    ledcWriteTone(2, 800);
+    delay(150);
+    ledcDetachPin(speakerPin);
+    ledcWrite(2, 0);
+
+    ledcAttachPin(speakerPin, 2);
+    ledcWriteTone(2, 600);
+    delay(150);
+    ledcDetachPin(speakerPin);
+    ledcWrite(2, 0);
+  }
+#endif // defined(speakerPin)
+  Serial.println("[INFO]: Saving latched states");
+
+  saveLatchStates();
+  snapshotSave();
+  esp_sleep_enable_ext0_wakeup(touchInterruptPin, 0);
+  esp_deep_sleep_start();
+#endif // defined(touchInterruptPin)
 }
+
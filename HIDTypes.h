@@ -27,12 +27,16 @@ typedef struct {
   uint8_t keys[6];
 } KeyReport;
 
+// NKRO report (17 bytes: modifiers + a bit for each of the usages 0 to 127)
+#define NKRO_KEY_BYTES 16
+typedef struct {
+  uint8_t modifiers;
+  uint8_t keys[NKRO_KEY_BYTES];
+} NkroReport;
+
 // Media key report (2 bytes)
 typedef uint8_t MediaKeyReport[2];
 
-// ASCII map for keyboard (from Arduino Keyboard library)
-extern const uint8_t _asciimap[128] PROGMEM;
-
 // Modifier keys
 #define KEY_LEFT_CTRL   0x80
 #define KEY_LEFT_SHIFT  0x81
@@ -0,0 +1,571 @@
+#pragma once
+/*
+ * Keyboard layouts: which key (and modifiers) types each ASCII character on a
+ * host with that layout. Selected with BleKeyboard::setLayout(), e.g. from the
+ * "keyboardlayout" setting in general.json.
+ *
+ * Each entry has the HID usage in the low byte and the LAYOUT_ flags in the
+ * high byte. 0 means the character can not be typed. The tables are constexpr,
+ * so they live in flash and can be included anywhere that has <stdint.h>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define LAYOUT_SHIFT 0x0100 // Hold shift
+#define LAYOUT_ALTGR 0x0200 // Hold AltGr (right alt)
+#define LAYOUT_DEAD 0x0400  // Dead key: a space follows so the character itself is typed
+
+// US (QWERTY)
+constexpr uint16_t layout_us[128] = {
+  0x00, // NUL
+  0x00, // SOH
+  0x00, // STX
+  0x00, // ETX
+  0x00, // EOT
+  0x00, // ENQ
+  0x00, // ACK
+  0x00, // BEL
+  0x2a, // BS
+  0x2b, // TAB
+  0x28, // LF
+  0x00, // VT
+  0x00, // FF
+  0x00, // CR
+  0x00, // SO
+  0x00, // SI
+  0x00, // DLE
+  0x00, // DC1
+  0x00, // DC2
+  0x00, // DC3
+  0x00, // DC4
+  0x00, // NAK
+  0x00, // SYN
+  0x00, // ETB
+  0x00, // CAN
+  0x00, // EM
+  0x00, // SUB
+  0x00, // ESC
+  0x00, // FS
+  0x00, // GS
+  0x00, // RS
+  0x00, // US
+  0x2c, // ' '
+  0x1e|LAYOUT_SHIFT, // !
+  0x34|LAYOUT_SHIFT, // "
+  0x20|LAYOUT_SHIFT, // #
+  0x21|LAYOUT_SHIFT, // $
+  0x22|LAYOUT_SHIFT, // %
+  0x24|LAYOUT_SHIFT, // &
+  0x34, // '
+  0x26|LAYOUT_SHIFT, // (
+  0x27|LAYOUT_SHIFT, // )
+  0x25|LAYOUT_SHIFT, // *
+  0x2e|LAYOUT_SHIFT, // +
+  0x36, // ,
+  0x2d, // -
+  0x37, // .
+  0x38, // /
+  0x27, // 0
+  0x1e, // 1
+  0x1f, // 2
+  0x20, // 3
+  0x21, // 4
+  0x22, // 5
+  0x23, // 6
+  0x24, // 7
+  0x25, // 8
+  0x26, // 9
+  0x33|LAYOUT_SHIFT, // :
+  0x33, // ;
+  0x36|LAYOUT_SHIFT, // <
+  0x2e, // =
+  0x37|LAYOUT_SHIFT, // >
+  0x38|LAYOUT_SHIFT, // ?
+  0x1f|LAYOUT_SHIFT, // @
+  0x04|LAYOUT_SHIFT, // A
+  0x05|LAYOUT_SHIFT, // B
+  0x06|LAYOUT_SHIFT, // C
+  0x07|LAYOUT_SHIFT, // D
+  0x08|LAYOUT_SHIFT, // E
+  0x09|LAYOUT_SHIFT, // F
+  0x0a|LAYOUT_SHIFT, // G
+  0x0b|LAYOUT_SHIFT, // H
+  0x0c|LAYOUT_SHIFT, // I
+  0x0d|LAYOUT_SHIFT, // J
+  0x0e|LAYOUT_SHIFT, // K
+  0x0f|LAYOUT_SHIFT, // L
+  0x10|LAYOUT_SHIFT, // M
+  0x11|LAYOUT_SHIFT, // N
+  0x12|LAYOUT_SHIFT, // O
+  0x13|LAYOUT_SHIFT, // P
+  0x14|LAYOUT_SHIFT, // Q
+  0x15|LAYOUT_SHIFT, // R
+  0x16|LAYOUT_SHIFT, // S
+  0x17|LAYOUT_SHIFT, // T
+  0x18|LAYOUT_SHIFT, // U
+  0x19|LAYOUT_SHIFT, // V
+  0x1a|LAYOUT_SHIFT, // W
+  0x1b|LAYOUT_SHIFT, // X
+  0x1c|LAYOUT_SHIFT, // Y
+  0x1d|LAYOUT_SHIFT, // Z
+  0x2f, // [
+  0x31, // bslash
+  0x30, // ]
+  0x23|LAYOUT_SHIFT, // ^
+  0x2d|LAYOUT_SHIFT, // _
+  0x35, // `
+  0x04, // a
+  0x05, // b
+  0x06, // c
+  0x07, // d
+  0x08, // e
+  0x09, // f
+  0x0a, // g
+  0x0b, // h
+  0x0c, // i
+  0x0d, // j
+  0x0e, // k
+  0x0f, // l
+  0x10, // m
+  0x11, // n
+  0x12, // o
+  0x13, // p
+  0x14, // q
+  0x15, // r
+  0x16, // s
+  0x17, // t
+  0x18, // u
+  0x19, // v
+  0x1a, // w
+  0x1b, // x
+  0x1c, // y
+  0x1d, // z
+  0x2f|LAYOUT_SHIFT, // {
+  0x31|LAYOUT_SHIFT, // |
+  0x30|LAYOUT_SHIFT, // }
+  0x35|LAYOUT_SHIFT, // ~
+  0x00, // DEL
+};
+
+// UK (QWERTY, ISO)
+constexpr uint16_t layout_uk[128] = {
+  0x00, // NUL
+  0x00, // SOH
+  0x00, // STX
+  0x00, // ETX
+  0x00, // EOT
+  0x00, // ENQ
+  0x00, // ACK
+  0x00, // BEL
+  0x2a, // BS
+  0x2b, // TAB
+  0x28, // LF
+  0x00, // VT
+  0x00, // FF
+  0x00, // CR
+  0x00, // SO
+  0x00, // SI
+  0x00, // DLE
+  0x00, // DC1
+  0x00, // DC2
+  0x00, // DC3
+  0x00, // DC4
+  0x00, // NAK
+  0x00, // SYN
+  0x00, // ETB
+  0x00, // CAN
+  0x00, // EM
+  0x00, // SUB
+  0x00, // ESC
+  0x00, // FS
+  0x00, // GS
+  0x00, // RS
+  0x00, // US
+  0x2c, // ' '
+  0x1e|LAYOUT_SHIFT, // !
+  0x1f|LAYOUT_SHIFT, // "
+  0x32, // #
+  0x21|LAYOUT_SHIFT, // $
+  0x22|LAYOUT_SHIFT, // %
+  0x24|LAYOUT_SHIFT, // &
+  0x34, // '
+  0x26|LAYOUT_SHIFT, // (
+  0x27|LAYOUT_SHIFT, // )
+  0x25|LAYOUT_SHIFT, // *
+  0x2e|LAYOUT_SHIFT, // +
+  0x36, // ,
+  0x2d, // -
+  0x37, // .
+  0x38, // /
+  0x27, // 0
+  0x1e, // 1
+  0x1f, // 2
+  0x20, // 3
+  0x21, // 4
+  0x22, // 5
+  0x23, // 6
+  0x24, // 7
+  0x25, // 8
+  0x26, // 9
+  0x33|LAYOUT_SHIFT, // :
+  0x33, // ;
+  0x36|LAYOUT_SHIFT, // <
+  0x2e, // =
+  0x37|LAYOUT_SHIFT, // >
+  0x38|LAYOUT_SHIFT, // ?
+  0x34|LAYOUT_SHIFT, // @
+  0x04|LAYOUT_SHIFT, // A
+  0x05|LAYOUT_SHIFT, // B
+  0x06|LAYOUT_SHIFT, // C
+  0x07|LAYOUT_SHIFT, // D
+  0x08|LAYOUT_SHIFT, // E
+  0x09|LAYOUT_SHIFT, // F
+  0x0a|LAYOUT_SHIFT, // G
+  0x0b|LAYOUT_SHIFT, // H
+  0x0c|LAYOUT_SHIFT, // I
+  0x0d|LAYOUT_SHIFT, // J
+  0x0e|LAYOUT_SHIFT, // K
+  0x0f|LAYOUT_SHIFT, // L
+  0x10|LAYOUT_SHIFT, // M
+  0x11|LAYOUT_SHIFT, // N
+  0x12|LAYOUT_SHIFT, // O
+  0x13|LAYOUT_SHIFT, // P
+  0x14|LAYOUT_SHIFT, // Q
+  0x15|LAYOUT_SHIFT, // R
+  0x16|LAYOUT_SHIFT, // S
+  0x17|LAYOUT_SHIFT, // T
+  0x18|LAYOUT_SHIFT, // U
+  0x19|LAYOUT_SHIFT, // V
+  0x1a|LAYOUT_SHIFT, // W
+  0x1b|LAYOUT_SHIFT, // X
+  0x1c|LAYOUT_SHIFT, // Y
+  0x1d|LAYOUT_SHIFT, // Z
+  0x2f, // [
+  0x64, // bslash
+  0x30, // ]
+  0x23|LAYOUT_SHIFT, // ^
+  0x2d|LAYOUT_SHIFT, // _
+  0x35, // `
+  0x04, // a
+  0x05, // b
+  0x06, // c
+  0x07, // d
+  0x08, // e
+  0x09, // f
+  0x0a, // g
+  0x0b, // h
+  0x0c, // i
+  0x0d, // j
+  0x0e, // k
+  0x0f, // l
+  0x10, // m
+  0x11, // n
+  0x12, // o
+  0x13, // p
+  0x14, // q
+  0x15, // r
+  0x16, // s
+  0x17, // t
+  0x18, // u
+  0x19, // v
+  0x1a, // w
+  0x1b, // x
+  0x1c, // y
+  0x1d, // z
+  0x2f|LAYOUT_SHIFT, // {
+  0x64|LAYOUT_SHIFT, // |
+  0x30|LAYOUT_SHIFT, // }
+  0x32|LAYOUT_SHIFT, // ~
+  0x00, // DEL
+};
+
+// German (QWERTZ)
+constexpr uint16_t layout_de[128] = {
+  0x00, // NUL
+  0x00, // SOH
+  0x00, // STX
+  0x00, // ETX
+  0x00, // EOT
+  0x00, // ENQ
+  0x00, // ACK
+  0x00, // BEL
+  0x2a, // BS
+  0x2b, // TAB
+  0x28, // LF
+  0x00, // VT
+  0x00, // FF
+  0x00, // CR
+  0x00, // SO
+  0x00, // SI
+  0x00, // DLE
+  0x00, // DC1
+  0x00, // DC2
+  0x00, // DC3
+  0x00, // DC4
+  0x00, // NAK
+  0x00, // SYN
+  0x00, // ETB
+  0x00, // CAN
+  0x00, // EM
+  0x00, // SUB
+  0x00, // ESC
+  0x00, // FS
+  0x00, // GS
+  0x00, // RS
+  0x00, // US
+  0x2c, // ' '
+  0x1e|LAYOUT_SHIFT, // !
+  0x1f|LAYOUT_SHIFT, // "
+  0x32, // #
+  0x21|LAYOUT_SHIFT, // $
+  0x22|LAYOUT_SHIFT, // %
+  0x23|LAYOUT_SHIFT, // &
+  0x32|LAYOUT_SHIFT, // '
+  0x25|LAYOUT_SHIFT, // (
+  0x26|LAYOUT_SHIFT, // )
+  0x30|LAYOUT_SHIFT, // *
+  0x30, // +
+  0x36, // ,
+  0x38, // -
+  0x37, // .
+  0x24|LAYOUT_SHIFT, // /
+  0x27, // 0
+  0x1e, // 1
+  0x1f, // 2
+  0x20, // 3
+  0x21, // 4
+  0x22, // 5
+  0x23, // 6
+  0x24, // 7
+  0x25, // 8
+  0x26, // 9
+  0x37|LAYOUT_SHIFT, // :
+  0x36|LAYOUT_SHIFT, // ;
+  0x64, // <
+  0x27|LAYOUT_SHIFT, // =
+  0x64|LAYOUT_SHIFT, // >
+  0x2d|LAYOUT_SHIFT, // ?
+  0x14|LAYOUT_ALTGR, // @
+  0x04|LAYOUT_SHIFT, // A
+  0x05|LAYOUT_SHIFT, // B
+  0x06|LAYOUT_SHIFT, // C
+  0x07|LAYOUT_SHIFT, // D
+  0x08|LAYOUT_SHIFT, // E
+  0x09|LAYOUT_SHIFT, // F
+  0x0a|LAYOUT_SHIFT, // G
+  0x0b|LAYOUT_SHIFT, // H
+  0x0c|LAYOUT_SHIFT, // I
+  0x0d|LAYOUT_SHIFT, // J
+  0x0e|LAYOUT_SHIFT, // K
+  0x0f|LAYOUT_SHIFT, // L
+  0x10|LAYOUT_SHIFT, // M
+  0x11|LAYOUT_SHIFT, // N
+  0x12|LAYOUT_SHIFT, // O
+  0x13|LAYOUT_SHIFT, // P
+  0x14|LAYOUT_SHIFT, // Q
+  0x15|LAYOUT_SHIFT, // R
+  0x16|LAYOUT_SHIFT, // S
+  0x17|LAYOUT_SHIFT, // T
+  0x18|LAYOUT_SHIFT, // U
+  0x19|LAYOUT_SHIFT, // V
+  0x1a|LAYOUT_SHIFT, // W
+  0x1b|LAYOUT_SHIFT, // X
+  0x1d|LAYOUT_SHIFT, // Y
+  0x1c|LAYOUT_SHIFT, // Z
+  0x25|LAYOUT_ALTGR, // [
+  0x2d|LAYOUT_ALTGR, // bslash
+  0x26|LAYOUT_ALTGR, // ]
+  0x35|LAYOUT_DEAD, // ^
+  0x38|LAYOUT_SHIFT, // _
+  0x2e|LAYOUT_SHIFT|LAYOUT_DEAD, // `
+  0x04, // a
+  0x05, // b
+  0x06, // c
+  0x07, // d
+  0x08, // e
+  0x09, // f
+  0x0a, // g
+  0x0b, // h
+  0x0c, // i
+  0x0d, // j
+  0x0e, // k
+  0x0f, // l
+  0x10, // m
+  0x11, // n
+  0x12, // o
+  0x13, // p
+  0x14, // q
+  0x15, // r
+  0x16, // s
+  0x17, // t
+  0x18, // u
+  0x19, // v
+  0x1a, // w
+  0x1b, // x
+  0x1d, // y
+  0x1c, // z
+  0x24|LAYOUT_ALTGR, // {
+  0x64|LAYOUT_ALTGR, // |
+  0x27|LAYOUT_ALTGR, // }
+  0x30|LAYOUT_ALTGR, // ~
+  0x00, // DEL
+};
+
+// French (AZERTY)
+constexpr uint16_t layout_fr[128] = {
+  0x00, // NUL
+  0x00, // SOH
+  0x00, // STX
+  0x00, // ETX
+  0x00, // EOT
+  0x00, // ENQ
+  0x00, // ACK
+  0x00, // BEL
+  0x2a, // BS
+  0x2b, // TAB
+  0x28, // LF
+  0x00, // VT
+  0x00, // FF
+  0x00, // CR
+  0x00, // SO
+  0x00, // SI
+  0x00, // DLE
+  0x00, // DC1
+  0x00, // DC2
+  0x00, // DC3
+  0x00, // DC4
+  0x00, // NAK
+  0x00, // SYN
+  0x00, // ETB
+  0x00, // CAN
+  0x00, // EM
+  0x00, // SUB
+  0x00, // ESC
+  0x00, // FS
+  0x00, // GS
+  0x00, // RS
+  0x00, // US
+  0x2c, // ' '
+  0x38, // !
+  0x20, // "
+  0x20|LAYOUT_ALTGR, // #
+  0x30, // $
+  0x34|LAYOUT_SHIFT, // %
+  0x1e, // &
+  0x21, // '
+  0x22, // (
+  0x2d, // )
+  0x32, // *
+  0x2e|LAYOUT_SHIFT, // +
+  0x10, // ,
+  0x23, // -
+  0x36|LAYOUT_SHIFT, // .
+  0x37|LAYOUT_SHIFT, // /
+  0x27|LAYOUT_SHIFT, // 0
+  0x1e|LAYOUT_SHIFT, // 1
+  0x1f|LAYOUT_SHIFT, // 2
+  0x20|LAYOUT_SHIFT, // 3
+  0x21|LAYOUT_SHIFT, // 4
+  0x22|LAYOUT_SHIFT, // 5
+  0x23|LAYOUT_SHIFT, // 6
+  0x24|LAYOUT_SHIFT, // 7
+  0x25|LAYOUT_SHIFT, // 8
+  0x26|LAYOUT_SHIFT, // 9
+  0x37, // :
+  0x36, // ;
+  0x64, // <
+  0x2e, // =
+  0x64|LAYOUT_SHIFT, // >
+  0x10|LAYOUT_SHIFT, // ?
+  0x27|LAYOUT_ALTGR, // @
+  0x14|LAYOUT_SHIFT, // A
+  0x05|LAYOUT_SHIFT, // B
+  0x06|LAYOUT_SHIFT, // C
+  0x07|LAYOUT_SHIFT, // D
+  0x08|LAYOUT_SHIFT, // E
+  0x09|LAYOUT_SHIFT, // F
+  0x0a|LAYOUT_SHIFT, // G
+  0x0b|LAYOUT_SHIFT, // H
+  0x0c|LAYOUT_SHIFT, // I
+  0x0d|LAYOUT_SHIFT, // J
+  0x0e|LAYOUT_SHIFT, // K
+  0x0f|LAYOUT_SHIFT, // L
+  0x33|LAYOUT_SHIFT, // M
+  0x11|LAYOUT_SHIFT, // N
+  0x12|LAYOUT_SHIFT, // O
+  0x13|LAYOUT_SHIFT, // P
+  0x04|LAYOUT_SHIFT, // Q
+  0x15|LAYOUT_SHIFT, // R
+  0x16|LAYOUT_SHIFT, // S
+  0x17|LAYOUT_SHIFT, // T
+  0x18|LAYOUT_SHIFT, // U
+  0x19|LAYOUT_SHIFT, // V
+  0x1d|LAYOUT_SHIFT, // W
+  0x1b|LAYOUT_SHIFT, // X
+  0x1c|LAYOUT_SHIFT, // Y
+  0x1a|LAYOUT_SHIFT, // Z
+  0x22|LAYOUT_ALTGR, // [
+  0x25|LAYOUT_ALTGR, // bslash
+  0x2d|LAYOUT_ALTGR, // ]
+  0x26|LAYOUT_ALTGR, // ^
+  0x25, // _
+  0x24|LAYOUT_ALTGR|LAYOUT_DEAD, // `
+  0x14, // a
+  0x05, // b
+  0x06, // c
+  0x07, // d
+  0x08, // e
+  0x09, // f
+  0x0a, // g
+  0x0b, // h
+  0x0c, // i
+  0x0d, // j
+  0x0e, // k
+  0x0f, // l
+  0x33, // m
+  0x11, // n
+  0x12, // o
+  0x13, // p
+  0x04, // q
+  0x15, // r
+  0x16, // s
+  0x17, // t
+  0x18, // u
+  0x19, // v
+  0x1d, // w
+  0x1b, // x
+  0x1c, // y
+  0x1a, // z
+  0x21|LAYOUT_ALTGR, // {
+  0x23|LAYOUT_ALTGR, // |
+  0x2e|LAYOUT_ALTGR, // }
+  0x1f|LAYOUT_ALTGR|LAYOUT_DEAD, // ~
+  0x00, // DEL
+};
+
+struct KeyLayout
+{
+  const char *name;
+  const uint16_t *map;
+};
+
+constexpr KeyLayout keyLayouts[] = {
+    {"us", layout_us},
+    {"uk", layout_uk},
+    {"de", layout_de},
+    {"fr", layout_fr}};
+
+// Returns the layout with this name, or nullptr
+inline const uint16_t *findKeyLayout(const char *name)
+{
+  for (const KeyLayout &layout : keyLayouts) {
+    if (strcmp(layout.name, name) == 0) return layout.map;
+  }
+  return nullptr;
+}
+
+static_assert(layout_us['a'] == 0x04 && layout_de['z'] == 0x1c && layout_fr['a'] == 0x14,
+              "Letters follow the layout");
+static_assert(layout_de['@'] == (0x14 | LAYOUT_ALTGR) && layout_fr['~'] == (0x1f | LAYOUT_ALTGR | LAYOUT_DEAD),
+              "AltGr and dead keys are flagged");
@@ -0,0 +1,98 @@
+/*
+ * Keycode tables for the actions in Action.h.
+ *
+ * The value of an action is an index into one of these tables (value 1 is the
+ * first entry, except for the numpad which starts at 0). They are constexpr, so
+ * they live in flash and only need the KEY_ defines, which keeps them usable
+ * outside the sketch as well.
+ */
+
+// Action 2: Send TAB ARROW etc
+constexpr uint8_t navigationKeys[] = {
+    KEY_UP_ARROW, KEY_DOWN_ARROW, KEY_LEFT_ARROW, KEY_RIGHT_ARROW,
+    KEY_BACKSPACE, KEY_TAB, KEY_RETURN, KEY_PAGE_UP,
+    KEY_PAGE_DOWN, KEY_DELETE, KEY_PRTSC, KEY_ESC,
+    KEY_HOME, KEY_END};
+
+// Action 5: Option Keys. Value 9 is "Release All".
+constexpr uint8_t modifierKeys[] = {
+    KEY_LEFT_CTRL, KEY_LEFT_SHIFT, KEY_LEFT_ALT, KEY_LEFT_GUI,
+    KEY_RIGHT_CTRL, KEY_RIGHT_SHIFT, KEY_RIGHT_ALT, KEY_RIGHT_GUI};
+
+#define MODIFIER_RELEASE_ALL 9
+
+// Action 6: Function Keys. Action 10 (Helpers) uses the first HELPER_COUNT.
+constexpr uint8_t functionKeys[] = {
+    KEY_F1, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6,
+    KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12,
+    KEY_F13, KEY_F14, KEY_F15, KEY_F16, KEY_F17, KEY_F18,
+    KEY_F19, KEY_F20, KEY_F21, KEY_F22, KEY_F23, KEY_F24};
+
+#define HELPER_COUNT 11
+
+// Action 9: Combos, unused keys are 0
+constexpr uint8_t comboKeys[][3] = {
+    {KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 0},
+    {KEY_LEFT_ALT, KEY_LEFT_SHIFT, 0},
+    {KEY_LEFT_GUI, KEY_LEFT_SHIFT, 0},
+    {KEY_LEFT_CTRL, KEY_LEFT_GUI, 0},
+    {KEY_LEFT_ALT, KEY_LEFT_GUI, 0},
+    {KEY_LEFT_CTRL, KEY_LEFT_ALT, 0},
+    {KEY_LEFT_CTRL, KEY_LEFT_ALT, KEY_LEFT_GUI},
+    {KEY_RIGHT_CTRL, KEY_RIGHT_SHIFT, 0},
+    {KEY_RIGHT_ALT, KEY_RIGHT_SHIFT, 0},
+    {KEY_RIGHT_GUI, KEY_RIGHT_SHIFT, 0},
+    {KEY_RIGHT_CTRL, KEY_RIGHT_GUI, 0},
+    {KEY_RIGHT_ALT, KEY_RIGHT_GUI, 0},
+    {KEY_RIGHT_CTRL, KEY_RIGHT_ALT, 0},
+    {KEY_RIGHT_CTRL, KEY_RIGHT_ALT, KEY_RIGHT_GUI}};
+
+// Action 12: Numpad, value 0 is Numpad 0
+constexpr uint8_t numpadKeys[] = {
+    KEY_NUM_0, KEY_NUM_1, KEY_NUM_2, KEY_NUM_3, KEY_NUM_4,
+    KEY_NUM_5, KEY_NUM_6, KEY_NUM_7, KEY_NUM_8, KEY_NUM_9,
+    KEY_NUM_SLASH, KEY_NUM_ASTERISK, KEY_NUM_MINUS, KEY_NUM_PLUS,
+    KEY_NUM_ENTER, KEY_NUM_PERIOD};
+
+// Action 3: Send Media Key
+constexpr const uint8_t *mediaKeys[] = {
+    KEY_MEDIA_MUTE, KEY_MEDIA_VOLUME_DOWN, KEY_MEDIA_VOLUME_UP,
+    KEY_MEDIA_PLAY_PAUSE, KEY_MEDIA_STOP, KEY_MEDIA_NEXT_TRACK,
+    KEY_MEDIA_PREVIOUS_TRACK};
+
+/**
+* @brief This function returns an entry of a key table.
+*
+* @param table the table
+* @param index int
+*
+* @return The entry, or 0 (no key) if index is outside the table.
+*
+* @note none
+*/
+template <typename T, size_t N>
+constexpr T tableKey(const T (&table)[N], int index)
+{
+  return index >= 0 && index < (int)N ? table[index] : T();
+}
+
+/**
+* @brief This function returns a row of a combo table.
+*
+* @param table the table
+* @param index int
+*
+* @return The row, or nullptr if index is outside the table.
+*
+* @note none
+*/
+template <size_t N, size_t M>
+constexpr const uint8_t *tableRow(const uint8_t (&table)[N][M], int index)
+{
+  return index >= 0 && index < (int)N ? table[index] : nullptr;
+}
+
+static_assert(sizeof(navigationKeys) == 14, "Action 2 has 14 keys");
+static_assert(sizeof(functionKeys) == 24 && HELPER_COUNT <= sizeof(functionKeys), "Action 6 has F1 to F24");
+static_assert(sizeof(numpadKeys) == 16, "Action 12 has 16 keys");
+static_assert(tableKey(functionKeys, 23) == KEY_F24 && tableKey(functionKeys, 24) == 0, "Lookups are bounds checked");
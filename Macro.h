@@ -0,0 +1,927 @@
+/*
+ * Button macros as bytecode.
+ *
+ * The actions of the menu buttons are compiled into a compact bytecode when a
+ * menu config is saved, and stored next to it as /config/menuX.ftm. If that file
+ * is missing or was compiled from another version of the JSON, loading the menu
+ * compiles it again. The buttons in RAM only keep their press mode and latch.
+ *
+ * The HID task runs a macro by streaming it from the file through the small
+ * interpreter at the bottom of this file, so a macro can have any number of steps.
+ * The short macro of a held hold-to-repeat button is repeated from RAM.
+ *
+ * File layout: a MacroHeader with an offset and length for every button and
+ * press (button 0 short, button 0 long, button 1 short, ...), then the code.
+ */
+
+#include <vector>
+
+#define MACRO_MAGIC 0x334D5446 // "FTM3"
+
+// A short and a long press macro for each menu button
+#define MACRO_SLOTS ((BUTTONS_PER_PAGE - 1) * 2)
+
+// How deep loops can be nested
+#define MACRO_LOOP_DEPTH 4
+
+// How many bytes of a macro are read from the file at a time
+#define MACRO_READ_BUFFER 64
+
+// The longest macro of a hold-to-repeat button that is kept in RAM while the
+// button is held. Longer ones are read from the file on every repeat.
+#define MACRO_CACHE_SIZE 256
+
+// Text is typed this many characters at a time, a cancel stops between chunks
+#define TEXT_CHUNK 32
+
+// The longest file name a macro can type from /uploads (SPIFFS paths are max 31)
+#define MACRO_FILENAME_MAX 22
+
+// The most keys in a chord. The boot key report holds 6 keys and the
+// modifiers, the NKRO report any number of keys.
+#define MACRO_CHORD_MAX 16
+
+// Opcodes, followed by their operands
+#define OP_END 0x00     // End of the macro
+#define OP_DOWN 0x01    // key: press and hold a key
+#define OP_UP 0x02      // key: release a key
+#define OP_TAP 0x03     // key: press and release a key
+#define OP_CHORD 0x04   // count, keys: press all keys, then release them all
+#define OP_TEXT 0x05    // length (16 bit), characters: type text
+#define OP_WAIT 0x06    // ms (16 bit): wait, can be cancelled
+#define OP_LOOP 0x07    // count (16 bit): run the steps up to the matching OP_NEXT count times
+#define OP_NEXT 0x08    // End of a loop
+#define OP_PAGE 0x09    // page: open a page on top of the current one
+#define OP_RELEASE 0x0A // Release all keys
+#define OP_ACTION 0x0B  // action, value (16 bit): any other action from Action.h
+#define OP_FILE 0x0C    // length, name: type the contents of a file in /uploads
+#define OP_HTTP 0x0D    // length, name: send the HTTP request in a file in /uploads, see Webhook.h
+
+struct MacroEntry
+{
+  uint32_t offset; // From the start of the code
+  uint32_t length;
+};
+
+struct MacroHeader
+{
+  uint32_t magic;
+  uint32_t sourcecrc; // CRC32 of the menuX.json it was compiled from
+  MacroEntry entry[MACRO_SLOTS];
+};
+
+void bleKeyboardAction(int action, int value, const char *symbol); // Action.h
+void pressKeys(const uint8_t *keys, size_t count);                 // Action.h
+bool webhookQueue(const char *name);                               // Webhook.h
+
+// The button whose macro the HID task is running
+int16_t macroPage = 0;
+uint8_t macroButton = 0;
+
+// The macro of the held hold-to-repeat button, loaded by its first run so the
+// repeats do not open the file. Only the HID task fills it.
+struct MacroCache
+{
+  int16_t page;
+  uint8_t slot;
+  uint16_t length;
+  volatile bool valid;
+  uint8_t code[MACRO_CACHE_SIZE];
+};
+
+MacroCache macroCache = {0, 0, 0, false, {}};
+
+/**
+* @brief This function drops the macro kept for the held repeat button.
+*
+* @param none
+*
+* @return none
+*
+* @note Safe to call from any task. A repeat that is running finishes from
+*       the cache, the next one reads the file.
+*/
+void macroCacheDrop()
+{
+  macroCache.valid = false;
+}
+
+/**
+* @brief This function returns the name of the compiled macro file of a menu.
+*
+* @param page int
+* @param filename char * buffer of at least 24 characters
+*
+* @return none
+*
+* @note none
+*/
+void macroFilename(int page, char *filename)
+{
+  snprintf(filename, 24, "/config/menu%d.ftm", page);
+}
+
+/**
+* @brief This function reads a key from a macro step. A key is a keycode
+*        (e.g. 128 for left ctrl) or a string with one character.
+*
+* @param key JsonVariant
+*
+* @return uint8_t
+*
+* @note none
+*/
+uint8_t macroKey(JsonVariant key)
+{
+  if (key.is<const char *>())
+  {
+    const char *str = key.as<const char *>();
+    if (strlen(str) == 1)
+    {
+      return str[0];
+    }
+  }
+  return key.as<int>();
+}
+
+/**
+* @brief This function adds text to a macro.
+*
+* @param code std::vector<uint8_t> &
+* @param text const char *
+*
+* @return none
+*
+* @note none
+*/
+void macroEmitText(std::vector<uint8_t> &code, const char *text)
+{
+  size_t length = strlen(text);
+  if (length > 0xFFFF)
+  {
+    length = 0xFFFF;
+  }
+  if (length == 0)
+  {
+    return;
+  }
+  code.push_back(OP_TEXT);
+  code.push_back(length & 0xFF);
+  code.push_back(length >> 8);
+  code.insert(code.end(), text, text + length);
+}
+
+/**
+* @brief This function adds typing a file from /uploads to a macro.
+*
+* @param code std::vector<uint8_t> &
+* @param name const char * the file name, without /uploads/
+* @param op uint8_t OP_FILE, or OP_HTTP to send the request in the file
+*
+* @return none
+*
+* @note none
+*/
+void macroEmitFile(std::vector<uint8_t> &code, const char *name, uint8_t op = OP_FILE)
+{
+  size_t length = strlen(name);
+  if (length == 0 || length > MACRO_FILENAME_MAX || strchr(name, '/'))
+  {
+    Serial.printf("[WARNING]: Invalid file name \"%s\" in macro, skipped.\n", name);
+    return;
+  }
+  code.push_back(op);
+  code.push_back(length);
+  code.insert(code.end(), name, name + length);
+}
+
+/**
+* @brief This function adds a wait to a macro.
+*
+* @param code std::vector<uint8_t> &
+* @param ms uint32_t
+*
+* @return none
+*
+* @note Waits longer than 65535 ms take more than one step.
+*/
+void macroEmitWait(std::vector<uint8_t> &code, uint32_t ms)
+{
+  while (ms > 0)
+  {
+    uint16_t step = ms > 0xFFFF ? 0xFFFF : ms;
+    code.push_back(OP_WAIT);
+    code.push_back(step & 0xFF);
+    code.push_back(step >> 8);
+    ms -= step;
+  }
+}
+
+/**
+* @brief This function adds one of the actions from Action.h to a macro.
+*
+* @param code std::vector<uint8_t> &
+* @param action int
+* @param value JsonVariant the value, or the symbol for action 4 and 8
+* @param where const char * e.g. "menu1 button2", for the warnings
+*
+* @return none
+*
+* @note Delays and text get their own opcode, the others run through
+*       bleKeyboardAction(). Values outside 0 to 65535 are skipped.
+*/
+void macroEmitAction(std::vector<uint8_t> &code, int action, JsonVariant value, const char *where)
+{
+  switch (action)
+  {
+  case 0: // No action
+    break;
+  case 1: // Delay
+    macroEmitWait(code, value.as<int>());
+    break;
+  case 4: // Send Character
+  case 8: // Send Special Character
+    macroEmitText(code, value | "");
+    break;
+  case 7: // Send Number
+    macroEmitText(code, String(value.as<int>()).c_str());
+    break;
+  case 15: // Type File
+    macroEmitFile(code, value | "");
+    break;
+  case 16: // HTTP request
+    macroEmitFile(code, value | "", OP_HTTP);
+    break;
+  default:
+    if (value.as<long>() < 0 || value.as<long>() > 0xFFFF)
+    {
+      Serial.printf("[WARNING]: Value %ld of action %d in %s is out of range, action skipped.\n", value.as<long>(),
+                    action, where);
+      break;
+    }
+    code.push_back(OP_ACTION);
+    code.push_back(action);
+    code.push_back(value.as<long>() & 0xFF);
+    code.push_back(value.as<long>() >> 8);
+    break;
+  }
+}
+
+/**
+* @brief This function adds the steps of a "macro" array to a macro.
+*
+* @param code std::vector<uint8_t> &
+* @param steps JsonArray
+* @param depth uint8_t how deep we are in loops
+* @param where const char * e.g. "menu1 button2", for the warnings
+*
+* @return none
+*
+* @note Unknown steps are skipped with a warning.
+*/
+void macroEmitSteps(std::vector<uint8_t> &code, JsonArray steps, uint8_t depth, const char *where)
+{
+  for (JsonObject step : steps)
+  {
+    if (step.containsKey("down"))
+    {
+      code.push_back(OP_DOWN);
+      code.push_back(macroKey(step["down"]));
+    }
+    else if (step.containsKey("up"))
+    {
+      code.push_back(OP_UP);
+      code.push_back(macroKey(step["up"]));
+    }
+    else if (step.containsKey("tap"))
+    {
+      code.push_back(OP_TAP);
+      code.push_back(macroKey(step["tap"]));
+    }
+    else if (step.containsKey("chord"))
+    {
+      JsonArray keys = step["chord"];
+      uint8_t count = keys.size() > MACRO_CHORD_MAX ? MACRO_CHORD_MAX : keys.size();
+      code.push_back(OP_CHORD);
+      code.push_back(count);
+      for (uint8_t i = 0; i < count; i++)
+      {
+        code.push_back(macroKey(keys[i]));
+      }
+    }
+    else if (step.containsKey("text"))
+    {
+      macroEmitText(code, step["text"] | "");
+    }
+    else if (step.containsKey("file"))
+    {
+      macroEmitFile(code, step["file"] | "");
+    }
+    else if (step.containsKey("http"))
+    {
+      macroEmitFile(code, step["http"] | "", OP_HTTP);
+    }
+    else if (step.containsKey("wait"))
+    {
+      macroEmitWait(code, step["wait"].as<uint32_t>());
+    }
+    else if (step.containsKey("loop"))
+    {
+      int count = step["loop"].as<int>();
+      if (depth >= MACRO_LOOP_DEPTH)
+      {
+        Serial.println("[WARNING]: Macro loops nested too deep, loop skipped.");
+        continue;
+      }
+      if (count <= 0)
+      {
+        continue;
+      }
+      if (count > 0xFFFF)
+      {
+        Serial.printf("[WARNING]: Macro loop count %d is too high, looping 65535 times.\n", count);
+        count = 0xFFFF;
+      }
+      code.push_back(OP_LOOP);
+      code.push_back(count & 0xFF);
+      code.push_back(count >> 8);
+      macroEmitSteps(code, step["steps"], depth + 1, where);
+      code.push_back(OP_NEXT);
+    }
+    else if (step.containsKey("page"))
+    {
+      code.push_back(OP_PAGE);
+      code.push_back(step["page"].as<int>());
+    }
+    else if (step.containsKey("release"))
+    {
+      code.push_back(OP_RELEASE);
+    }
+    else if (step.containsKey("action"))
+    {
+      macroEmitAction(code, step["action"].as<int>(), step["value"], where);
+    }
+    else
+    {
+      Serial.println("[WARNING]: Unknown macro step skipped.");
+    }
+  }
+}
+
+/**
+* @brief This function compiles the short or long press actions of a button.
+*
+* @param code std::vector<uint8_t> & the code is appended here
+* @param button JsonObject the "buttonX" object from a menu config
+* @param longpress bool
+* @param where const char * e.g. "menu1 button2", for the warnings
+*
+* @return none
+*
+* @note A "macro" ("longmacro") array is used if there is one, otherwise
+*       "actionarray" and "valuearray" ("longactionarray" and "longvaluearray").
+*/
+void macroCompileButton(std::vector<uint8_t> &code, JsonObject button, bool longpress, const char *where)
+{
+  JsonArray steps = button[longpress ? "longmacro" : "macro"];
+  if (!steps.isNull())
+  {
+    macroEmitSteps(code, steps, 0, where);
+  }
+  else
+  {
+    JsonArray actionarray = button[longpress ? "longactionarray" : "actionarray"];
+    JsonArray valuearray = button[longpress ? "longvaluearray" : "valuearray"];
+    for (size_t i = 0; i < actionarray.size(); i++)
+    {
+      macroEmitAction(code, actionarray[i].as<int>(), valuearray[i], where);
+    }
+  }
+  code.push_back(OP_END);
+}
+
+/**
+* @brief This function checks if the short or long press of a button is
+*        "Stop running actions".
+*
+* @param button JsonObject the "buttonX" object from a menu config
+* @param longpress bool
+*
+* @return bool
+*
+* @note Those buttons stop the running macro right away instead of being
+*       queued behind it, see queueMacro().
+*/
+bool macroStops(JsonObject button, bool longpress)
+{
+  JsonArray steps = button[longpress ? "longmacro" : "macro"];
+  if (!steps.isNull())
+  {
+    return steps[0]["action"].as<int>() == 11 && steps[0]["value"].as<int>() == 5;
+  }
+  return button[longpress ? "longactionarray" : "actionarray"][0].as<int>() == 11 &&
+         button[longpress ? "longvaluearray" : "valuearray"][0].as<int>() == 5;
+}
+
+/**
+* @brief This function compiles all buttons of a parsed menu config and
+*        writes the macro file.
+*
+* @param doc JsonDocument & the parsed menuX.json
+* @param page int
+* @param sourcecrc uint32_t CRC32 of menuX.json, see macroSourceCrc()
+*
+* @return True if the macro file was written. False otherwise.
+*
+* @note none
+*/
+bool macroCompile(JsonDocument &doc, int page, uint32_t sourcecrc)
+{
+  std::vector<uint8_t> code;
+  MacroHeader header = {MACRO_MAGIC, sourcecrc, {}};
+
+  for (int slot = 0; slot < MACRO_SLOTS; slot++)
+  {
+    char key[8];
+    char where[24];
+    snprintf(key, sizeof(key), "button%d", slot / 2);
+    snprintf(where, sizeof(where), "menu%d %s", page, key);
+    header.entry[slot].offset = code.size();
+    macroCompileButton(code, doc[key], slot % 2, where);
+    header.entry[slot].length = code.size() - header.entry[slot].offset;
+  }
+
+  // Written next to the old file and then swapped in, so a macro that is read
+  // meanwhile never sees a truncated file or new code under the old header
+  char filename[24];
+  char tmpname[24];
+  macroFilename(page, filename);
+  snprintf(tmpname, sizeof(tmpname), "/config/menu%d.tmp", page);
+  File file = FILESYSTEM.open(tmpname, "w");
+  if (!file)
+  {
+    Serial.printf("[WARNING]: Failed to create %s\n", tmpname);
+    return false;
+  }
+  bool written = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+                 file.write(code.data(), code.size()) == code.size();
+  file.close();
+
+  if (!written)
+  {
+    Serial.printf("[WARNING]: Failed to write %s\n", tmpname);
+    FILESYSTEM.remove(tmpname);
+    return false;
+  }
+  // SPIFFS does not rename over an existing file
+  macroCacheDrop();
+  FILESYSTEM.remove(filename);
+  if (!FILESYSTEM.rename(tmpname, filename))
+  {
+    Serial.printf("[WARNING]: Failed to rename %s to %s\n", tmpname, filename);
+    FILESYSTEM.remove(tmpname);
+    return false;
+  }
+  Serial.printf("[INFO]: Compiled %s, %u bytes of code\n", filename, code.size());
+  return true;
+}
+
+/**
+* @brief This function returns the CRC32 of a menu config file.
+*
+* @param filename const char * e.g. /config/menu1.json
+*
+* @return uint32_t or 0 if the file can not be opened
+*
+* @note Read in small chunks, the file can be larger than the stack.
+*/
+uint32_t macroSourceCrc(const char *filename)
+{
+  File file = FILESYSTEM.open(filename, "r");
+  if (!file)
+  {
+    return 0;
+  }
+  uint8_t buf[MACRO_READ_BUFFER];
+  uint32_t crc = 0;
+  size_t n;
+  while ((n = file.read(buf, sizeof(buf))) > 0)
+  {
+    crc = esp_rom_crc32_le(crc, buf, n);
+  }
+  file.close();
+  return crc;
+}
+
+/**
+* @brief This function compiles the macros of a menu from its config file.
+*
+* @param page int
+*
+* @return True if the macro file was written. False otherwise.
+*
+* @note Runs on the HID task, see queueCompile().
+*/
+bool macroCompileMenu(int page)
+{
+  char filename[24];
+  snprintf(filename, sizeof(filename), "/config/menu%d.json", page);
+  File configfile = FILESYSTEM.open(filename, "r");
+  if (!configfile)
+  {
+    Serial.printf("[WARNING]: %s not found!\n", filename);
+    return false;
+  }
+
+  DynamicJsonDocument doc(2048 + configfile.size() * 2);
+  DeserializationError error = deserializeJson(doc, configfile);
+  configfile.close();
+
+  if (error)
+  {
+    Serial.printf("[WARNING]: %s could not be compiled: %s\n", filename, error.c_str());
+    return false;
+  }
+  return macroCompile(doc, page, macroSourceCrc(filename));
+}
+
+/**
+* @brief This function checks if the macro file of a menu was compiled from
+*        its current config file.
+*
+* @param page int
+* @param sourcecrc uint32_t CRC32 of menuX.json, see macroSourceCrc()
+*
+* @return bool
+*
+* @note Any edit changes the CRC, also one that keeps the file size.
+*/
+bool macroUpToDate(int page, uint32_t sourcecrc)
+{
+  char filename[24];
+  macroFilename(page, filename);
+  File file = FILESYSTEM.open(filename, "r");
+  if (!file)
+  {
+    return false;
+  }
+  MacroHeader header;
+  bool uptodate = file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+                  header.magic == MACRO_MAGIC && header.sourcecrc == sourcecrc;
+  file.close();
+  return uptodate;
+}
+
+//--------------------- Interpreter ---------------------------------------------------------------
+
+/**
+* @brief This function types the contents of a file in /uploads.
+*
+* @param name const char * the file name, without /uploads/
+*
+* @return True if the whole file was typed. False if it was not found or
+*         typing was cancelled.
+*
+* @note The file is streamed TEXT_CHUNK characters at a time, so its size does
+*       not matter. Touching the screen stops it. Characters that are not on
+*       the keyboard layout (e.g. UTF-8) are skipped.
+*/
+bool typeFile(const char *name)
+{
+  char filename[40];
+  snprintf(filename, sizeof(filename), "/uploads/%s", name);
+  File file = FILESYSTEM.open(filename, "r");
+  if (!file || file.isDirectory())
+  {
+    Serial.printf("[WARNING]: %s not found!\n", filename);
+    return false;
+  }
+
+  Serial.printf("[INFO]: Typing %s (%u bytes)\n", filename, file.size());
+  hidTypingFile = true;
+
+  uint8_t chunk[TEXT_CHUNK];
+  size_t count;
+  uint32_t skipped = 0;
+  while (!hidCancelled() && (count = file.read(chunk, sizeof(chunk))) > 0)
+  {
+    bleKeyboard.writeText(chunk, count, &skipped);
+  }
+
+  hidTypingFile = false;
+  file.close();
+  if (skipped > 0)
+  {
+    Serial.printf("[WARNING]: Skipped %lu characters of %s that are not on the keyboard layout\n",
+                  (unsigned long)skipped, filename);
+  }
+  return !hidCancelled();
+}
+
+struct MacroReader
+{
+  File file;
+  const uint8_t *code; // The macro in RAM, or nullptr to read the file
+  uint32_t pos;        // Position of the next byte, in the file or in code
+  uint32_t end;        // Position after the macro
+  uint32_t bufstart;   // File position of buf[0]
+  uint16_t buflen;
+  uint8_t buf[MACRO_READ_BUFFER];
+};
+
+/**
+* @brief This function reads the next byte of a macro.
+*
+* @param reader MacroReader &
+* @param byte uint8_t & where to store it
+*
+* @return False at the end of the macro or on a read error.
+*
+* @note Jumping back for a loop only sets pos, the buffer is kept if the
+*       loop fits in it.
+*/
+bool macroRead(MacroReader &reader, uint8_t &byte)
+{
+  if (reader.pos >= reader.end)
+  {
+    return false;
+  }
+  if (reader.code != nullptr)
+  {
+    byte = reader.code[reader.pos++];
+    return true;
+  }
+  if (reader.pos < reader.bufstart || reader.pos >= reader.bufstart + reader.buflen)
+  {
+    uint32_t count = reader.end - reader.pos;
+    if (count > sizeof(reader.buf))
+    {
+      count = sizeof(reader.buf);
+    }
+    if (!reader.file.seek(reader.pos))
+    {
+      return false;
+    }
+    reader.bufstart = reader.pos;
+    reader.buflen = reader.file.read(reader.buf, count);
+    if (reader.buflen == 0)
+    {
+      return false;
+    }
+  }
+  byte = reader.buf[reader.pos++ - reader.bufstart];
+  return true;
+}
+
+/**
+* @brief This function reads a 16 bit operand of a macro.
+*
+* @param reader MacroReader &
+* @param value uint16_t & where to store it
+*
+* @return False at the end of the macro.
+*
+* @note none
+*/
+bool macroRead16(MacroReader &reader, uint16_t &value)
+{
+  uint8_t lo, hi;
+  if (!macroRead(reader, lo) || !macroRead(reader, hi))
+  {
+    return false;
+  }
+  value = lo | (hi << 8);
+  return true;
+}
+
+/**
+* @brief This function opens a macro file for reading one of its macros.
+*
+* @param reader MacroReader &
+* @param filename const char *
+* @param slot uint8_t button * 2, plus 1 for the long press
+*
+* @return False if the file is missing or not a macro file.
+*
+* @note none
+*/
+bool macroOpen(MacroReader &reader, const char *filename, uint8_t slot)
+{
+  reader.file = FILESYSTEM.open(filename, "r");
+  if (!reader.file)
+  {
+    Serial.printf("[WARNING]: %s not found!\n", filename);
+    return false;
+  }
+
+  MacroHeader header;
+  if (slot >= MACRO_SLOTS || reader.file.read((uint8_t *)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != MACRO_MAGIC)
+  {
+    Serial.printf("[WARNING]: %s is not a valid macro file\n", filename);
+    reader.file.close();
+    return false;
+  }
+
+  reader.pos = sizeof(header) + header.entry[slot].offset;
+  reader.end = reader.pos + header.entry[slot].length;
+  return true;
+}
+
+/**
+* @brief This function runs the short or long press macro of a menu button
+*        and then releases all keys.
+*
+* @param page int16_t the menu
+* @param slot uint8_t button * 2, plus 1 for the long press
+* @param repeat bool the button is a hold-to-repeat button
+*
+* @return none
+*
+* @note Runs on the HID task. Stops early if cancelActions() is called. The
+*       macro of a repeat button is kept in macroCache until pressCancel() or
+*       the release of the button, and repeated from there.
+*/
+void macroRun(int16_t page, uint8_t slot, bool repeat)
+{
+  macroPage = page;
+  macroButton = slot / 2;
+
+  char filename[24];
+  macroFilename(page, filename);
+  MacroReader reader;
+  reader.code = nullptr;
+  reader.bufstart = 0;
+  reader.buflen = 0;
+
+  if (repeat && macroCache.valid && macroCache.page == page && macroCache.slot == slot)
+  {
+    reader.code = macroCache.code;
+    reader.pos = 0;
+    reader.end = macroCache.length;
+  }
+  else if (!macroOpen(reader, filename, slot))
+  {
+    return;
+  }
+  else if (repeat && reader.end - reader.pos <= MACRO_CACHE_SIZE)
+  {
+    macroCache.valid = false;
+    uint16_t length = reader.end - reader.pos;
+    if (reader.file.seek(reader.pos) && reader.file.read(macroCache.code, length) == length)
+    {
+      macroCache.page = page;
+      macroCache.slot = slot;
+      macroCache.length = length;
+      macroCache.valid = true;
+      reader.file.close();
+      reader.code = macroCache.code;
+      reader.pos = 0;
+      reader.end = length;
+    }
+  }
+
+  struct
+  {
+    uint32_t start;
+    uint16_t left;
+  } loops[MACRO_LOOP_DEPTH];
+  uint8_t depth = 0;
+
+  uint8_t op, a, b;
+  uint16_t word;
+
+  while (!hidCancelled() && macroRead(reader, op) && op != OP_END)
+  {
+    switch (op)
+    {
+    case OP_DOWN:
+      if (macroRead(reader, a))
+      {
+        bleKeyboard.press(a);
+      }
+      break;
+    case OP_UP:
+      if (macroRead(reader, a))
+      {
+        bleKeyboard.release(a);
+      }
+      break;
+    case OP_TAP:
+      if (macroRead(reader, a))
+      {
+        bleKeyboard.write(a);
+      }
+      break;
+    case OP_CHORD:
+      if (macroRead(reader, b))
+      {
+        uint8_t keys[MACRO_CHORD_MAX];
+        uint8_t count = 0;
+        while (count < b && count < MACRO_CHORD_MAX && macroRead(reader, keys[count]))
+        {
+          count++;
+        }
+        pressKeys(keys, count);
+        bleKeyboard.releaseAll();
+      }
+      break;
+    case OP_TEXT:
+      if (macroRead16(reader, word))
+      {
+        uint8_t chunk[TEXT_CHUNK];
+        uint32_t skipped = 0;
+        while (word > 0 && !hidCancelled())
+        {
+          uint16_t count = 0;
+          while (count < sizeof(chunk) && word > 0 && macroRead(reader, chunk[count]))
+          {
+            count++;
+            word--;
+          }
+          if (count == 0)
+          {
+            break;
+          }
+          bleKeyboard.writeText(chunk, count, &skipped);
+        }
+        if (skipped > 0)
+        {
+          Serial.printf("[WARNING]: Skipped %lu characters that are not on the keyboard layout\n",
+                        (unsigned long)skipped);
+        }
+      }
+      break;
+    case OP_WAIT:
+      if (macroRead16(reader, word))
+      {
+        actionDelay(word);
+      }
+      break;
+    case OP_LOOP:
+      if (macroRead16(reader, word) && depth < MACRO_LOOP_DEPTH)
+      {
+        loops[depth].start = reader.pos;
+        loops[depth].left = word;
+        depth++;
+      }
+      break;
+    case OP_NEXT:
+      if (depth > 0)
+      {
+        if (--loops[depth - 1].left > 0)
+        {
+          reader.pos = loops[depth - 1].start;
+        }
+        else
+        {
+          depth--;
+        }
+      }
+      break;
+    case OP_PAGE:
+      if (macroRead(reader, a))
+      {
+        postUiEvent(UI_EVENT_OPEN, a);
+      }
+      break;
+    case OP_RELEASE:
+      bleKeyboard.releaseAll();
+      break;
+    case OP_ACTION:
+      if (macroRead(reader, a) && macroRead16(reader, word))
+      {
+        bleKeyboardAction(a, word, "");
+      }
+      break;
+    case OP_FILE:
+    case OP_HTTP:
+      if (macroRead(reader, b) && b <= MACRO_FILENAME_MAX)
+      {
+        char name[MACRO_FILENAME_MAX + 1];
+        uint8_t length = 0;
+        while (length < b && macroRead(reader, a))
+        {
+          name[length++] = a;
+        }
+        name[length] = '\0';
+        if (op == OP_FILE)
+        {
+          typeFile(name);
+        }
+        else
+        {
+          webhookQueue(name);
+        }
+      }
+      break;
+    default:
+      Serial.printf("[WARNING]: Unknown opcode %u in %s\n", op, filename);
+      reader.pos = reader.end;
+      break;
+    }
+  }
+
+  reader.file.close();
+  bleKeyboard.releaseAll();
+}
@@ -0,0 +1,353 @@
+/*
+ * Lookup helpers for the pages and their buttons.
+ *
+ * PAGE_HOME is the home screen, pages 1 to MENU_MAX are the menus and
+ * PAGE_SETTINGS is the settings page. Every page has BUTTONS_PER_PAGE buttons, numbered from
+ * left to right and top to bottom (see colArray and rowArray).
+ *
+ * Menus are only parsed when they are shown and at most MENU_CACHE_SIZE of
+ * them are kept in RAM, so the number of menus does not cost RAM or boot time.
+ */
+
+// The page held by each cache slot (0 = empty) and when it was last used
+int16_t menuCachePage[MENU_CACHE_SIZE] = {0};
+uint32_t menuCacheUsed[MENU_CACHE_SIZE] = {0};
+uint32_t menuCacheClock = 0;
+
+// The host's keyboard LEDs (LED_*) the latches were last synced to
+uint8_t hostLeds = 0;
+
+bool loadMenuConfig(int page, struct Menu *menu); // ConfigLoad.h
+
+/**
+* @brief This function fills in the fixed logos of the settings page.
+*
+* @param none
+*
+* @return none
+*
+* @note Call after generallogo is set.
+*/
+void menusSetup()
+{
+  strlcpy(settingsscreen.logo[0], generallogo.configurator, sizeof(settingsscreen.logo[0]));
+  strlcpy(settingsscreen.logo[1], "/logos/brightnessdown.bmp", sizeof(settingsscreen.logo[1]));
+  strlcpy(settingsscreen.logo[2], "/logos/brightnessup.bmp", sizeof(settingsscreen.logo[2]));
+  strlcpy(settingsscreen.logo[3], "/logos/sleep.bmp", sizeof(settingsscreen.logo[3]));
+  strlcpy(settingsscreen.logo[4], "/logos/info.bmp", sizeof(settingsscreen.logo[4]));
+  strlcpy(settingsscreen.logo[5], generallogo.homebutton, sizeof(settingsscreen.logo[5]));
+}
+
+/**
+* @brief This function checks if a page number is a menu.
+*
+* @param page int
+*
+* @return bool
+*
+* @note none
+*/
+bool isMenuPage(int page)
+{
+  return page >= 1 && page <= MENU_MAX;
+}
+
+uint8_t syncLedLatches(int page, struct Menu *menu); // Below
+
+/**
+* @brief This function returns the menu shown on a page. If the menu is not
+         in the cache it is loaded, replacing the least recently used one.
+*
+* @param page int
+*
+* @return struct Menu * or nullptr if the page is not a menu or failed to load
+*
+* @note Only call from the UI task. On a load failure jsonfilefail names the file.
+*/
+struct Menu *getMenu(int page)
+{
+  if (!isMenuPage(page))
+  {
+    return nullptr;
+  }
+
+  uint8_t slot = 0;
+  for (uint8_t i = 0; i < MENU_CACHE_SIZE; i++)
+  {
+    if (menuCachePage[i] == page)
+    {
+      menuCacheUsed[i] = ++menuCacheClock;
+      return &menuCache[i];
+    }
+    // Empty slots have a use count of 0, so they are taken first
+    if (menuCacheUsed[i] < menuCacheUsed[slot])
+    {
+      slot = i;
+    }
+  }
+
+  Serial.printf("[INFO]: Loading menu%d into cache slot %u\n", page, slot);
+  memset(&menuCache[slot], 0, sizeof(menuCache[slot]));
+  if (!loadMenuConfig(page, &menuCache[slot]))
+  {
+    static char failedmenu[12];
+    snprintf(failedmenu, sizeof(failedmenu), "menu%d", page);
+    jsonfilefail = failedmenu;
+    menuCachePage[slot] = 0;
+    menuCacheUsed[slot] = 0;
+    return nullptr;
+  }
+  menuCachePage[slot] = page;
+  menuCacheUsed[slot] = ++menuCacheClock;
+  syncLedLatches(page, &menuCache[slot]);
+  return &menuCache[slot];
+}
+
+/**
+* @brief This function drops all menus from the cache, so they are loaded
+         again the next time they are shown.
+*
+* @param none
+*
+* @return none
+*
+* @note Only call from the UI task.
+*/
+void menuCacheClear()
+{
+  memset(menuCachePage, 0, sizeof(menuCachePage));
+  memset(menuCacheUsed, 0, sizeof(menuCacheUsed));
+}
+
+/**
+* @brief This function returns the button struct of a menu button.
+*
+* @param page int the menu (1 to MENU_MAX)
+* @param b int the button (0 to 4)
+*
+* @return struct Button * or nullptr if page/b is not a menu button
+*
+* @note Button 5 of a menu is the home button and has no struct.
+*/
+struct Button *getMenuButton(int page, int b)
+{
+  struct Menu *menu = getMenu(page);
+  if (menu == nullptr || b < 0 || b >= BUTTONS_PER_PAGE - 1)
+  {
+    return nullptr;
+  }
+  return &menu->button[b];
+}
+
+/**
+* @brief This function returns the logos of a page.
+*
+* @param page int
+*
+* @return struct Logos * or nullptr if the page has no buttons
+*
+* @note none
+*/
+struct Logos *getLogos(int page)
+{
+  if (page == PAGE_HOME)
+  {
+    return &homescreen;
+  }
+  if (page == PAGE_SETTINGS)
+  {
+    return &settingsscreen;
+  }
+  struct Menu *menu = getMenu(page);
+  if (menu == nullptr)
+  {
+    return nullptr;
+  }
+  return &menu->logos;
+}
+
+/**
+* @brief This function returns the path of the logo of a button.
+*
+* @param page int
+* @param b int the button (0 to 5)
+*
+* @return const char * or nullptr if page/b has no logo
+*
+* @note none
+*/
+const char *getLogo(int page, int b)
+{
+  struct Logos *logos = getLogos(page);
+  if (logos == nullptr || b < 0 || b >= BUTTONS_PER_PAGE)
+  {
+    return nullptr;
+  }
+  return logos->logo[b];
+}
+
+/**
+* @brief This function returns the index in the latch bit array of a button.
+*
+* @param page int
+* @param b int the button (0 to 4)
+*
+* @return int or -1 if the button can not latch
+*
+* @note Menu N uses (N - 1) * 5 to N * 5 - 1, the settings page the last 5.
+*/
+int latchIndex(int page, int b)
+{
+  if (b < 0 || b >= BUTTONS_PER_PAGE - 1)
+  {
+    return -1;
+  }
+  if (isMenuPage(page))
+  {
+    return (page - 1) * 5 + b;
+  }
+  if (page == PAGE_SETTINGS)
+  {
+    return MENU_MAX * 5 + b;
+  }
+  return -1;
+}
+
+/**
+* @brief This function returns the latch state of a button.
+*
+* @param page int
+* @param b int the button (0 to 4)
+*
+* @return bool
+*
+* @note none
+*/
+bool isLatched(int page, int b)
+{
+  int index = latchIndex(page, b);
+  if (index < 0)
+  {
+    return false;
+  }
+  return latchbits[index / 8] & (1 << (index % 8));
+}
+
+/**
+* @brief This function sets the latch state of a button.
+*
+* @param page int
+* @param b int the button (0 to 4)
+* @param latched bool
+*
+* @return none
+*
+* @note none
+*/
+void setLatched(int page, int b, bool latched)
+{
+  int index = latchIndex(page, b);
+  if (index < 0)
+  {
+    return;
+  }
+  if (latched)
+  {
+    latchbits[index / 8] |= (1 << (index % 8));
+  }
+  else
+  {
+    latchbits[index / 8] &= ~(1 << (index % 8));
+  }
+}
+
+/**
+* @brief This function toggles the latch state of a button.
+*
+* @param page int
+* @param b int the button (0 to 4)
+*
+* @return none
+*
+* @note none
+*/
+void toggleLatch(int page, int b)
+{
+  setLatched(page, b, !isLatched(page, b));
+}
+
+/**
+* @brief This function sets the latches that follow a host LED to the LED state.
+*
+* @param page int
+* @param menu struct Menu * the menu of page
+*
+* @return uint8_t a bit for each button whose latch changed
+*
+* @note The LED state is hostLeds, see hostLedsSync().
+*/
+uint8_t syncLedLatches(int page, struct Menu *menu)
+{
+  uint8_t changed = 0;
+  for (int b = 0; b < BUTTONS_PER_PAGE - 1; b++)
+  {
+    uint8_t led = menu->button[b].led;
+    if (led == 0)
+    {
+      continue;
+    }
+    bool on = hostLeds & led;
+    if (isLatched(page, b) != on)
+    {
+      setLatched(page, b, on);
+      changed |= 1 << b;
+    }
+  }
+  return changed;
+}
+
+/**
+* @brief This function reads the latch states back from Preferences.
+*
+* @param none
+*
+* @return none
+*
+* @note Converts the 30 byte "latched" array of older versions once.
+*/
+void loadLatchStates()
+{
+  if (savedStates.isKey("latchbits"))
+  {
+    savedStates.getBytes("latchbits", latchbits, sizeof(latchbits));
+    return;
+  }
+
+  bool oldlatched[30] = {0};
+  if (savedStates.getBytes("latched", oldlatched, sizeof(oldlatched)) == sizeof(oldlatched))
+  {
+    for (int i = 0; i < 25; i++)
+    {
+      setLatched(i / 5 + 1, i % 5, oldlatched[i]);
+    }
+    for (int b = 0; b < 5; b++)
+    {
+      setLatched(PAGE_SETTINGS, b, oldlatched[25 + b]);
+    }
+    savedStates.remove("latched");
+  }
+}
+
+/**
+* @brief This function stores the latch states in Preferences.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void saveLatchStates()
+{
+  savedStates.putBytes("latchbits", latchbits, sizeof(latchbits));
+}
@@ -0,0 +1,195 @@
+/*
+ * Long-press and hold-to-repeat handling for menu buttons.
+ *
+ * A button with a pressmode other than PRESSMODE_TAP is handed to this engine
+ * when it is pressed. An esp_timer measures the hold time and the timer callback
+ * queues the actions for the HID task. Repeats only send HID reports, the button
+ * is not redrawn while it is held.
+ */
+
+#include "esp_timer.h"
+
+esp_timer_handle_t pressTimer = nullptr;
+
+struct PressState
+{
+  struct Button *button;    // The button being held, nullptr when idle
+  int8_t key;               // Index in key[] of the held button
+  int16_t page;             // Page of the held button
+  volatile bool longFired;     // The long actions have been queued
+  volatile bool repeating;     // The periodic repeat timer is running
+};
+
+PressState pressState = {nullptr, -1, 0, false, false};
+
+/**
+* @brief This is the callback of the press timer. It runs in the esp_timer task
+         and queues the long-press or repeat actions for the HID task.
+*
+* @param arg void * (unused)
+*
+* @return none
+*
+* @note For a repeat button the first (one-shot) expiry starts the periodic timer.
+*/
+void pressTimerCallback(void *arg)
+{
+  struct Button *button = pressState.button;
+  if (button == nullptr)
+  {
+    return;
+  }
+
+  if (button->pressmode == PRESSMODE_LONGPRESS)
+  {
+    pressState.longFired = true;
+    queueMacro(button, pressState.page, pressState.key, true);
+  }
+  else if (button->pressmode == PRESSMODE_REPEAT)
+  {
+    // If the HID task has not caught up with the last repeat, this one is dropped
+    // instead of queued, so a busy host never results in a burst of repeats.
+    if (uxQueueMessagesWaiting(hidQueue) == 0)
+    {
+      queueMacro(button, pressState.page, pressState.key, false);
+    }
+    if (!pressState.repeating)
+    {
+      pressState.repeating = true;
+      esp_timer_start_periodic(pressTimer, (uint64_t)button->repeatrate * 1000ULL);
+    }
+  }
+}
+
+/**
+* @brief This function creates the press timer. Call once in setup().
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void pressSetup()
+{
+  const esp_timer_create_args_t timerArgs = {
+      .callback = &pressTimerCallback,
+      .arg = nullptr,
+      .dispatch_method = ESP_TIMER_TASK,
+      .name = "ftd_press"};
+
+  if (esp_timer_create(&timerArgs, &pressTimer) != ESP_OK)
+  {
+    Serial.println("[WARNING]: Failed to create press timer. Long-press and repeat disabled.");
+    pressTimer = nullptr;
+  }
+}
+
+/**
+* @brief This function toggles the latch state of the held button if it is
+         a latching button.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void pressToggleLatch()
+{
+  if (pressState.button->latch && !pressState.button->led)
+  {
+    toggleLatch(pressState.page, pressState.key);
+  }
+}
+
+/**
+* @brief This function is called when a button is just pressed. If the button
+         has a long-press or repeat mode, the press engine takes over.
+*
+* @param b uint8_t the index of the pressed key
+*
+* @return True if the press engine handles this press. False for normal buttons.
+*
+* @note A repeat button fires immediately, a long-press button waits for the
+         release or the hold timer to decide which action set to send.
+*/
+bool pressBegin(uint8_t b)
+{
+  struct Button *button = getMenuButton(pageNum, b);
+  if (button == nullptr || button->pressmode == PRESSMODE_TAP || pressTimer == nullptr)
+  {
+    return false;
+  }
+
+  esp_timer_stop(pressTimer);
+
+  pressState.button = button;
+  pressState.key = b;
+  pressState.page = pageNum;
+  pressState.longFired = false;
+  pressState.repeating = false;
+
+  if (button->pressmode == PRESSMODE_REPEAT)
+  {
+    queueMacro(button, pageNum, b, false);
+    pressToggleLatch();
+  }
+
+  esp_timer_start_once(pressTimer, (uint64_t)button->holddelay * 1000ULL);
+  return true;
+}
+
+/**
+* @brief This function is called when a button is just released. It stops the
+         hold timer and sends the short-press actions of a long-press button
+         that was released before the hold delay.
+*
+* @param b uint8_t the index of the released key
+*
+* @return none
+*
+* @note Call this before redrawing the button, so the latch state is up to date.
+*/
+void pressRelease(uint8_t b)
+{
+  if (pressState.button == nullptr || pressState.key != b)
+  {
+    return;
+  }
+
+  esp_timer_stop(pressTimer);
+
+  if (pressState.button->pressmode == PRESSMODE_LONGPRESS && !pressState.longFired)
+  {
+    queueMacro(pressState.button, pressState.page, pressState.key, false);
+    pressToggleLatch();
+  }
+
+  pressState.button = nullptr;
+  pressState.key = -1;
+  pressState.repeating = false;
+  macroCacheDrop();
+}
+
+/**
+* @brief This function forgets the held button without sending anything.
+*
+* @param none
+*
+* @return none
+*
+* @note Called when the page is left, the held button may be dropped from
+         the menu cache after that.
+*/
+void pressCancel()
+{
+  if (pressTimer)
+  {
+    esp_timer_stop(pressTimer);
+  }
+  pressState.button = nullptr;
+  pressState.key = -1;
+  pressState.repeating = false;
+  macroCacheDrop();
+}
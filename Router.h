@@ -0,0 +1,277 @@
+/*
+ * Screen router.
+ *
+ * Every page is a Screen with its own enter/exit/onTouch/onTick handlers. Only
+ * the active screen's handlers run. Pages that are opened from another page are
+ * pushed on a small navigation stack so routerBack() returns to where we came from.
+ *
+ * pageNum is still the number of the active page, the draw helpers use it to
+ * look up logos and buttons. Only the router changes it once the tasks are running.
+ */
+
+// The pages. Pages 1 to MENU_MAX are the menus, they all share one Screen.
+#define PAGE_HOME 0
+#define PAGE_SETTINGS (MENU_MAX + 1)
+#define PAGE_CONFIGMODE (MENU_MAX + 2)
+#define PAGE_INFO (MENU_MAX + 3)
+#define PAGE_WIFIFAIL (MENU_MAX + 4)
+#define PAGE_JSONERROR (MENU_MAX + 5)
+
+// Screen slots: home, the menus, then PAGE_SETTINGS to PAGE_JSONERROR
+#define SCREEN_SLOTS 7
+
+// How many pages deep back navigation remembers
+#define NAV_STACK_DEPTH 8
+
+struct Screen
+{
+  void (*enter)();                                       // Draw the screen
+  void (*exit)();                                        // Clean up before the next screen is entered
+  void (*onTouch)(bool pressed, uint16_t x, uint16_t y); // Handle one touch sample
+  void (*onTick)();                                      // Called every UI tick
+  bool cansleep;                                         // The sleep timer may fire on this screen
+};
+
+const Screen *screens[SCREEN_SLOTS] = {nullptr};
+
+uint8_t navStack[NAV_STACK_DEPTH];
+uint8_t navDepth = 0;
+
+/**
+* @brief This function returns the screen slot of a page.
+*
+* @param page int
+*
+* @return int or -1 if the page does not exist
+*
+* @note none
+*/
+int screenSlot(int page)
+{
+  if (page == PAGE_HOME)
+  {
+    return 0;
+  }
+  if (page >= 1 && page <= MENU_MAX)
+  {
+    return 1;
+  }
+  if (page >= PAGE_SETTINGS && page <= PAGE_JSONERROR)
+  {
+    return page - PAGE_SETTINGS + 2;
+  }
+  return -1;
+}
+
+/**
+* @brief This function sets the handlers of a page.
+*
+* @param page uint8_t
+* @param screen const Screen *
+*
+* @return none
+*
+* @note Call for every page before routerStart(). Registering any menu page
+         registers them all.
+*/
+void routerRegister(uint8_t page, const Screen *screen)
+{
+  int slot = screenSlot(page);
+  if (slot >= 0)
+  {
+    screens[slot] = screen;
+  }
+}
+
+/**
+* @brief This function returns the handlers of the active page.
+*
+* @param none
+*
+* @return const Screen * or nullptr if the page has no screen
+*
+* @note none
+*/
+const Screen *activeScreen()
+{
+  int slot = screenSlot(pageNum);
+  if (slot < 0)
+  {
+    return nullptr;
+  }
+  return screens[slot];
+}
+
+/**
+* @brief This function leaves the active page and enters another one.
+*
+* @param page uint8_t
+*
+* @return none
+*
+* @note Does not touch the navigation stack. Only call from the UI task.
+*/
+void routerSwitch(uint8_t page)
+{
+  int slot = screenSlot(page);
+  if (slot < 0 || screens[slot] == nullptr)
+  {
+    Serial.printf("[WARNING]: No screen for page %u\n", page);
+    return;
+  }
+
+  const Screen *current = activeScreen();
+  if (current && current->exit)
+  {
+    current->exit();
+  }
+
+  pageNum = page;
+
+  if (screens[slot]->enter)
+  {
+    screens[slot]->enter();
+  }
+}
+
+/**
+* @brief This function shows the first page after boot.
+*
+* @param page uint8_t
+*
+* @return none
+*
+* @note There is no page to exit yet, so only enter() runs. The navigation
+         stack is kept, it may have been restored from a snapshot.
+*/
+void routerStart(uint8_t page)
+{
+  pageNum = page;
+  const Screen *screen = activeScreen();
+  if (screen && screen->enter)
+  {
+    screen->enter();
+  }
+}
+
+/**
+* @brief This function replaces the active page with another one.
+*
+* @param page uint8_t
+*
+* @return none
+*
+* @note Back navigation returns to the page below the one replaced.
+*/
+void routerGo(uint8_t page)
+{
+  routerSwitch(page);
+}
+
+/**
+* @brief This function opens a page on top of the active one.
+*
+* @param page uint8_t
+*
+* @return none
+*
+* @note If the stack is full the oldest entry is dropped.
+*/
+void routerPush(uint8_t page)
+{
+  if (navDepth == NAV_STACK_DEPTH)
+  {
+    memmove(navStack, navStack + 1, NAV_STACK_DEPTH - 1);
+    navDepth--;
+  }
+  navStack[navDepth++] = pageNum;
+  routerSwitch(page);
+}
+
+/**
+* @brief This function returns to the page the active one was opened from.
+*
+* @param none
+*
+* @return none
+*
+* @note Goes to the home screen if the stack is empty.
+*/
+void routerBack()
+{
+  if (navDepth == 0)
+  {
+    routerSwitch(PAGE_HOME);
+    return;
+  }
+  routerSwitch(navStack[--navDepth]);
+}
+
+/**
+* @brief This function goes to the home screen and forgets the navigation stack.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void routerHome()
+{
+  navDepth = 0;
+  routerSwitch(PAGE_HOME);
+}
+
+/**
+* @brief This function hands a touch sample to the active page.
+*
+* @param pressed bool whether the screen is touched
+* @param x uint16_t
+* @param y uint16_t
+*
+* @return none
+*
+* @note none
+*/
+void routerTouch(bool pressed, uint16_t x, uint16_t y)
+{
+  const Screen *screen = activeScreen();
+  if (screen && screen->onTouch)
+  {
+    screen->onTouch(pressed, x, y);
+  }
+}
+
+/**
+* @brief This function runs the tick handler of the active page.
+*
+* @param none
+*
+* @return none
+*
+* @note Called by the UI task every UI_TICK_MS or after every event.
+*/
+void routerTick()
+{
+  const Screen *screen = activeScreen();
+  if (screen && screen->onTick)
+  {
+    screen->onTick();
+  }
+}
+
+/**
+* @brief This function checks if the sleep timer may put us to sleep on the
+         active page.
+*
+* @param none
+*
+* @return bool
+*
+* @note Safe to call from any task.
+*/
+bool routerCanSleep()
+{
+  const Screen *screen = activeScreen();
+  return screen && screen->cansleep;
+}
@@ -311,189 +311,23 @@ uint16_t getImageBG(int logonumber)
 {
 
   // Logo 5 on each screen is the back home button except on the home screen
-  if (logonumber == 5 && pageNum > 0)
-   {
-      return getBMPColor("/logos/home.bmp");
-   }
-   else
-   {
-
-    if (pageNum == 0)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen0.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen0.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen0.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen0.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen0.logo4);
-      }
-      else if (logonumber == 5)
-      {
-        return getBMPColor(screen0.logo5);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 1)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen1.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen1.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen1.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen1.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen1.logo4);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 2)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen2.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen2.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen2.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen2.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen2.logo4);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 3)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen3.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen3.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen3.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen3.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen3.logo4);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 4)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen4.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen4.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen4.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen4.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen4.logo4);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 5)
-    {
-      if (logonumber == 0)
-      {
-        return getBMPColor(screen5.logo0);
-      }
-      else if (logonumber == 1)
-      {
-        return getBMPColor(screen5.logo1);
-      }
-      else if (logonumber == 2)
-      {
-        return getBMPColor(screen5.logo2);
-      }
-      else if (logonumber == 3)
-      {
-        return getBMPColor(screen5.logo3);
-      }
-      else if (logonumber == 4)
-      {
-        return getBMPColor(screen5.logo4);
-      }
-      else
-      {
-        return 0x0000;
-      }
-    }
-    else if (pageNum == 6)
-    {
-      return 0x0000;
-    }
-    else
-    {
-      return 0x0000;
-    }
+  if (logonumber == 5 && pageNum != PAGE_HOME)
+  {
+    return getBMPColor("/logos/home.bmp");
+  }
 
+  // The settings logos are always drawn transparent
+  if (pageNum == PAGE_SETTINGS)
+  {
+    return 0x0000;
   }
+
+  const char *logo = getLogo(pageNum, logonumber);
+  if (logo == nullptr)
+  {
+    return 0x0000;
+  }
+  return getBMPColor(logo);
 }
 
 /**
@@ -508,248 +342,15 @@ uint16_t getImageBG(int logonumber)
 */
 uint16_t getLatchImageBG(int logonumber)
 {
-
-  if (pageNum == 1)
-  {
-    if (logonumber == 0)
-    {
-      if (strcmp(menu1.button0.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen1.logo0);
-      }
-      return getBMPColor(menu1.button0.latchlogo);
-    }
-    else if (logonumber == 1)
-    {
-      if (strcmp(menu1.button1.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen1.logo1);
-      }
-      return getBMPColor(menu1.button1.latchlogo);
-    }
-    else if (logonumber == 2)
-    {
-      if (strcmp(menu1.button2.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen1.logo2);
-      }
-      return getBMPColor(menu1.button2.latchlogo);
-    }
-    else if (logonumber == 3)
-    {
-      if (strcmp(menu1.button3.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen1.logo3);
-      }
-      return getBMPColor(menu1.button3.latchlogo);
-    }
-    else if (logonumber == 4)
-    {
-      if (strcmp(menu1.button4.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen1.logo4);
-      }
-      return getBMPColor(menu1.button4.latchlogo);
-    }
-    else
-    {
-      return 0x0000;
-    }
-  }
-  else if (pageNum == 2)
-  {
-    if (logonumber == 0)
-    {
-      if (strcmp(menu2.button0.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen2.logo0);
-      }
-      return getBMPColor(menu2.button0.latchlogo);
-    }
-    else if (logonumber == 1)
-    {
-      if (strcmp(menu2.button1.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen2.logo1);
-      }
-      return getBMPColor(menu2.button1.latchlogo);
-    }
-    else if (logonumber == 2)
-    {
-      if (strcmp(menu2.button2.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen2.logo2);
-      }
-      return getBMPColor(menu2.button2.latchlogo);
-    }
-    else if (logonumber == 3)
-    {
-      if (strcmp(menu2.button3.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen2.logo3);
-      }
-      return getBMPColor(menu2.button3.latchlogo);
-    }
-    else if (logonumber == 4)
-    {
-      if (strcmp(menu2.button4.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen2.logo4);
-      }
-      return getBMPColor(menu2.button4.latchlogo);
-    }
-    else
-    {
-      return 0x0000;
-    }
-  }
-  else if (pageNum == 3)
-  {
-    if (logonumber == 0)
-    {
-      if (strcmp(menu3.button0.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen3.logo0);
-      }
-      return getBMPColor(menu3.button0.latchlogo);
-    }
-    else if (logonumber == 1)
-    {
-      if (strcmp(menu3.button1.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen3.logo1);
-      }
-      return getBMPColor(menu3.button1.latchlogo);
-    }
-    else if (logonumber == 2)
-    {
-      if (strcmp(menu3.button2.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen3.logo2);
-      }
-      return getBMPColor(menu3.button2.latchlogo);
-    }
-    else if (logonumber == 3)
-    {
-      if (strcmp(menu3.button3.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen3.logo3);
-      }
-      return getBMPColor(menu3.button3.latchlogo);
-    }
-    else if (logonumber == 4)
-    {
-      if (strcmp(menu3.button4.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen3.logo4);
-      }
-      return getBMPColor(menu3.button4.latchlogo);
-    }
-    else
-    {
-      return 0x0000;
-    }
-  }
-  else if (pageNum == 4)
-  {
-    if (logonumber == 0)
-    {
-      if (strcmp(menu4.button0.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen4.logo0);
-      }
-      return getBMPColor(menu4.button0.latchlogo);
-    }
-    else if (logonumber == 1)
-    {
-      if (strcmp(menu4.button1.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen4.logo1);
-      }
-      return getBMPColor(menu4.button1.latchlogo);
-    }
-    else if (logonumber == 2)
-    {
-      if (strcmp(menu4.button2.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen4.logo2);
-      }
-      return getBMPColor(menu4.button2.latchlogo);
-    }
-    else if (logonumber == 3)
-    {
-      if (strcmp(menu4.button3.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen4.logo3);
-      }
-      return getBMPColor(menu4.button3.latchlogo);
-    }
-    else if (logonumber == 4)
-    {
-      if (strcmp(menu4.button4.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen4.logo4);
-      }
-      return getBMPColor(menu4.button4.latchlogo);
-    }
-    else
-    {
-      return 0x0000;
-    }
-  }
-  else if (pageNum == 5)
-  {
-    if (logonumber == 0)
-    {
-      if (strcmp(menu5.button0.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen5.logo0);
-      }
-      return getBMPColor(menu5.button0.latchlogo);
-    }
-    else if (logonumber == 1)
-    {
-      if (strcmp(menu5.button1.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen5.logo1);
-      }
-      return getBMPColor(menu5.button1.latchlogo);
-    }
-    else if (logonumber == 2)
-    {
-      if (strcmp(menu5.button2.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen5.logo2);
-      }
-      return getBMPColor(menu5.button2.latchlogo);
-    }
-    else if (logonumber == 3)
-    {
-      if (strcmp(menu5.button3.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen5.logo3);
-      }
-      return getBMPColor(menu5.button3.latchlogo);
-    }
-    else if (logonumber == 4)
-    {
-      if (strcmp(menu5.button4.latchlogo, "/logos/") == 0)
-      {
-        return getBMPColor(screen5.logo4);
-      }
-      return getBMPColor(menu5.button4.latchlogo);
-    }
-    else
-    {
-      return 0x0000;
-    }
-  }
-  else if (pageNum == 6)
+  struct Button *button = getMenuButton(pageNum, logonumber);
+  if (button == nullptr)
   {
     return 0x0000;
   }
-  else
+
+  if (strcmp(button->latchlogo, "/logos/") == 0)
   {
-    return 0x0000;
+    return getBMPColor(getLogo(pageNum, logonumber));
   }
+  return getBMPColor(button->latchlogo);
 }
@@ -0,0 +1,421 @@
+/*
+ * The screens FreeTouchDeck can show, one Screen per page. See Router.h.
+ */
+
+//--------------------- Button pages (home, menus and settings) --------------------------------
+
+/**
+* @brief This function handles one touch sample on a page with the 6 buttons.
+*
+* @param pressed bool whether the screen is touched
+* @param t_x uint16_t
+* @param t_y uint16_t
+*
+* @return none
+*
+* @note A sample with pressed = false follows the last touched sample, so
+         buttons see their release.
+*/
+void buttonPageTouch(bool pressed, uint16_t t_x, uint16_t t_y)
+{
+  // Check if the X and Y coordinates of the touch are within one of our buttons
+  for (uint8_t b = 0; b < 6; b++)
+  {
+    if (pressed && key[b].contains(t_x, t_y))
+    {
+      key[b].press(true); // tell the button it is pressed
+
+      // After receiving a valid touch reset the sleep timer
+      previousMillis = millis();
+    }
+    else
+    {
+      key[b].press(false); // tell the button it is NOT pressed
+    }
+  }
+
+  // Check if any key has changed state
+  for (uint8_t b = 0; b < 6; b++)
+  {
+    uint8_t col = colArray[b];
+    uint8_t row = rowArray[b];
+
+    if (key[b].justReleased())
+    {
+
+      // Let the press engine finish a long-press or repeat before redrawing
+      pressRelease(b);
+
+      // Draw normal button space (non inverted)
+
+      bool latched = isLatched(pageNum, b);
+
+      uint16_t buttonBG;
+      bool drawTransparent;
+
+      uint16_t imageBGColor;
+      if (latched)
+      {
+        imageBGColor = getLatchImageBG(b);
+      }
+      else
+      {
+        imageBGColor = getImageBG(b);
+      }
+
+      if (imageBGColor > 0)
+      {
+        buttonBG = imageBGColor;
+        drawTransparent = false;
+      }
+      else
+      {
+        if (pageNum == PAGE_HOME || (pageNum == PAGE_SETTINGS && b == 5))
+        {
+          buttonBG = generalconfig.menuButtonColour;
+          drawTransparent = true;
+        }
+        else
+        {
+          buttonBG = generalconfig.functionButtonColour;
+          drawTransparent = true;
+        }
+      }
+      tft.setFreeFont(LABEL_FONT);
+      key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
+                        KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
+                        KEY_W, KEY_H, TFT_WHITE, buttonBG, TFT_WHITE,
+                        "", KEY_TEXTSIZE);
+      key[b].drawButton();
+
+      // After drawing the button outline we call this to draw a logo.
+      drawlogo(b, col, row, drawTransparent, latched);
+    }
+
+    if (key[b].justPressed())
+    {
+      
+      // Beep
+      #ifdef speakerPin
+      if(generalconfig.beep){
+        ledcAttachPin(speakerPin, 2);
+        ledcWriteTone(2, 600);
+        delay(50);
+        ledcDetachPin(speakerPin);
+        ledcWrite(2, 0);
+      }
+      #endif 
+
+      tft.setFreeFont(LABEL_FONT);
+      key[b].initButton(&tft, KEY_X + col * (KEY_W + KEY_SPACING_X),
+                        KEY_Y + row * (KEY_H + KEY_SPACING_Y), // x, y, w, h, outline, fill, text
+                        KEY_W, KEY_H, TFT_WHITE, TFT_WHITE, TFT_WHITE,
+                        "", KEY_TEXTSIZE);
+      key[b].drawButton();
+
+      //---------------------------------------- Button press handeling --------------------------------------------------
+
+      if (pressBegin(b))
+      {
+        // Buttons with a long-press or repeat mode are handled by the press engine
+      }
+      else if (pageNum == PAGE_HOME) // Home menu: buttons 0-4 open their menu, button 5 the settings
+      {
+        routerPush(b < 5 ? homelinks[b] : PAGE_SETTINGS);
+      }
+      else if (b == 5) // Button 5 / Back home
+      {
+        routerHome();
+      }
+      else if (pageNum == PAGE_SETTINGS) // Settings page
+      {
+        if (b == 4) // Button 4 / Info
+        {
+          routerPush(PAGE_INFO);
+        }
+        else
+        {
+          // Buttons 0-3 are special functions 1-4: config mode, brightness down/up, sleep
+          bleKeyboardAction(11, b + 1, 0);
+          if (b == 3)
+          {
+            toggleLatch(pageNum, b);
+          }
+        }
+      }
+      else // Any menu page (1 to MENU_MAX), however it was opened
+      {
+        Button *button = getMenuButton(pageNum, b);
+        if (button)
+        {
+          queueMacro(button, pageNum, b, false);
+          if (button->latch && !button->led) // An LED latch follows the host
+          {
+            toggleLatch(pageNum, b);
+          }
+        }
+      }
+
+      delay(10); // UI debouncing
+    }
+  }
+}
+
+/**
+* @brief This function draws a page with the 6 buttons.
+*
+* @param none
+*
+* @return none
+*
+* @note A menu that fails to load shows the JSON error page instead.
+*/
+void buttonPageEnter()
+{
+  if (isMenuPage(pageNum) && getMenu(pageNum) == nullptr)
+  {
+    routerGo(PAGE_JSONERROR);
+    return;
+  }
+  drawKeypad();
+}
+
+/**
+* @brief This function lets go of a held button when the page is left.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void buttonPageExit()
+{
+  pressCancel();
+}
+
+/**
+* @brief This function lets the latches follow the host's keyboard LEDs.
+*
+* @param none
+*
+* @return none
+*
+* @note Called by the UI task every tick. Only the cached menus are updated,
+         others are synced when they are loaded. Only the buttons whose latch
+         changed are redrawn.
+*/
+void hostLedsSync()
+{
+  uint8_t leds = bleKeyboard.getLeds();
+  if (leds == hostLeds)
+  {
+    return;
+  }
+  hostLeds = leds;
+
+  for (uint8_t i = 0; i < MENU_CACHE_SIZE; i++)
+  {
+    if (menuCachePage[i] == 0)
+    {
+      continue;
+    }
+    uint8_t changed = syncLedLatches(menuCachePage[i], &menuCache[i]);
+    if (changed == 0 || menuCachePage[i] != pageNum)
+    {
+      continue;
+    }
+    for (uint8_t b = 0; b < BUTTONS_PER_PAGE - 1; b++)
+    {
+      if (changed & (1 << b))
+      {
+        drawLatchButton(b);
+      }
+    }
+  }
+}
+
+const Screen buttonPageScreen = {buttonPageEnter, buttonPageExit, buttonPageTouch, nullptr, true};
+
+//--------------------- Config mode -------------------------------------------------------------
+
+/**
+* @brief This function starts WiFi and the configurator and draws how to reach it.
+*
+* @param none
+*
+* @return none
+*
+* @note BLE is stopped once the configurator runs, unless wificonfig.keepble
+         is set. With BLE stopped the only way out of config mode is a restart.
+         While WiFi is still connecting it can be cancelled.
+*/
+void configModeEnter()
+{
+  configmode();
+}
+
+/**
+* @brief This function stops connecting to WiFi when config mode is left.
+*
+* @param none
+*
+* @return none
+*
+* @note Config mode can only be left by cancelling while connecting, or with
+         the back button when the keyboard kept running. The configurator keeps
+         running then.
+*/
+void configModeExit()
+{
+  if (!wifiServing && (wifiState == WIFI_STATE_CONNECTING || wifiState == WIFI_STATE_BACKOFF))
+  {
+    wifiCancel();
+  }
+  tft.fillScreen(generalconfig.backgroundColour);
+}
+
+/**
+* @brief This function cancels connecting or restarts when the button is touched.
+*
+* @param pressed bool whether the screen is touched
+* @param t_x uint16_t
+* @param t_y uint16_t
+*
+* @return none
+*
+* @note The button is drawn by configmode() and configModeTick() with
+         drawSingleButton(140, 180, 200, 80, ...)
+*/
+void configModeTouch(bool pressed, uint16_t t_x, uint16_t t_y)
+{
+  bool bleRunning = wifiServing ? !wifiStopBle : (wifiState == WIFI_STATE_CONNECTING || wifiState == WIFI_STATE_BACKOFF);
+  if (pressed && t_x > 140 && t_x < 340 && t_y > 180 && t_y < 260 && bleRunning)
+  {
+    // The cancel or back button, BLE is still running so we can go back
+    routerBack();
+  }
+  else if (pressed && t_x > 140 && t_x < 340 && t_y > 180 && t_y < 260)
+  {
+    // Touch falls within the boundaries of our button so we restart
+    Serial.println("[WARNING]: Restarting");
+    ESP.restart();
+  }
+}
+
+const Screen configModeScreen = {configModeEnter, configModeExit, configModeTouch, configModeTick, false};
+
+//--------------------- Info, WiFi failure and JSON error ---------------------------------------
+
+/**
+* @brief This function goes back to the page this one was opened from on a touch.
+*
+* @param pressed bool whether the screen is touched
+* @param t_x uint16_t
+* @param t_y uint16_t
+*
+* @return none
+*
+* @note Used by the info and WiFi failure pages, both opened from the settings.
+*/
+void backOnTouch(bool pressed, uint16_t t_x, uint16_t t_y)
+{
+  if (pressed)
+  {
+    routerBack();
+  }
+}
+
+/**
+* @brief This function goes to the home screen on a touch.
+*
+* @param pressed bool whether the screen is touched
+* @param t_x uint16_t
+* @param t_y uint16_t
+*
+* @return none
+*
+* @note none
+*/
+void homeOnTouch(bool pressed, uint16_t t_x, uint16_t t_y)
+{
+  if (pressed)
+  {
+    routerHome();
+  }
+}
+
+/**
+* @brief This function clears the text pages before a button page is drawn.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void clearScreenExit()
+{
+  tft.fillScreen(generalconfig.backgroundColour);
+}
+
+/**
+* @brief This function tells the user we could not connect to WiFi.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void wifiFailEnter()
+{
+  drawErrorMessage("Could not connect to WiFi. Touch to return.");
+}
+
+/**
+* @brief This function tells the user which JSON config failed to load.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void jsonErrorEnter()
+{
+  tft.fillScreen(TFT_BLACK);
+  tft.setCursor(0, 0);
+  tft.setTextFont(2);
+  tft.setTextSize(1);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+
+  tft.printf("  %s failed to load and might be corrupted.\n", jsonfilefail);
+  tft.println("  You can reset that specific file to default by opening the serial monitor");
+  tft.printf("  and typing \"reset %s\"\n", jsonfilefail);
+  tft.println("  If you don't do this, the configurator will fail to load.");
+}
+
+const Screen infoScreen = {printinfo, clearScreenExit, backOnTouch, nullptr, false};
+const Screen wifiFailScreen = {wifiFailEnter, clearScreenExit, backOnTouch, nullptr, false};
+const Screen jsonErrorScreen = {jsonErrorEnter, clearScreenExit, homeOnTouch, nullptr, false};
+
+/**
+* @brief This function registers all screens with the router.
+*
+* @param none
+*
+* @return none
+*
+* @note Call once in setup(), before the first page is shown.
+*/
+void screensSetup()
+{
+  routerRegister(PAGE_HOME, &buttonPageScreen);
+  routerRegister(1, &buttonPageScreen); // All menus
+  routerRegister(PAGE_SETTINGS, &buttonPageScreen);
+  routerRegister(PAGE_CONFIGMODE, &configModeScreen);
+  routerRegister(PAGE_INFO, &infoScreen);
+  routerRegister(PAGE_WIFIFAIL, &wifiFailScreen);
+  routerRegister(PAGE_JSONERROR, &jsonErrorScreen);
+}
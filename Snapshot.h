@@ -0,0 +1,136 @@
+/*
+ * Warm resume from deep sleep.
+ *
+ * Before going to deep sleep the parsed configuration, the current page and
+ * the menu on screen are copied into RTC slow memory, which keeps its contents
+ * during deep sleep. When we wake from deep sleep and the snapshot is valid,
+ * setup() adopts it instead of checking and parsing the JSON files again.
+ *
+ * A snapshot is only used once and only after a deep sleep wake, so a restart
+ * (e.g. after changing the config) always loads the files.
+ */
+
+#include "esp_rom_crc.h"
+
+#define SNAPSHOT_MAGIC 0x53445446 // "FTDS"
+#define SNAPSHOT_VERSION 5
+
+struct Snapshot
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  Config generalconfig;
+  Wificonfig wificonfig;
+  Generallogos generallogo;
+  Logos homescreen;
+  uint8_t homelinks[BUTTONS_PER_PAGE - 1];
+  uint8_t latchbits[(LATCH_COUNT + 7) / 8];
+  int16_t page;
+  uint8_t navStack[NAV_STACK_DEPTH];
+  uint8_t navDepth;
+  int16_t menupage; // The menu in "menu", 0 if the page was not a menu
+  Menu menu;
+  uint32_t crc; // Over everything above
+};
+
+RTC_DATA_ATTR Snapshot snapshot;
+
+/**
+* @brief This function returns the checksum of the snapshot.
+*
+* @param none
+*
+* @return uint32_t
+*
+* @note none
+*/
+uint32_t snapshotCrc()
+{
+  return esp_rom_crc32_le(0, (const uint8_t *)&snapshot, offsetof(Snapshot, crc));
+}
+
+/**
+* @brief This function stores the runtime state in RTC memory.
+*
+* @param none
+*
+* @return none
+*
+* @note Call right before esp_deep_sleep_start().
+*/
+void snapshotSave()
+{
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.magic = SNAPSHOT_MAGIC;
+  snapshot.version = SNAPSHOT_VERSION;
+  snapshot.size = sizeof(snapshot);
+  snapshot.generalconfig = generalconfig;
+  snapshot.wificonfig = wificonfig;
+  snapshot.generallogo = generallogo;
+  snapshot.homescreen = homescreen;
+  memcpy(snapshot.homelinks, homelinks, sizeof(snapshot.homelinks));
+  memcpy(snapshot.latchbits, latchbits, sizeof(snapshot.latchbits));
+  snapshot.page = pageNum;
+  memcpy(snapshot.navStack, navStack, sizeof(snapshot.navStack));
+  snapshot.navDepth = navDepth;
+
+  struct Menu *menu = getMenu(pageNum);
+  if (menu)
+  {
+    snapshot.menupage = pageNum;
+    snapshot.menu = *menu;
+  }
+
+  snapshot.crc = snapshotCrc();
+  Serial.printf("[INFO]: Saved a %u byte snapshot for warm resume.\n", sizeof(snapshot));
+}
+
+/**
+* @brief This function restores the runtime state from RTC memory.
+*
+* @param none
+*
+* @return True if a valid snapshot was adopted. False if the config files
+*         need to be loaded.
+*
+* @note Call in setup(), before any config is loaded. The snapshot is
+*       invalidated, so it is never used twice.
+*/
+bool snapshotRestore()
+{
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_EXT0)
+  {
+    snapshot.magic = 0;
+    return false;
+  }
+
+  if (snapshot.magic != SNAPSHOT_MAGIC || snapshot.version != SNAPSHOT_VERSION ||
+      snapshot.size != sizeof(snapshot) || snapshot.crc != snapshotCrc())
+  {
+    Serial.println("[WARNING]: No valid snapshot, loading the config files.");
+    snapshot.magic = 0;
+    return false;
+  }
+
+  generalconfig = snapshot.generalconfig;
+  wificonfig = snapshot.wificonfig;
+  generallogo = snapshot.generallogo;
+  homescreen = snapshot.homescreen;
+  memcpy(homelinks, snapshot.homelinks, sizeof(homelinks));
+  memcpy(latchbits, snapshot.latchbits, sizeof(latchbits));
+  pageNum = snapshot.page;
+  memcpy(navStack, snapshot.navStack, sizeof(navStack));
+  navDepth = snapshot.navDepth;
+
+  if (isMenuPage(snapshot.menupage))
+  {
+    menuCache[0] = snapshot.menu;
+    menuCachePage[0] = snapshot.menupage;
+    menuCacheUsed[0] = ++menuCacheClock;
+  }
+
+  snapshot.magic = 0;
+  Serial.println("[INFO]: Warm resume, config restored from snapshot.");
+  return true;
+}
@@ -0,0 +1,148 @@
+/*
+ * Standby: the display and backlight are switched off and the ESP32 light sleeps
+ * until the screen is touched. RAM, the current page and the BLE bond are kept,
+ * so waking up only has to switch the display back on.
+ *
+ * If standby lasts longer than generalconfig.deepsleeptimer minutes, the caller
+ * goes to deep sleep instead (see goToSleep()).
+ */
+
+#ifdef touchInterruptPin
+
+#include "driver/gpio.h"
+
+// How often the deep sleep timeout is checked while in standby
+#define STANDBY_CHECK_MS 1000
+
+// How often the touch IRQ is polled if we can not light sleep (BLE connected)
+#define STANDBY_POLL_MS 20
+
+/**
+* @brief This function switches off the backlight and puts the panel to sleep.
+*
+* @param none
+*
+* @return none
+*
+* @note The panel keeps its frame memory, so nothing needs to be redrawn on wake.
+*/
+void displaySleep()
+{
+#ifdef WAVESHARE_ESP32S3_TOUCH_LCD_43B
+  ioexp.digitalWrite(2, LOW);
+#else
+  ledcWrite(0, 0);
+  tft.writecommand(TFT_DISPOFF);
+  tft.writecommand(TFT_SLPIN);
+#endif // defined(WAVESHARE_ESP32S3_TOUCH_LCD_43B)
+}
+
+/**
+* @brief This function wakes the panel and restores the backlight brightness.
+*
+* @param none
+*
+* @return none
+*
+* @note none
+*/
+void displayWake()
+{
+#ifdef WAVESHARE_ESP32S3_TOUCH_LCD_43B
+  ioexp.digitalWrite(2, HIGH);
+#else
+  tft.writecommand(TFT_SLPOUT);
+  delay(5); // The panel needs 5 ms after sleep out before the next command
+  tft.writecommand(TFT_DISPON);
+  ledcWrite(0, ledBrightness);
+#endif // defined(WAVESHARE_ESP32S3_TOUCH_LCD_43B)
+}
+
+/**
+* @brief This function checks if we can light sleep without losing the host.
+*
+* @param none
+*
+* @return bool
+*
+* @note Light sleep stops the BLE controller unless it is built with modem
+         sleep, which would drop the connection. USB and WiFi (the configurator,
+         or the webhooks until webhookStopWifi()) need the CPU awake.
+*/
+bool standbyCanLightSleep()
+{
+  if (wifiState != WIFI_STATE_OFF)
+  {
+    return false;
+  }
+#if defined(USEUSBHID)
+  if (usbKeyboardReady())
+  {
+    return false;
+  }
+#endif
+#if defined(CONFIG_BTDM_CTRL_MODEM_SLEEP) || defined(CONFIG_BT_CTRL_MODEM_SLEEP)
+  return true;
+#else
+  return !bleKeyboard.isConnected();
+#endif
+}
+
+/**
+* @brief This function enters standby and returns when the screen is touched
+         or the deep sleep timeout has passed.
+*
+* @param none
+*
+* @return True if woken by a touch. False if the deep sleep timeout has passed.
+*
+* @note Runs on the UI task, nothing is drawn while in standby.
+*/
+bool standby()
+{
+  Serial.println("[INFO]: Entering standby.");
+  displaySleep();
+  bleKeyboard.setLowLatency(false); // Nothing is typed in standby, save power
+
+  unsigned long start = millis();
+  unsigned long deepsleepinterval = generalconfig.deepsleeptimer * 60000UL;
+  bool woken = true;
+
+  gpio_wakeup_enable(touchInterruptPin, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+
+  while (digitalRead(touchInterruptPin) == HIGH)
+  {
+    if (deepsleepinterval > 0 && millis() - start > deepsleepinterval)
+    {
+      woken = false;
+      break;
+    }
+
+    if (standbyCanLightSleep())
+    {
+      esp_sleep_enable_timer_wakeup(STANDBY_CHECK_MS * 1000ULL);
+      esp_light_sleep_start();
+    }
+    else
+    {
+      vTaskDelay(pdMS_TO_TICKS(STANDBY_POLL_MS));
+    }
+  }
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+  gpio_wakeup_disable(touchInterruptPin);
+
+  bleKeyboard.setLowLatency(true);
+  bleKeyboard.reconnect(); // Only does something if the host went away while we slept
+
+  if (woken)
+  {
+    displayWake();
+    Serial.printf("[INFO]: Woke from standby after %lu s.\n", (millis() - start) / 1000);
+  }
+  return woken;
+}
+
+#endif // defined(touchInterruptPin)
@@ -0,0 +1,273 @@
+/*
+ * FreeTouchDeck runs as a set of FreeRTOS tasks instead of one polling loop():
+ *
+ *   input        - samples the touch screen and sends the samples to the UI task
+ *   ui           - owns the display: handles touches, switches pages, draws
+ *   hid          - sends the actions of a pressed button to the host
+ *   housekeeping - serial commands and the sleep timer
+ *   webhook      - sends HTTP requests for buttons, see Webhook.h
+ *
+ * The tasks only talk to each other over the queues below. The BLE stack and WiFi
+ * run on core 0, so the HID task sits next to them. Touch sampling and drawing run
+ * on core 1 (the Arduino core), touch sampling with the highest priority.
+ */
+
+// Core affinity
+#define INPUT_TASK_CORE 1
+#define UI_TASK_CORE 1
+#define HID_TASK_CORE 0
+#define HOUSEKEEPING_TASK_CORE 0
+#define WEBHOOK_TASK_CORE 0
+
+// Priorities (higher number is higher priority)
+#define INPUT_TASK_PRIORITY 5
+#define HID_TASK_PRIORITY 4
+#define UI_TASK_PRIORITY 2
+#define HOUSEKEEPING_TASK_PRIORITY 1
+#define WEBHOOK_TASK_PRIORITY 1
+
+// Stack sizes in bytes
+#define INPUT_TASK_STACK 3072
+#define UI_TASK_STACK 8192
+#define HID_TASK_STACK 6144
+#define HOUSEKEEPING_TASK_STACK 6144
+#define WEBHOOK_TASK_STACK 6144
+
+// Timing
+#define INPUT_POLL_MS 10          // Touch sample rate
+#define UI_TICK_MS 20             // Max time the UI task waits for an event
+#define HOUSEKEEPING_PERIOD_MS 50 // Serial and sleep timer check rate
+
+// Queue lengths
+#define UI_QUEUE_LENGTH 16
+#define HID_QUEUE_LENGTH 8
+
+// Events handled by the UI task
+#define UI_EVENT_TOUCH 0   // A touch sample (pressed, x, y)
+#define UI_EVENT_PAGE 1    // Switch to page (value)
+#define UI_EVENT_SPECIAL 2 // Run special function (value), see case 11 in Action.h
+#define UI_EVENT_SLEEP 3   // The sleep timer has ended
+#define UI_EVENT_OPEN 4    // Open page (value) on top of the current one, see case 14 in Action.h
+#define UI_EVENT_TRIGGER 5 // Run a button (value), see BleControl.h
+#define UI_EVENT_CONFIG 6  // Apply the config patches, see BleControl.h
+#define UI_EVENT_RELOAD 7  // Apply a saved config file (value), see configReload() in ConfigHelper.h
+#define UI_EVENT_WIFI 8    // Connect to WiFi for the webhooks, see Webhook.h
+#define UI_EVENT_WIFIOFF 9 // Turn WiFi off, the webhooks are idle, see Webhook.h
+
+// Values of UI_EVENT_RELOAD besides the menu pages and PAGE_HOME (homescreen.json)
+#define RELOAD_GENERAL -1
+#define RELOAD_WIFI -2
+
+struct UiEvent
+{
+  uint8_t type;
+  bool pressed;
+  uint16_t x;
+  uint16_t y;
+  int16_t value;
+};
+
+// A job for the HID task: run the macro of a menu button and release all keys
+// The macro is read from flash, so the menu may leave the cache before it runs
+// Or, with slot HID_SLOT_COMPILE: compile the macros of a menu, see queueCompile()
+#define HID_SLOT_COMPILE 0xFF
+
+struct HidJob
+{
+  int16_t page;
+  uint8_t slot;        // button * 2, plus 1 for the long press
+  bool repeat;         // From a hold-to-repeat button, see macroRun()
+  uint32_t generation; // hidCancelGeneration when it was queued, see hidCancelled()
+};
+
+QueueHandle_t uiQueue = nullptr;
+QueueHandle_t hidQueue = nullptr;
+
+TaskHandle_t inputTaskHandle = nullptr;
+TaskHandle_t uiTaskHandle = nullptr;
+TaskHandle_t hidTaskHandle = nullptr;
+TaskHandle_t housekeepingTaskHandle = nullptr;
+
+// Counts the calls of cancelActions(). A job that was queued before the last
+// one is cancelled, see hidCancelled(). Never reset.
+volatile uint32_t hidCancelGeneration = 0;
+
+// The generation of the job the HID task is running
+volatile uint32_t hidRunningGeneration = 0;
+
+// Set while a file is being typed, a new touch stops it
+volatile bool hidTypingFile = false;
+
+/**
+* @brief This function sends an event to the UI task.
+*
+* @param type uint8_t one of the UI_EVENT_* types
+* @param value int16_t
+*
+* @return True if the event was queued. False otherwise.
+*
+* @note Does not block. Safe to call from any task.
+*/
+bool postUiEvent(uint8_t type, int16_t value)
+{
+  if (uiQueue == nullptr)
+  {
+    return false;
+  }
+  UiEvent event = {type, false, 0, 0, value};
+  return xQueueSend(uiQueue, &event, 0) == pdTRUE;
+}
+
+bool macroCompileMenu(int page); // Macro.h
+
+/**
+* @brief This function stops the action set the HID task is running and drops
+         the queued ones.
+*
+* @param none
+*
+* @return none
+*
+* @note Does not block. Safe to call from any task. The running set stops at
+        its next action or wait, all keys are released. The queued sets are
+        skipped by the HID task, the queued compiles still run.
+*/
+void cancelActions()
+{
+  if (hidQueue == nullptr)
+  {
+    return;
+  }
+  hidCancelGeneration++;
+  bleKeyboard.clearReports(); // The rest of a text that is still queued
+
+  xTaskNotifyGive(hidTaskHandle); // Ends a running actionDelay()
+  Serial.println("[INFO]: Running actions cancelled");
+}
+
+/**
+* @brief This function checks if the job the HID task is running was cancelled.
+*
+* @param none
+*
+* @return True on the HID task after cancelActions() was called for the
+          running job. False otherwise, also on any other task.
+*
+* @note Only the cancel handshake changes the generations: a cancel made
+        after the job was queued is never lost, and one made while the HID
+        task was idle does not stop the next job or actions on other tasks.
+*/
+bool hidCancelled()
+{
+  return hidTaskHandle != nullptr && xTaskGetCurrentTaskHandle() == hidTaskHandle &&
+         hidRunningGeneration != hidCancelGeneration;
+}
+
+/**
+* @brief This function waits between actions.
+*
+* @param ms uint32_t
+*
+* @return True if the wait has passed. False if the actions were cancelled.
+*
+* @note Use this instead of delay() in actions. On the HID task the wait ends
+        early when cancelActions() is called.
+*/
+bool actionDelay(uint32_t ms)
+{
+  if (hidTaskHandle == nullptr || xTaskGetCurrentTaskHandle() != hidTaskHandle)
+  {
+    delay(ms);
+    return true;
+  }
+  // A notification left over from an earlier cancel only wakes us early once
+  uint32_t start = millis();
+  while (!hidCancelled())
+  {
+    uint32_t waited = millis() - start;
+    if (waited >= ms)
+    {
+      return true;
+    }
+    TickType_t ticks = pdMS_TO_TICKS(ms - waited);
+    ulTaskNotifyTake(pdTRUE, ticks ? ticks : 1);
+  }
+  return false;
+}
+
+/**
+* @brief This function sends the macro of a menu button to the HID task.
+*
+* @param button const struct Button *
+* @param page int16_t the menu of the button
+* @param b uint8_t the index of the button
+* @param longpress bool send the long-press macro
+*
+* @return True if the job was queued. False if the HID task is too far behind.
+*
+* @note Does not block. Safe to call from any task and from esp_timer callbacks.
+*/
+bool queueMacro(const struct Button *button, int16_t page, uint8_t b, bool longpress)
+{
+  if (hidQueue == nullptr)
+  {
+    return false;
+  }
+  if (button->flags & (longpress ? BUTTON_LONGSTOPS : BUTTON_STOPS))
+  {
+    // "Stop running actions" must not wait behind the actions it stops
+    cancelActions();
+    return true;
+  }
+  HidJob job = {page, (uint8_t)(b * 2 + (longpress ? 1 : 0)), button->pressmode == PRESSMODE_REPEAT,
+                hidCancelGeneration};
+  if (xQueueSend(hidQueue, &job, 0) != pdTRUE)
+  {
+    Serial.println("[WARNING]: HID queue full, action dropped");
+    return false;
+  }
+  return true;
+}
+
+/**
+* @brief This function has the HID task compile the macros of a menu, then
+         reload the menu on the UI task.
+*
+* @param page int16_t
+*
+* @return none
+*
+* @note Call after a menuX.json has been saved. The HID task reads the macro
+        file while it runs a macro, so only it writes the file. Waits up to a
+        second if the HID queue is full.
+*/
+void queueCompile(int16_t page)
+{
+  if (hidQueue == nullptr)
+  {
+    macroCompileMenu(page);
+    postUiEvent(UI_EVENT_RELOAD, page);
+    return;
+  }
+  HidJob job = {page, HID_SLOT_COMPILE, false, hidCancelGeneration};
+  if (xQueueSend(hidQueue, &job, pdMS_TO_TICKS(1000)) != pdTRUE)
+  {
+    // Loading the menu compiles it, as its macro file is out of date
+    Serial.printf("[WARNING]: HID queue full, menu %d is compiled when it is loaded\n", page);
+    postUiEvent(UI_EVENT_RELOAD, page);
+  }
+}
+
+/**
+* @brief This function checks if we are running on the UI task.
+*
+* @param none
+*
+* @return True when called from the UI task (or before the tasks are started).
+*
+* @note Only the UI task may draw.
+*/
+bool onUiTask()
+{
+  return uiTaskHandle == nullptr || xTaskGetCurrentTaskHandle() == uiTaskHandle;
+}
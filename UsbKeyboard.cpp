@@ -0,0 +1,61 @@
+#include "UsbKeyboard.h"
+#include "sdkconfig.h"
+
+#if CONFIG_TINYUSB_HID_ENABLED
+
+#include <string.h>
+#include "USB.h"
+#include "USBHIDKeyboard.h"
+#include "USBHIDConsumerControl.h"
+
+// Made in usbKeyboardBegin(): their constructors add the HID interfaces to the
+// USB descriptor, which must not happen in builds without USEUSBHID
+static USBHIDKeyboard* keyboard = nullptr;
+static USBHIDConsumerControl* consumer = nullptr;
+
+// The consumer usages of the media key bits, in the order of the BLE report map
+static const uint16_t mediaUsages[16] = {
+  0x00B5, 0x00B6, 0x00B7, 0x00CD, 0x00E2, 0x00E9, 0x00EA, 0x0223,
+  0x0194, 0x0192, 0x022A, 0x0221, 0x0226, 0x0224, 0x0183, 0x018A
+};
+
+void usbKeyboardBegin(void) {
+  if (keyboard != nullptr) return;
+  keyboard = new USBHIDKeyboard();
+  consumer = new USBHIDConsumerControl();
+  keyboard->begin();
+  consumer->begin();
+  USB.begin();
+}
+
+bool usbKeyboardReady(void) {
+  return keyboard != nullptr && USB && !tud_suspended();
+}
+
+bool usbKeyboardSendKeys(uint8_t modifiers, const uint8_t* keys) {
+  if (keyboard == nullptr) return false;
+  KeyReport report;
+  report.modifiers = modifiers;
+  report.reserved = 0;
+  memcpy(report.keys, keys, sizeof(report.keys));
+  keyboard->sendReport(&report);
+  return true;
+}
+
+// The consumer control report holds one usage, the lowest media key that is down
+bool usbKeyboardSendMedia(uint16_t bits) {
+  if (consumer == nullptr) return false;
+  for (uint8_t i = 0; i < 16; i++) {
+    if (bits & (1 << i)) return consumer->press(mediaUsages[i]) > 0;
+  }
+  return consumer->release() > 0;
+}
+
+#else // The board has no USB HID, reports always go over BLE
+
+void usbKeyboardBegin(void) {}
+bool usbKeyboardReady(void) { return false; }
+bool usbKeyboardSendKeys(uint8_t modifiers, const uint8_t* keys) { (void)modifiers; (void)keys; return false; }
+bool usbKeyboardSendMedia(uint16_t bits) { (void)bits; return false; }
+
+#endif // CONFIG_TINYUSB_HID_ENABLED
@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+
+// USB HID backend. BleKeyboard builds the reports and hands them to these
+// functions through a HidRoute while USB is mounted, so both transports share
+// the key state and the keyboard layouts.
+//
+// This header does not include the USB HID library: its KeyReport and key
+// defines clash with HIDTypes.h, so only UsbKeyboard.cpp sees them.
+
+void usbKeyboardBegin(void);
+bool usbKeyboardReady(void);                                  // Mounted and not suspended
+bool usbKeyboardSendKeys(uint8_t modifiers, const uint8_t* keys); // keys: the 6 keys of a boot report
+bool usbKeyboardSendMedia(uint16_t bits);                      // The media key bits, see HIDTypes.h
@@ -5,7 +5,8 @@
  * 
  */
 
-// After any action you might need a delay, this delay (in ms) is defined here:
+// After any action you might need a delay, this delay (in ms) is defined here.
+// Wait with actionDelay() instead of delay(), so "Stop running actions" can end the wait.
 #define USER_ACTION_DELAY 50
 
 // Function used to print large pieces of text.
@@ -15,7 +16,7 @@ void userAction1(){
 
   // (All OS) This functions prints a large string of text to the active window.
   printLargeString("This is an example of printing long pieces of text.");
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.write(KEY_RETURN);
   printLargeString("After KEY_RETURN it will print on a new line.");
   
@@ -30,10 +31,10 @@ void userAction3(){
   // (Windows Only) This function rickroll's you.
 
   bleKeyboard.press(KEY_LEFT_GUI);
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.print("r");
   bleKeyboard.releaseAll();
-  delay(500);
+  actionDelay(500);
   printLargeString("https://youtu.be/dQw4w9WgXcQ");
   bleKeyboard.write(KEY_RETURN);
   
@@ -44,10 +45,10 @@ void userAction4(){
   // (Mac Only) This function rickroll's you.
 
   bleKeyboard.press(KEY_LEFT_GUI);
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.print(" ");
   bleKeyboard.releaseAll();
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   printLargeString("https://youtu.be/dQw4w9WgXcQ");
   bleKeyboard.write(KEY_RETURN);
   
@@ -58,16 +59,16 @@ void userAction5(){
   // (Mac only) This opens a new file in Sublime (has to be installed off course and pastes the last thing you copied to the clipboard.
   // I use this to select pieces of text and copy them to a new file.
   bleKeyboard.press(KEY_LEFT_GUI);
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.print(" ");
   bleKeyboard.releaseAll();
   printLargeString("Sublime");
   bleKeyboard.write(KEY_RETURN);
-  delay(500);
+  actionDelay(500);
   bleKeyboard.press(KEY_LEFT_GUI);
   bleKeyboard.print("n");
   bleKeyboard.releaseAll();
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.press(KEY_LEFT_GUI);
   bleKeyboard.print("v");
   bleKeyboard.releaseAll();
@@ -79,13 +80,13 @@ void userAction6(){
   // (Windows only) This opens a new file in Sublime (has to be installed off course and pastes the last thing you copied to the clipboard.
   // I use this to select pieces of text and copy them to a new file.
   bleKeyboard.press(KEY_LEFT_GUI);
-  delay(USER_ACTION_DELAY);
+  actionDelay(USER_ACTION_DELAY);
   bleKeyboard.print("r");
   bleKeyboard.releaseAll();
-  delay(500);
+  actionDelay(500);
   printLargeString("notepad");
   bleKeyboard.write(KEY_RETURN);
-  delay(500);
+  actionDelay(500);
   bleKeyboard.press(KEY_LEFT_CTRL);
   bleKeyboard.print("v");
   bleKeyboard.releaseAll();
@@ -100,16 +101,16 @@ void userAction7(){
 
 
 
-/* A simple function to print large strings using bleKeyboard. The function has a delay
- * between keypresses to not miss any, or hang on 1.
+/* A simple function to print large strings using bleKeyboard. The text is sent in
+ * chunks, bleKeyboard paces the keys so none are missed, and a cancel stops between chunks.
 */
 
 void printLargeString(const char string[]){
 
-  for(int i=0; i < strlen(string); i++ ) {
-    char c = string[i];
-    bleKeyboard.print(c);
-    delay(10); // 10ms is on most systems enough to not miss a character
+  size_t length = strlen(string);
+  for(size_t i = 0; i < length && !hidCancelled(); i += TEXT_CHUNK) {
+    size_t count = length - i < TEXT_CHUNK ? length - i : TEXT_CHUNK;
+    bleKeyboard.write((const uint8_t *)string + i, count);
   }
   
 }
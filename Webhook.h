@@ -0,0 +1,421 @@
+/*
+ * HTTP requests (webhooks).
+ *
+ * Action 16 and the macro step {"http": "name.json"} send the request that is
+ * described in /uploads/name.json:
+ *
+ *   {
+ *     "method": "POST",
+ *     "url": "http://192.168.1.10:8123/api/webhook/desk",
+ *     "body": "{\"page\": {page}, \"button\": {button}, \"latch\": {latch}}",
+ *     "headers": {"Content-Type": "application/json"}
+ *   }
+ *
+ * The method defaults to GET, body and headers are optional. In the body
+ * {page} and {button} (0 to 4) are replaced by the button whose macro sends the
+ * request, {latch} by its latch state (0 or 1) and {uptime} by the seconds
+ * since boot.
+ *
+ * The HID task only queues the request and the webhook task sends it, so keys
+ * never wait for the network. Connections are kept open (keep-alive) in a small
+ * pool, one per host and port, and reused by the next request to that host.
+ * If WiFi is not up, the webhook task asks the UI task to connect as a station
+ * with the BLE keyboard kept running, see wifiStart(). After WEBHOOK_IDLE_MS
+ * without a request it asks the UI task to turn WiFi off again, so standby can
+ * light sleep. WiFi that the configurator uses stays on.
+ *
+ * Only http:// is supported, there is no certificate store for https.
+ */
+
+#include <HTTPClient.h>
+
+#define WEBHOOK_QUEUE_LENGTH 4
+#define WEBHOOK_POOL_SIZE 2        // Hosts we keep a connection open to
+#define WEBHOOK_TIMEOUT_MS 5000    // Longest wait for a response
+#define WEBHOOK_WIFI_WAIT_MS 15000 // Longest wait for WiFi before a request fails
+#define WEBHOOK_IDLE_MS 30000      // An open connection is closed, and WiFi turned off, after this long unused
+#define WEBHOOK_BODY_MAX 2048      // Longer responses are not read, their connection is closed
+
+struct WebhookJob
+{
+  char name[MACRO_FILENAME_MAX + 1];
+  int16_t page;
+  uint8_t button;
+  bool latched;
+};
+
+struct WebhookStats
+{
+  uint32_t sent;    // Requests that got a response (any status)
+  uint32_t failed;  // Requests that got no response, had no WiFi or no valid file
+  uint32_t errors;  // Responses with status 400 and up
+  uint32_t reused;  // Requests sent over a connection that was kept open
+  uint32_t dropped; // Requests dropped because the queue was full
+  uint32_t lastMs;  // Latency of the last request
+  uint32_t maxMs;   // Highest latency
+  uint64_t totalMs; // All latencies, for the average
+};
+
+struct WebhookConnection
+{
+  char host[64]; // Empty when unused
+  uint16_t port;
+  uint32_t lastUsed;
+  WiFiClient client;
+};
+
+QueueHandle_t webhookQueueHandle = nullptr;
+TaskHandle_t webhookTaskHandle = nullptr;
+
+WebhookStats webhookStats = {};
+WebhookConnection webhookPool[WEBHOOK_POOL_SIZE];
+volatile uint32_t webhookLastRequest = 0; // millis() of the last request, 0 before the first
+
+/**
+* @brief This function queues the request in /uploads/name for the webhook task.
+*
+* @param name const char * the file name
+*
+* @return True if the request was queued. False otherwise.
+*
+* @note Does not block. Called on the HID task for action 16 and the "http"
+         macro step, the request is sent for the button whose macro is running.
+*/
+bool webhookQueue(const char *name)
+{
+  if (webhookQueueHandle == nullptr || strlen(name) == 0 || strlen(name) > MACRO_FILENAME_MAX)
+  {
+    return false;
+  }
+
+  WebhookJob job;
+  strlcpy(job.name, name, sizeof(job.name));
+  job.page = macroPage;
+  job.button = macroButton;
+  job.latched = isLatched(macroPage, macroButton);
+
+  if (xQueueSend(webhookQueueHandle, &job, 0) != pdTRUE)
+  {
+    webhookStats.dropped++;
+    Serial.printf("[WARNING]: Webhook %s dropped, too many requests waiting\n", name);
+    return false;
+  }
+  return true;
+}
+
+/**
+* @brief This function starts WiFi for the webhooks.
+*
+* @param none
+*
+* @return none
+*
+* @note Runs on the UI task, see UI_EVENT_WIFI. Connects as a station and keeps
+         BLE running. Does nothing if WiFi is already up or in config mode.
+*/
+void webhookStartWifi()
+{
+  if ((wifiState != WIFI_STATE_OFF && wifiState != WIFI_STATE_FAILED) || pageNum == PAGE_CONFIGMODE)
+  {
+    return;
+  }
+  if (strcmp(wificonfig.wifimode, "WIFI_STA") != 0 || String(wificonfig.ssid) == "YOUR_WIFI_SSID" ||
+      String(wificonfig.ssid) == "FAILED")
+  {
+    Serial.println("[WARNING]: Webhooks need WiFi in WIFI_STA mode, set it up in wificonfig.json");
+    return;
+  }
+  wifiStart(false, false);
+}
+
+/**
+* @brief This function checks if the webhooks are done with WiFi.
+*
+* @param none
+*
+* @return True if WiFi is on only for the webhooks and no request was sent for
+          WEBHOOK_IDLE_MS. False otherwise.
+*
+* @note The configurator needs WiFi while it runs or config mode connects.
+*/
+bool webhookWifiIdle()
+{
+  if (wifiState == WIFI_STATE_OFF || wifiWebserverStarted || pageNum == PAGE_CONFIGMODE)
+  {
+    return false;
+  }
+  if (webhookLastRequest == 0 || millis() - webhookLastRequest <= WEBHOOK_IDLE_MS)
+  {
+    return false;
+  }
+  return webhookQueueHandle == nullptr || uxQueueMessagesWaiting(webhookQueueHandle) == 0;
+}
+
+/**
+* @brief This function turns WiFi off when the webhooks are done with it.
+*
+* @param none
+*
+* @return none
+*
+* @note Runs on the UI task, see UI_EVENT_WIFIOFF. Checks again, a request may
+         have been queued since the event was posted.
+*/
+void webhookStopWifi()
+{
+  if (!webhookWifiIdle())
+  {
+    return;
+  }
+  wifiStop();
+  Serial.printf("[INFO]: WiFi off, no webhook for %d s\n", WEBHOOK_IDLE_MS / 1000);
+}
+
+/**
+* @brief This function waits until WiFi is connected.
+*
+* @param none
+*
+* @return True if connected. False after WEBHOOK_WIFI_WAIT_MS.
+*
+* @note Runs on the webhook task.
+*/
+bool webhookWaitForWifi()
+{
+  if (WiFi.status() == WL_CONNECTED)
+  {
+    return true;
+  }
+  postUiEvent(UI_EVENT_WIFI, 0);
+  uint32_t start = millis();
+  while (millis() - start < WEBHOOK_WIFI_WAIT_MS)
+  {
+    vTaskDelay(pdMS_TO_TICKS(100));
+    if (WiFi.status() == WL_CONNECTED)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+* @brief This function returns the pooled connection for a host and port.
+*
+* @param host const String &
+* @param port uint16_t
+*
+* @return WebhookConnection *
+*
+* @note If the host has no connection yet, the least recently used one is
+         closed and handed out.
+*/
+WebhookConnection *webhookConnection(const String &host, uint16_t port)
+{
+  WebhookConnection *oldest = &webhookPool[0];
+  for (uint8_t i = 0; i < WEBHOOK_POOL_SIZE; i++)
+  {
+    WebhookConnection *conn = &webhookPool[i];
+    if (conn->port == port && host == conn->host)
+    {
+      return conn;
+    }
+    if (conn->lastUsed < oldest->lastUsed)
+    {
+      oldest = conn;
+    }
+  }
+  oldest->client.stop();
+  strlcpy(oldest->host, host.c_str(), sizeof(oldest->host));
+  oldest->port = port;
+  return oldest;
+}
+
+/**
+* @brief This function closes the pooled connections that were not used for
+         WEBHOOK_IDLE_MS, and asks the UI task to turn WiFi off once the
+         webhooks are done with it.
+*
+* @param none
+*
+* @return none
+*
+* @note Runs on the webhook task.
+*/
+void webhookCloseIdle()
+{
+  for (uint8_t i = 0; i < WEBHOOK_POOL_SIZE; i++)
+  {
+    WebhookConnection *conn = &webhookPool[i];
+    if (conn->client.connected() && millis() - conn->lastUsed > WEBHOOK_IDLE_MS)
+    {
+      conn->client.stop();
+    }
+  }
+  if (webhookWifiIdle())
+  {
+    postUiEvent(UI_EVENT_WIFIOFF, 0);
+  }
+}
+
+/**
+* @brief This function replaces the placeholders in the body of a request.
+*
+* @param body String &
+* @param job const WebhookJob &
+*
+* @return none
+*
+* @note See the top of this file for the placeholders.
+*/
+void webhookExpand(String &body, const WebhookJob &job)
+{
+  body.replace("{page}", String(job.page));
+  body.replace("{button}", String(job.button));
+  body.replace("{latch}", job.latched ? "1" : "0");
+  body.replace("{uptime}", String(millis() / 1000));
+}
+
+/**
+* @brief This function sends one request.
+*
+* @param job const WebhookJob &
+*
+* @return none
+*
+* @note Runs on the webhook task and blocks it for up to WEBHOOK_TIMEOUT_MS.
+*/
+void webhookSend(const WebhookJob &job)
+{
+  char path[sizeof(job.name) + 9];
+  snprintf(path, sizeof(path), "/uploads/%s", job.name);
+  File file = FILESYSTEM.open(path, "r");
+  if (!file)
+  {
+    Serial.printf("[WARNING]: Webhook %s not found!\n", path);
+    webhookStats.failed++;
+    return;
+  }
+  DynamicJsonDocument doc(1024);
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+
+  String url = doc["url"] | "";
+  if (error || !url.startsWith("http://"))
+  {
+    Serial.printf("[WARNING]: Webhook %s needs an http:// \"url\"\n", job.name);
+    webhookStats.failed++;
+    return;
+  }
+
+  // http://host[:port]/path
+  int hostend = url.indexOf('/', 7);
+  String hostport = url.substring(7, hostend < 0 ? url.length() : hostend);
+  int colon = hostport.indexOf(':');
+  String host = colon < 0 ? hostport : hostport.substring(0, colon);
+  uint16_t port = colon < 0 ? 80 : hostport.substring(colon + 1).toInt();
+
+  String method = doc["method"] | "GET";
+  method.toUpperCase();
+  String body = doc["body"] | "";
+  webhookExpand(body, job);
+
+  if (!webhookWaitForWifi())
+  {
+    Serial.printf("[WARNING]: Webhook %s failed, no WiFi\n", job.name);
+    webhookStats.failed++;
+    return;
+  }
+
+  WebhookConnection *conn = webhookConnection(host, port);
+  bool reused = conn->client.connected();
+
+  HTTPClient http;
+  http.setReuse(true);
+  http.setTimeout(WEBHOOK_TIMEOUT_MS);
+  http.setConnectTimeout(WEBHOOK_TIMEOUT_MS);
+  if (!http.begin(conn->client, url))
+  {
+    Serial.printf("[WARNING]: Webhook %s has an invalid url\n", job.name);
+    webhookStats.failed++;
+    return;
+  }
+  for (JsonPair header : doc["headers"].as<JsonObject>())
+  {
+    http.addHeader(header.key().c_str(), header.value().as<const char *>());
+  }
+
+  uint32_t start = millis();
+  int status = http.sendRequest(method.c_str(), body);
+  uint32_t latency = millis() - start;
+  conn->lastUsed = millis();
+
+  if (status < 0)
+  {
+    Serial.printf("[WARNING]: Webhook %s failed: %s\n", job.name, HTTPClient::errorToString(status).c_str());
+    webhookStats.failed++;
+    http.end();
+    conn->client.stop();
+    return;
+  }
+
+  // Read the response, so the connection can take the next request.
+  // Chunked responses have no size, they are read to their last chunk.
+  bool drained = http.getSize() <= WEBHOOK_BODY_MAX;
+  if (drained)
+  {
+    http.getString();
+  }
+  http.end();
+  if (!drained)
+  {
+    conn->client.stop();
+  }
+
+  webhookStats.sent++;
+  webhookStats.lastMs = latency;
+  webhookStats.maxMs = max(webhookStats.maxMs, latency);
+  webhookStats.totalMs += latency;
+  if (reused)
+  {
+    webhookStats.reused++;
+  }
+  if (status >= 400)
+  {
+    webhookStats.errors++;
+    Serial.printf("[WARNING]: Webhook %s: HTTP %d in %lu ms\n", job.name, status, (unsigned long)latency);
+  }
+  else
+  {
+    Serial.printf("[INFO]: Webhook %s: HTTP %d in %lu ms%s\n", job.name, status, (unsigned long)latency,
+                  reused ? " (kept open)" : "");
+  }
+}
+
+/**
+* @brief This task sends the queued requests.
+*
+* @param pvParameters void * (unused)
+*
+* @return none
+*
+* @note Closes idle connections, and turns WiFi off, while nothing is queued.
+*/
+void webhookTask(void *pvParameters)
+{
+  WebhookJob job;
+
+  for (;;)
+  {
+    if (xQueueReceive(webhookQueueHandle, &job, pdMS_TO_TICKS(1000)) == pdTRUE)
+    {
+      webhookLastRequest = millis() | 1;
+      webhookSend(job);
+      webhookLastRequest = millis() | 1;
+    }
+    else
+    {
+      webhookCloseIdle();
+    }
+  }
+}
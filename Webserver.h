@@ -128,10 +128,10 @@ String handleInfo()
   output += "{\"";
   output += "Keyboard Type";
   output += "\":\"";
-  output += String("Using USB");
+  output += String("USB and BLE");
   output += "\"},";
 
-#else
+#endif //if defined(USEUSBHID)
 
   output += "{\"";
   output += "BLE Keyboard Version";
@@ -139,8 +139,6 @@ String handleInfo()
   output += String(BLE_KEYBOARD_VERSION);
   output += "\"},";
 
-#endif //if defined(USEUSBHID)
-
   output += "{\"";
   output += "ArduinoJson Version";
   output += "\":\"";
@@ -222,8 +220,8 @@ String processor(const String &var)
 }
 
 /**
-* @brief This function handles JSON file uploads. only menu1.json, menu2.json, menu3.json, menu4.json
-*        menu5.json, colors.json, and homescreen.json are accepted.
+* @brief This function handles JSON file uploads. only menuX.json (X = 1 to MENU_MAX),
+*        general.json, homescreen.json and wificonfig.json are accepted.
 *
 * @param *request AsyncWebServerRequest
 * @param filename String
@@ -238,12 +236,15 @@ String processor(const String &var)
 */
 void handleJSONUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)
 {
-  if (filename != "menu1.json" && filename != "menu2.json" && filename != "menu3.json" && filename != "menu4.json" && filename != "menu5.json" && filename != "general.json" && filename != "homescreen.json" && filename != "wificonfig.json")
+  int page = filename.substring(4).toInt();
+  bool ismenu = filename.startsWith("menu") && filename.endsWith(".json") &&
+                filename == "menu" + String(page) + ".json" && isMenuPage(page);
+  if (!ismenu && filename != "general.json" && filename != "homescreen.json" && filename != "wificonfig.json")
   {
     Serial.printf("[INFO]: JSON has invalid name: %s\n", filename.c_str());
     errorCode = "102";
     errorText = "JSON file has an invalid name. You can only upload JSON files with the following file names:";
-    errorText += "<ul><li>menu1.json</li><li>menu2.json</li><li>menu3.json</li><li>menu4.json</li><li>menu5.json</li>";
+    errorText += "<ul><li>menu1.json to menu" + String(MENU_MAX) + ".json</li>";
     errorText += "<li>general.json</li><li>homescreen.json</li><li>wificonfig.json</li></ul>";
     request->send(FILESYSTEM, "/error.htm", String(), false, processor);
     return;
@@ -266,6 +267,22 @@ void handleJSONUpload(AsyncWebServerRequest *request, String filename, size_t in
     Serial.printf("[INFO]: JSON Uploaded: %s\n", filename.c_str());
     // Close the file handle as the upload is now done
     request->_tempFile.close();
+    if (ismenu)
+    {
+      queueCompile(page); // Reloads the menu once compiled
+    }
+    else if (filename.endsWith("general.json"))
+    {
+      postUiEvent(UI_EVENT_RELOAD, RELOAD_GENERAL);
+    }
+    else if (filename.endsWith("homescreen.json"))
+    {
+      postUiEvent(UI_EVENT_RELOAD, PAGE_HOME);
+    }
+    else
+    {
+      postUiEvent(UI_EVENT_RELOAD, RELOAD_WIFI);
+    }
     request->send(FILESYSTEM, "/upload.htm");
   }
 }
@@ -500,6 +517,10 @@ void handlerSetup()
         String sleepTimer = sleeptimer->value().c_str();
         general["sleeptimer"] = sleepTimer.toInt();
 
+        // The configurator has no field for these, keep the current values
+        general["deepsleeptimer"] = generalconfig.deepsleeptimer;
+        general["keyboardlayout"] = generalconfig.keyboardlayout;
+
         //Modifiers
 
         const AsyncWebParameter *modifier1 = request->getParam("modifier1", true);
@@ -559,6 +580,17 @@ void handlerSetup()
         String Attemptdelay = attemptdelay->value().c_str();
         wifi["attemptdelay"] = Attemptdelay.toInt();
 
+        // Older configurator pages have no keepble field, keep the current value then
+        if (request->hasParam("keepble", true))
+        {
+          const AsyncWebParameter *keepble = request->getParam("keepble", true);
+          wifi["keepble"] = String(keepble->value().c_str()) == "true";
+        }
+        else
+        {
+          wifi["keepble"] = wificonfig.keepble;
+        }
+
         if (serializeJsonPretty(doc, file) == 0)
         {
           Serial.println("[WARNING]: Failed to write to file");
@@ -1732,6 +1764,25 @@ void handlerSetup()
         file.close();
       }
 
+
+      // Apply it to the running deck
+      if (savemode == "general")
+      {
+        postUiEvent(UI_EVENT_RELOAD, RELOAD_GENERAL);
+      }
+      else if (savemode == "wifi")
+      {
+        postUiEvent(UI_EVENT_RELOAD, RELOAD_WIFI);
+      }
+      else if (savemode == "homescreen")
+      {
+        postUiEvent(UI_EVENT_RELOAD, PAGE_HOME);
+      }
+      else if (savemode.startsWith("menu"))
+      {
+        queueCompile(savemode.substring(4).toInt()); // Reloads the menu once compiled
+      }
+
       request->send(FILESYSTEM, "/saveconfig.htm");
     }
   });
@@ -0,0 +1,268 @@
+/*
+ * Host test for the reports the actions send.
+ *
+ * bleKeyboardAction() (Action.h) and the userActionN() functions
+ * (UserActions.h) run against the real BleKeyboard, whose reports go to a mock
+ * HidRoute that records them. The recorded trace of every case is compared
+ * with its golden file in golden/, and the report counts and pacing of every
+ * case are printed.
+ *
+ * Time is simulated and only moves in actionDelay(), so the traces do not
+ * depend on the machine. After an intended change of the reports, run
+ *
+ *   hid_trace_test <golden dir> --update
+ *
+ * and review the diff of the golden files.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "BleKeyboard.h"
+
+// The BLE connection interval reports are paced at, in units of 1.25 ms
+#define TRACE_BLE_INTERVAL 6
+
+uint32_t hostClockMs = 0;
+bool hostSerialEcho = false;
+HostSerial Serial;
+
+// The trace of the running case
+std::string trace;
+uint32_t keyReports = 0;
+uint32_t mediaReports = 0;
+
+void traceLine(const char *format, ...)
+{
+  char line[96];
+  int n = snprintf(line, sizeof(line), "%6u ", hostClockMs);
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line + n, sizeof(line) - n, format, args);
+  va_end(args);
+  trace += line;
+  trace += '\n';
+}
+
+bool mockReady() { return true; }
+
+bool mockSendKeys(uint8_t modifiers, const uint8_t *keys)
+{
+  keyReports++;
+  traceLine("keys %02x %02x %02x %02x %02x %02x %02x", modifiers, keys[0], keys[1], keys[2], keys[3], keys[4], keys[5]);
+  return true;
+}
+
+bool mockSendMedia(uint16_t bits)
+{
+  mediaReports++;
+  traceLine("media %04x", bits);
+  return true;
+}
+
+const HidRoute mockRoute = {mockReady, mockSendKeys, mockSendMedia};
+
+// What the actions use from the rest of the sketch. The calls that leave the
+// HID task are recorded in the trace as well.
+
+#define TEXT_CHUNK 32 // As in Macro.h
+#define UI_EVENT_SPECIAL 2 // As in Tasks.h
+#define UI_EVENT_OPEN 4
+#define PAGE_CONFIGMODE 0 // Not opened, see routerGo() below
+
+struct Config
+{
+  bool sleepenable;
+  uint16_t sleeptimer;
+  uint8_t modifier1;
+  uint8_t modifier2;
+  uint8_t modifier3;
+  uint16_t helperdelay;
+};
+
+// The defaults of general.json
+Config generalconfig = {true, 10, KEY_LEFT_ALT, KEY_LEFT_SHIFT, 0, 500};
+
+BleKeyboard bleKeyboard("FreeTouchDeck", "Made by me");
+Preferences savedStates;
+bool hostCancelled = false; // What hidCancelled() returns
+unsigned long Interval = 0;
+int ledBrightness = 255;
+
+bool hidCancelled() { return hostCancelled; }
+
+bool actionDelay(uint32_t ms)
+{
+  if (hidCancelled())
+  {
+    return false;
+  }
+  delay(ms);
+  return true;
+}
+
+bool onUiTask() { return false; }
+
+bool postUiEvent(uint8_t type, int16_t value)
+{
+  traceLine("event %u %d", type, value);
+  return true;
+}
+
+void routerGo(uint8_t page) { (void)page; }
+void cancelActions() {}
+
+bool typeFile(const char *name)
+{
+  traceLine("file %s", name);
+  return true;
+}
+
+bool webhookQueue(const char *name)
+{
+  traceLine("http %s", name);
+  return true;
+}
+
+#include "UserActions.h"
+#include "Keytables.h"
+#include "Action.h"
+
+struct TraceCase
+{
+  const char *name;
+  const char *layout;
+  void (*run)();
+};
+
+const TraceCase cases[] = {
+    {"navigation_return", "us", [] { bleKeyboardAction(2, 7, ""); }},
+    {"media_mute", "us", [] { bleKeyboardAction(3, 1, ""); }},
+    {"text_us", "us", [] { bleKeyboardAction(4, 0, "Hello, World!"); }},
+    {"text_de", "de", [] { bleKeyboardAction(4, 0, "@{^}~ yz"); }},
+    {"text_fr", "fr", [] { bleKeyboardAction(8, 0, "azerty 1234 `~"); }},
+    {"modifier_and_function_key", "us", [] {
+       bleKeyboardAction(5, 1, "");
+       bleKeyboardAction(6, 3, "");
+       bleKeyboardAction(5, 9, "");
+     }},
+    {"number", "us", [] { bleKeyboardAction(7, 1234, ""); }},
+    {"combo", "us", [] {
+       bleKeyboardAction(9, 7, "");
+       bleKeyboardAction(4, 0, "t");
+       bleKeyboardAction(5, 9, "");
+     }},
+    {"helper", "us", [] { bleKeyboardAction(10, 3, ""); }},
+    {"special", "us", [] { bleKeyboardAction(11, 5, ""); }},
+    {"numpad_enter", "us", [] { bleKeyboardAction(12, 14, ""); }},
+    {"open_page", "us", [] { bleKeyboardAction(14, 3, ""); }},
+    {"type_file", "us", [] { bleKeyboardAction(15, 0, "notes.txt"); }},
+    {"http", "us", [] { bleKeyboardAction(16, 0, "lights.json"); }},
+    {"text_utf8", "us", [] {
+       // Text from a file: UTF-8 and the modifier codes must not become keys
+       uint32_t skipped = 0;
+       const char text[] = "Caf\xc3\xa9 \x80\x83\x01ok\r\n";
+       bleKeyboard.writeText((const uint8_t *)text, strlen(text), &skipped);
+       traceLine("skipped %u", skipped);
+     }},
+    {"cancelled", "us", [] {
+       hostCancelled = true;
+       bleKeyboardAction(4, 0, "Not typed");
+       bleKeyboardAction(11, 5, "");
+       hostCancelled = false;
+     }},
+    {"user_action_1", "us", [] { bleKeyboardAction(13, 1, ""); }},
+    {"user_action_2", "us", [] { bleKeyboardAction(13, 2, ""); }},
+    {"user_action_3", "us", [] { bleKeyboardAction(13, 3, ""); }},
+    {"user_action_4", "us", [] { bleKeyboardAction(13, 4, ""); }},
+    {"user_action_5", "us", [] { bleKeyboardAction(13, 5, ""); }},
+    {"user_action_6", "us", [] { bleKeyboardAction(13, 6, ""); }},
+    {"user_action_7", "us", [] { bleKeyboardAction(13, 7, ""); }}};
+
+std::string readFile(const std::string &path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Prints the first line where the trace and the golden file differ
+void printDifference(const std::string &expected, const std::string &got)
+{
+  std::istringstream a(expected), b(got);
+  std::string lineA, lineB;
+  for (int line = 1;; line++)
+  {
+    bool moreA = (bool)std::getline(a, lineA);
+    bool moreB = (bool)std::getline(b, lineB);
+    if (!moreA && !moreB)
+    {
+      return;
+    }
+    if (!moreA || !moreB || lineA != lineB)
+    {
+      printf("  line %d: expected \"%s\"\n", line, moreA ? lineA.c_str() : "(end)");
+      printf("  line %d: got      \"%s\"\n", line, moreB ? lineB.c_str() : "(end)");
+      return;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s <golden dir> [--update]\n", argv[0]);
+    return 2;
+  }
+  std::string golden = argv[1];
+  bool update = argc > 2 && strcmp(argv[2], "--update") == 0;
+
+  bleKeyboard.setRoute(&mockRoute);
+
+  int failures = 0;
+  uint32_t totalReports = 0;
+  uint32_t totalMs = 0;
+  for (const TraceCase &test : cases)
+  {
+    bleKeyboard.setLayout(test.layout);
+    bleKeyboard.releaseAll();
+    trace.clear();
+    keyReports = 0;
+    mediaReports = 0;
+    hostClockMs = 0;
+
+    test.run();
+
+    // Every report waits for its own connection event
+    uint32_t reports = keyReports + mediaReports;
+    uint32_t bleMs = hostClockMs + (reports * TRACE_BLE_INTERVAL * 5 + 3) / 4;
+    printf("%-26s %4u key %2u media reports, %5u ms of delays, %5u ms over BLE\n", test.name, keyReports,
+           mediaReports, hostClockMs, bleMs);
+    totalReports += reports;
+    totalMs += bleMs;
+
+    std::string path = golden + "/" + test.name + ".trace";
+    if (update)
+    {
+      std::ofstream(path) << trace;
+      continue;
+    }
+    std::string expected = readFile(path);
+    if (expected != trace)
+    {
+      printf("%s: the reports differ from %s\n", test.name, path.c_str());
+      printDifference(expected, trace);
+      failures++;
+    }
+  }
+
+  printf("%zu cases, %u reports, %u ms over BLE, %d failures\n", sizeof(cases) / sizeof(cases[0]), totalReports,
+         totalMs, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/*
+ * Host test for KeyLayouts.h: every printable ASCII character of every layout
+ * is checked against a second, independent description of the keyboard.
+ *
+ * Each layout is described the way the keys are printed: for a row of keys
+ * (consecutive HID usages) the characters without modifier, with shift and with
+ * AltGr. A space in a row means the key types nothing with that modifier. The
+ * characters that are dead keys on the host are listed separately.
+ */
+
+#include <initializer_list>
+#include <stdio.h>
+#include <string.h>
+
+#include "KeyLayouts.h"
+
+struct KeyRow
+{
+  uint8_t usage;     // Usage of the first key in the row
+  const char *plain;
+  const char *shift;
+  const char *altgr; // nullptr or shorter than the row when the keys have no AltGr character
+};
+
+struct LayoutDescription
+{
+  const char *name;
+  const KeyRow *rows;
+  const char *dead; // Characters that are dead keys
+};
+
+// The rows that are the same on every layout
+const KeyRow commonRows[] = {
+    {0x2c, " ", nullptr, nullptr}, // Space
+    {0, nullptr, nullptr, nullptr}};
+
+const KeyRow usRows[] = {
+    {0x04, "abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", nullptr},
+    {0x1e, "1234567890", "!@#$%^&*()", nullptr},
+    {0x2d, "-=[]\\", "_+{}|", nullptr},
+    {0x33, ";'`,./", ":\"~<>?", nullptr},
+    {0, nullptr, nullptr, nullptr}};
+
+const KeyRow ukRows[] = {
+    {0x04, "abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", nullptr},
+    {0x1e, "1234567890", "!\" $%^&*()", nullptr}, // Shift+3 is the pound sign
+    {0x2d, "-=[]", "_+{}", nullptr},
+    {0x32, "#;'`,./", "~:@ <>?", nullptr},        // Shift+` is the not sign
+    {0x64, "\\", "|", nullptr},
+    {0, nullptr, nullptr, nullptr}};
+
+const KeyRow deRows[] = {
+    {0x04, "abcdefghijklmnopqrstuvwxzy", "ABCDEFGHIJKLMNOPQRSTUVWXZY", nullptr},
+    {0x14, "", "", "@"},
+    {0x1e, "1234567890", "!\" $%&/()=", "      {[]}"},
+    {0x2d, "   +", "?` *", "\\  ~"},
+    {0x32, "#", "'", nullptr},
+    {0x35, "^", " ", nullptr},
+    {0x36, ",.-", ";:_", nullptr},
+    {0x64, "<", ">", "|"},
+    {0, nullptr, nullptr, nullptr}};
+
+// The dead ^ on 0x2f is not used, AltGr+9 types ^ directly
+const KeyRow frRows[] = {
+    {0x04, "qbcdefghijkl,noparstuvzxyw", "QBCDEFGHIJKL?NOPARSTUVZXYW", nullptr},
+    {0x1e, "& \"'(-", "123456", " ~#{[|"},
+    {0x24, " _  ", "7890", "`\\^@"},
+    {0x2d, ")=", " +", "]}"},
+    {0x30, "$", " ", nullptr},
+    {0x32, "*", " ", nullptr},
+    {0x33, "m", "M", nullptr},
+    {0x34, " ", "%", nullptr},
+    {0x36, ";:!", "./ ", nullptr},
+    {0x64, "<", ">", nullptr},
+    {0, nullptr, nullptr, nullptr}};
+
+const LayoutDescription descriptions[] = {
+    {"us", usRows, ""},
+    {"uk", ukRows, ""},
+    {"de", deRows, "^`"},
+    {"fr", frRows, "`~"}};
+
+int failures = 0;
+
+void fail(const char *layout, const char *format, int c, unsigned got, unsigned want)
+{
+  printf("%s: ", layout);
+  printf(format, c, got, want);
+  printf("\n");
+  failures++;
+}
+
+// Adds one row of characters with the given flags to the expected table
+void expectRow(const char *layout, uint16_t expected[128], uint8_t usage, const char *chars, uint16_t flags)
+{
+  for (size_t i = 0; chars != nullptr && chars[i] != '\0'; i++)
+  {
+    unsigned char c = chars[i];
+    if (c == ' ' && usage + i != 0x2c)
+    {
+      continue;
+    }
+    if (expected[c] != 0)
+    {
+      fail(layout, "'%c' is described twice (0x%03x and 0x%03x)", c, expected[c], (usage + i) | flags);
+    }
+    expected[c] = (usage + i) | flags;
+  }
+}
+
+void checkLayout(const LayoutDescription &description)
+{
+  const uint16_t *map = findKeyLayout(description.name);
+  if (map == nullptr)
+  {
+    printf("%s: layout not found\n", description.name);
+    failures++;
+    return;
+  }
+
+  uint16_t expected[128] = {};
+  for (const KeyRow *rows : {commonRows, description.rows})
+  {
+    for (const KeyRow *row = rows; row->plain != nullptr; row++)
+    {
+      expectRow(description.name, expected, row->usage, row->plain, 0);
+      expectRow(description.name, expected, row->usage, row->shift, LAYOUT_SHIFT);
+      expectRow(description.name, expected, row->usage, row->altgr, LAYOUT_ALTGR);
+    }
+  }
+  for (const char *c = description.dead; *c != '\0'; c++)
+  {
+    expected[(unsigned char)*c] |= LAYOUT_DEAD;
+  }
+
+  for (int c = 0x20; c < 0x7f; c++)
+  {
+    if (expected[c] == 0)
+    {
+      printf("%s: '%c' is not described\n", description.name, c);
+      failures++;
+    }
+    else if (map[c] != expected[c])
+    {
+      fail(description.name, "'%c' is 0x%03x, the keyboard has 0x%03x", c, map[c], expected[c]);
+    }
+  }
+
+  // Control characters the keyboard types on every layout
+  const struct
+  {
+    char c;
+    uint16_t usage;
+  } controls[] = {{'\b', 0x2a}, {'\t', 0x2b}, {'\n', 0x28}};
+  for (const auto &control : controls)
+  {
+    if (map[(unsigned char)control.c] != control.usage)
+    {
+      fail(description.name, "control 0x%02x is 0x%03x, expected 0x%03x", control.c, map[(unsigned char)control.c],
+           control.usage);
+    }
+  }
+  if (map[0x7f] != 0)
+  {
+    fail(description.name, "DEL 0x%02x is 0x%03x, expected 0x%03x", 0x7f, map[0x7f], 0);
+  }
+}
+
+int main()
+{
+  for (const LayoutDescription &description : descriptions)
+  {
+    checkLayout(description);
+  }
+  if (findKeyLayout("xx") != nullptr)
+  {
+    printf("findKeyLayout(\"xx\") should return nullptr\n");
+    failures++;
+  }
+  if (sizeof(descriptions) / sizeof(descriptions[0]) != sizeof(keyLayouts) / sizeof(keyLayouts[0]))
+  {
+    printf("Every layout in keyLayouts needs a description here\n");
+    failures++;
+  }
+
+  printf("%zu layouts, %d failures\n", sizeof(descriptions) / sizeof(descriptions[0]), failures);
+  return failures == 0 ? 0 : 1;
+}
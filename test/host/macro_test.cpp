@@ -0,0 +1,177 @@
+/*
+ * Host test for the macro compiler and interpreter (Macro.h).
+ *
+ * Every case saves a menu config to a file system in RAM, compiles it with
+ * macroCompileMenu() and runs one of its macros with macroRun(). What the
+ * macro does (actions, waits, key reports) is recorded and compared with the
+ * expected steps of the case, so an operand that does not survive the round
+ * trip through the bytecode shows up here.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+#include <Preferences.h>
+
+#include <string>
+
+#include "BleKeyboard.h"
+
+uint32_t hostClockMs = 0;
+bool hostSerialEcho = true; // Shows the warnings of the compiler
+HostSerial Serial;
+
+HostFS hostFs;
+#define FILESYSTEM hostFs
+
+// What the macros did
+std::string trace;
+
+void traceLine(const char *format, ...)
+{
+  char line[96];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  trace += line;
+  trace += '\n';
+}
+
+bool mockReady() { return true; }
+
+bool mockSendKeys(uint8_t modifiers, const uint8_t *keys)
+{
+  traceLine("keys %02x %02x", modifiers, keys[0]);
+  return true;
+}
+
+bool mockSendMedia(uint16_t bits)
+{
+  traceLine("media %04x", bits);
+  return true;
+}
+
+const HidRoute mockRoute = {mockReady, mockSendKeys, mockSendMedia};
+
+// What Macro.h uses from the rest of the sketch
+
+#define BUTTONS_PER_PAGE 6 // As in FreeTouchDeck.ino
+#define UI_EVENT_OPEN 4    // As in Tasks.h
+
+BleKeyboard bleKeyboard("FreeTouchDeck", "Made by me");
+volatile bool hidTypingFile = false;
+
+bool hidCancelled() { return false; }
+
+bool actionDelay(uint32_t ms)
+{
+  traceLine("wait %u", ms);
+  return true;
+}
+
+bool postUiEvent(uint8_t type, int16_t value)
+{
+  traceLine("event %u %d", type, value);
+  return true;
+}
+
+void bleKeyboardAction(int action, int value, const char *symbol)
+{
+  traceLine("action %d %d%s", action, value, symbol);
+}
+
+void pressKeys(const uint8_t *keys, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    bleKeyboard.press(keys[i]);
+  }
+}
+
+bool webhookQueue(const char *name)
+{
+  traceLine("http %s", name);
+  return true;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+  crc = ~crc;
+  while (len--)
+  {
+    crc ^= *buf++;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+#include "Macro.h"
+
+struct MacroCase
+{
+  const char *name;
+  const char *config;   // menu1.json
+  uint8_t slot;         // button * 2, plus 1 for the long press
+  const char *expected; // Without the release at the end
+};
+
+const MacroCase cases[] = {
+    {"action_values", R"({"button0": {"actionarray": [13, 2, 13], "valuearray": [300, 7, 65535]}})", 0,
+     "action 13 300\n"
+     "action 2 7\n"
+     "action 13 65535\n"},
+    {"delay_over_255", R"({"button0": {"actionarray": [1, 1], "valuearray": ["300", 70000]}})", 0,
+     "wait 300\n"
+     "wait 65535\n"
+     "wait 4465\n"},
+    {"values_out_of_range", R"({"button0": {"actionarray": [13, 13, 2], "valuearray": [65536, -1, 7]}})", 0,
+     "action 2 7\n"},
+    {"macro_steps", R"({"button0": {"macro": [{"action": 13, "value": 1000}, {"loop": 2, "steps": [{"tap": "a"}]}]}})",
+     0,
+     "action 13 1000\n"
+     "keys 00 04\n"
+     "keys 00 00\n"
+     "keys 00 04\n"
+     "keys 00 00\n"},
+    {"long_press", R"({"button1": {"actionarray": [2], "valuearray": [1], "longactionarray": [13], "longvaluearray": [256]}})",
+     3,
+     "action 13 256\n"}};
+
+int main()
+{
+  bleKeyboard.setRoute(&mockRoute);
+  bleKeyboard.setLayout("us");
+
+  int failures = 0;
+  for (const MacroCase &test : cases)
+  {
+    // Saved over the last case, so the old macro file is replaced as well
+    File config = hostFs.open("/config/menu1.json", "w");
+    config.write((const uint8_t *)test.config, strlen(test.config));
+    config.close();
+
+    trace.clear();
+    if (!macroCompileMenu(1))
+    {
+      printf("%s: not compiled\n", test.name);
+      failures++;
+      continue;
+    }
+    macroRun(1, test.slot, false);
+
+    // Every macro ends with releasing all keys
+    std::string expected = std::string(test.expected) + "keys 00 00\nmedia 0000\n";
+    if (trace != expected)
+    {
+      printf("%s: expected\n%sgot\n%s", test.name, expected.c_str(), trace.c_str());
+      failures++;
+    }
+  }
+
+  printf("%zu cases, %d failures\n", sizeof(cases) / sizeof(cases[0]), failures);
+  return failures == 0 ? 0 : 1;
+}
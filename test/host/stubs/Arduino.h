@@ -0,0 +1,102 @@
+#pragma once
+/*
+ * The parts of the Arduino core the host tests use. Time is simulated: it only
+ * moves when delay() is called, see hostClockMs in the test.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#include "sdkconfig.h"
+
+extern uint32_t hostClockMs;
+
+inline uint32_t millis() { return hostClockMs; }
+inline uint32_t micros() { return hostClockMs * 1000; }
+inline void delay(uint32_t ms) { hostClockMs += ms; }
+inline void ledcWrite(uint8_t channel, uint32_t duty) { (void)channel; (void)duty; }
+
+using std::max;
+using std::min;
+
+// Only the conversion of numbers the sketch uses
+class String
+{
+public:
+  String(int n) : text(std::to_string(n)) {}
+  String(const char *str = "") : text(str) {}
+  const char *c_str() const { return text.c_str(); }
+
+private:
+  std::string text;
+};
+
+// Print as in the ESP32 core: everything ends up in write(buffer, size)
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+    {
+      if (!write(*buffer++)) break;
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long n) { char buffer[24]; snprintf(buffer, sizeof(buffer), "%ld", n); return write(buffer); }
+  size_t print(int n) { return print((long)n); }
+  size_t print(unsigned long n) { char buffer[24]; snprintf(buffer, sizeof(buffer), "%lu", n); return write(buffer); }
+  size_t print(unsigned int n) { return print((unsigned long)n); }
+  size_t println(void) { return write("\r\n"); }
+  template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+
+  size_t printf(const char *format, ...)
+  {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return n > 0 ? write(buffer) : 0;
+  }
+
+  int getWriteError() { return writeError; }
+  void clearWriteError() { writeError = 0; }
+
+protected:
+  void setWriteError(int error = 1) { writeError = error; }
+
+private:
+  int writeError = 0;
+};
+
+// Serial output is dropped unless the test prints it, see hostSerialEcho
+extern bool hostSerialEcho;
+
+class HostSerial : public Print
+{
+public:
+  size_t write(uint8_t c) override
+  {
+    if (hostSerialEcho) putchar(c);
+    return 1;
+  }
+  using Print::write;
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,318 @@
+#pragma once
+/*
+ * The parts of ArduinoJson 6 that Macro.h uses, for the host tests. A document
+ * is a tree of JsonNodes. JsonVariant, JsonObject and JsonArray are all views
+ * of a node, or of nothing for a missing key, as in ArduinoJson.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct JsonNode
+{
+  enum Type
+  {
+    Null,
+    Number,
+    String,
+    Array,
+    Object
+  } type = Null;
+  long number = 0;
+  std::string text;
+  std::vector<std::unique_ptr<JsonNode>> items;
+  std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> members;
+};
+
+class JsonVariant
+{
+public:
+  JsonVariant(JsonNode *node = nullptr) : node(node) {}
+
+  bool isNull() const { return node == nullptr || node->type == JsonNode::Null; }
+
+  template <typename T> bool is() const
+  {
+    if (std::is_same<T, const char *>::value)
+    {
+      return node != nullptr && node->type == JsonNode::String;
+    }
+    return node != nullptr && node->type == JsonNode::Number;
+  }
+
+  // Numbers in strings are converted, as in ArduinoJson
+  template <typename T> typename std::enable_if<std::is_arithmetic<T>::value, T>::type as() const
+  {
+    if (node == nullptr)
+    {
+      return 0;
+    }
+    if (node->type == JsonNode::String)
+    {
+      return (T)strtol(node->text.c_str(), nullptr, 10);
+    }
+    return (T)node->number;
+  }
+
+  template <typename T> typename std::enable_if<std::is_same<T, const char *>::value, T>::type as() const
+  {
+    return is<const char *>() ? node->text.c_str() : nullptr;
+  }
+
+  const char *operator|(const char *fallback) const { return is<const char *>() ? node->text.c_str() : fallback; }
+
+  JsonVariant operator[](const char *key) const
+  {
+    if (node != nullptr && node->type == JsonNode::Object)
+    {
+      for (auto &member : node->members)
+      {
+        if (member.first == key)
+        {
+          return JsonVariant(member.second.get());
+        }
+      }
+    }
+    return JsonVariant();
+  }
+
+  JsonVariant operator[](size_t index) const
+  {
+    if (node != nullptr && node->type == JsonNode::Array && index < node->items.size())
+    {
+      return JsonVariant(node->items[index].get());
+    }
+    return JsonVariant();
+  }
+  JsonVariant operator[](int index) const { return (*this)[(size_t)index]; }
+
+  bool containsKey(const char *key) const { return !(*this)[key].isNull(); }
+
+  size_t size() const
+  {
+    if (node == nullptr)
+    {
+      return 0;
+    }
+    return node->type == JsonNode::Array ? node->items.size() : node->members.size();
+  }
+
+  // Iterates the items of an array
+  class Iterator
+  {
+  public:
+    Iterator(const std::unique_ptr<JsonNode> *item) : item(item) {}
+    JsonVariant operator*() const { return JsonVariant(item->get()); }
+    Iterator &operator++()
+    {
+      item++;
+      return *this;
+    }
+    bool operator!=(const Iterator &other) const { return item != other.item; }
+
+  private:
+    const std::unique_ptr<JsonNode> *item;
+  };
+
+  Iterator begin() const { return Iterator(isArray() ? node->items.data() : nullptr); }
+  Iterator end() const { return Iterator(isArray() ? node->items.data() + node->items.size() : nullptr); }
+
+private:
+  bool isArray() const { return node != nullptr && node->type == JsonNode::Array; }
+
+  JsonNode *node;
+};
+
+typedef JsonVariant JsonObject;
+typedef JsonVariant JsonArray;
+
+class JsonDocument
+{
+public:
+  JsonVariant operator[](const char *key) const { return JsonVariant(root.get())[key]; }
+
+  std::unique_ptr<JsonNode> root;
+};
+
+class DynamicJsonDocument : public JsonDocument
+{
+public:
+  explicit DynamicJsonDocument(size_t capacity) { (void)capacity; }
+};
+
+class DeserializationError
+{
+public:
+  DeserializationError(const char *error = nullptr) : error(error) {}
+  explicit operator bool() const { return error != nullptr; }
+  const char *c_str() const { return error ? error : "Ok"; }
+
+private:
+  const char *error;
+};
+
+// A small recursive parser for objects, arrays, strings, integers and
+// true/false/null. Escapes other than \" and \\ are not handled.
+class JsonParser
+{
+public:
+  JsonParser(const std::string &input) : input(input) {}
+
+  bool parse(JsonNode &node)
+  {
+    skipSpace();
+    if (pos >= input.size())
+    {
+      return false;
+    }
+    char c = input[pos];
+    if (c == '{')
+    {
+      node.type = JsonNode::Object;
+      pos++;
+      skipSpace();
+      if (peek('}'))
+      {
+        return true;
+      }
+      do
+      {
+        JsonNode key;
+        std::unique_ptr<JsonNode> value(new JsonNode());
+        skipSpace();
+        if (!parseString(key) || !peek(':') || !parse(*value))
+        {
+          return false;
+        }
+        node.members.emplace_back(key.text, std::move(value));
+      } while (peek(','));
+      return peek('}');
+    }
+    if (c == '[')
+    {
+      node.type = JsonNode::Array;
+      pos++;
+      skipSpace();
+      if (peek(']'))
+      {
+        return true;
+      }
+      do
+      {
+        std::unique_ptr<JsonNode> item(new JsonNode());
+        if (!parse(*item))
+        {
+          return false;
+        }
+        node.items.push_back(std::move(item));
+      } while (peek(','));
+      return peek(']');
+    }
+    if (c == '"')
+    {
+      return parseString(node);
+    }
+    if (c == '-' || (c >= '0' && c <= '9'))
+    {
+      char *end;
+      node.type = JsonNode::Number;
+      node.number = strtol(input.c_str() + pos, &end, 10);
+      pos = end - input.c_str();
+      return true;
+    }
+    for (const char *word : {"true", "false", "null"})
+    {
+      if (input.compare(pos, strlen(word), word) == 0)
+      {
+        node.type = word[0] == 'n' ? JsonNode::Null : JsonNode::Number;
+        node.number = word[0] == 't';
+        pos += strlen(word);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool atEnd()
+  {
+    skipSpace();
+    return pos == input.size();
+  }
+
+private:
+  void skipSpace()
+  {
+    while (pos < input.size() && strchr(" \t\r\n", input[pos]))
+    {
+      pos++;
+    }
+  }
+
+  bool peek(char c)
+  {
+    skipSpace();
+    if (pos < input.size() && input[pos] == c)
+    {
+      pos++;
+      return true;
+    }
+    return false;
+  }
+
+  bool parseString(JsonNode &node)
+  {
+    if (!peek('"'))
+    {
+      return false;
+    }
+    node.type = JsonNode::String;
+    while (pos < input.size() && input[pos] != '"')
+    {
+      if (input[pos] == '\\' && pos + 1 < input.size())
+      {
+        pos++;
+      }
+      node.text += input[pos++];
+    }
+    return peek('"');
+  }
+
+  const std::string &input;
+  size_t pos = 0;
+};
+
+inline DeserializationError jsonParse(JsonDocument &doc, const std::string &input)
+{
+  doc.root.reset(new JsonNode());
+  JsonParser parser(input);
+  if (!parser.parse(*doc.root) || !parser.atEnd())
+  {
+    doc.root.reset();
+    return DeserializationError("InvalidInput");
+  }
+  return DeserializationError();
+}
+
+inline DeserializationError deserializeJson(JsonDocument &doc, const char *input)
+{
+  return jsonParse(doc, input);
+}
+
+// Streams, e.g. a File: read until read() returns -1
+template <typename Stream> DeserializationError deserializeJson(JsonDocument &doc, Stream &stream)
+{
+  std::string input;
+  int c;
+  while ((c = stream.read()) >= 0)
+  {
+    input += (char)c;
+  }
+  return jsonParse(doc, input);
+}
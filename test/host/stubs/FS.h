@@ -0,0 +1,103 @@
+#pragma once
+/*
+ * A file system in RAM for the host tests, with the File calls the sketch
+ * uses. As on SPIFFS, rename() fails if the new name exists.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+
+class File
+{
+public:
+  File() {}
+  File(std::shared_ptr<std::string> data) : data(data) {}
+
+  explicit operator bool() const { return data != nullptr; }
+  bool isDirectory() const { return false; }
+  size_t size() const { return data ? data->size() : 0; }
+
+  int read()
+  {
+    if (!data || pos >= data->size())
+    {
+      return -1;
+    }
+    return (uint8_t)(*data)[pos++];
+  }
+
+  size_t read(uint8_t *buffer, size_t length)
+  {
+    if (!data || pos >= data->size())
+    {
+      return 0;
+    }
+    length = std::min(length, data->size() - pos);
+    memcpy(buffer, data->data() + pos, length);
+    pos += length;
+    return length;
+  }
+
+  size_t write(const uint8_t *buffer, size_t length)
+  {
+    if (!data)
+    {
+      return 0;
+    }
+    data->append((const char *)buffer, length);
+    return length;
+  }
+
+  bool seek(uint32_t position)
+  {
+    if (!data || position > data->size())
+    {
+      return false;
+    }
+    pos = position;
+    return true;
+  }
+
+  void close() { data.reset(); }
+
+private:
+  std::shared_ptr<std::string> data;
+  size_t pos = 0;
+};
+
+class HostFS
+{
+public:
+  File open(const char *path, const char *mode = "r")
+  {
+    if (mode[0] == 'w')
+    {
+      files[path] = std::make_shared<std::string>();
+    }
+    auto file = files.find(path);
+    return file == files.end() ? File() : File(file->second);
+  }
+
+  bool exists(const char *path) const { return files.count(path) > 0; }
+  bool remove(const char *path) { return files.erase(path) > 0; }
+
+  bool rename(const char *from, const char *to)
+  {
+    auto file = files.find(from);
+    if (file == files.end() || exists(to))
+    {
+      return false;
+    }
+    files[to] = file->second;
+    files.erase(file);
+    return true;
+  }
+
+  std::map<std::string, std::shared_ptr<std::string>> files;
+};
@@ -0,0 +1,146 @@
+#pragma once
+/*
+ * The NimBLE classes BleKeyboard uses, for the host tests. Nothing connects:
+ * there is no server until begin(), which the tests do not call.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct ble_addr_t
+{
+  uint8_t type;
+  uint8_t val[6];
+};
+
+class NimBLEAddress
+{
+public:
+  NimBLEAddress() : addr{} {}
+  NimBLEAddress(const ble_addr_t &address) : addr(address) {}
+  const ble_addr_t *getBase() const { return &addr; }
+  std::string toString() const { return "00:00:00:00:00:00"; }
+
+private:
+  ble_addr_t addr;
+};
+
+class NimBLEUUID
+{
+};
+
+class NimBLEAttValue : public std::vector<uint8_t>
+{
+};
+
+class NimBLEConnInfo
+{
+public:
+  uint16_t getConnHandle() const { return 0; }
+  uint16_t getConnInterval() const { return 0; }
+  uint16_t getConnLatency() const { return 0; }
+  uint16_t getConnTimeout() const { return 0; }
+  bool isEncrypted() const { return false; }
+  bool isBonded() const { return false; }
+  NimBLEAddress getIdAddress() const { return NimBLEAddress(); }
+};
+
+class NimBLECharacteristic;
+class NimBLEServer;
+class NimBLEAdvertising;
+
+class NimBLECharacteristicCallbacks
+{
+public:
+  virtual ~NimBLECharacteristicCallbacks() {}
+  virtual void onWrite(NimBLECharacteristic *characteristic, NimBLEConnInfo &connInfo) { (void)characteristic; (void)connInfo; }
+  virtual void onStatus(NimBLECharacteristic *characteristic, int code) { (void)characteristic; (void)code; }
+};
+
+class NimBLEServerCallbacks
+{
+public:
+  virtual ~NimBLEServerCallbacks() {}
+  virtual void onConnect(NimBLEServer *server, NimBLEConnInfo &connInfo) { (void)server; (void)connInfo; }
+  virtual void onDisconnect(NimBLEServer *server, NimBLEConnInfo &connInfo, int reason) { (void)server; (void)connInfo; (void)reason; }
+  virtual void onConnParamsUpdate(NimBLEConnInfo &connInfo) { (void)connInfo; }
+  virtual void onAuthenticationComplete(NimBLEConnInfo &connInfo) { (void)connInfo; }
+};
+
+class NimBLECharacteristic
+{
+public:
+  void setCallbacks(NimBLECharacteristicCallbacks *callbacks) { (void)callbacks; }
+  void setValue(const uint8_t *data, size_t length) { value.assign(data, data + length); }
+  bool notify() { return false; }
+  NimBLEAttValue getValue() const { return value; }
+
+private:
+  NimBLEAttValue value;
+};
+
+class NimBLEService
+{
+public:
+  NimBLEUUID getUUID() const { return NimBLEUUID(); }
+};
+
+class NimBLEServer
+{
+public:
+  void setCallbacks(NimBLEServerCallbacks *callbacks) { (void)callbacks; }
+  void advertiseOnDisconnect(bool enable) { (void)enable; }
+  bool updateConnParams(uint16_t handle, uint16_t min, uint16_t max, uint16_t latency, uint16_t timeout)
+  {
+    (void)handle; (void)min; (void)max; (void)latency; (void)timeout;
+    return false;
+  }
+  bool disconnect(uint16_t handle) { (void)handle; return false; }
+  size_t getConnectedCount() const { return 0; }
+};
+
+class NimBLEAdvertising
+{
+public:
+  bool stop() { return true; }
+  void setMinInterval(uint16_t interval) { (void)interval; }
+  void setMaxInterval(uint16_t interval) { (void)interval; }
+  bool start(uint32_t duration = 0, const NimBLEAddress *address = nullptr) { (void)duration; (void)address; return false; }
+  void setAppearance(uint16_t appearance) { (void)appearance; }
+  void addServiceUUID(const NimBLEUUID &uuid) { (void)uuid; }
+  void setAdvertisingCompleteCallback(std::function<void(NimBLEAdvertising *)> callback) { (void)callback; }
+};
+
+class NimBLEHIDDevice
+{
+public:
+  NimBLEHIDDevice(NimBLEServer *server) { (void)server; }
+  NimBLECharacteristic *getInputReport(uint8_t id) { (void)id; return nullptr; }
+  NimBLECharacteristic *getOutputReport(uint8_t id) { (void)id; return nullptr; }
+  void setManufacturer(const std::string &name) { (void)name; }
+  void setPnp(uint8_t sig, uint16_t vid, uint16_t pid, uint16_t version) { (void)sig; (void)vid; (void)pid; (void)version; }
+  void setHidInfo(uint8_t country, uint8_t flags) { (void)country; (void)flags; }
+  void setReportMap(uint8_t *map, uint16_t size) { (void)map; (void)size; }
+  void startServices() {}
+  NimBLEService *getHidService() { return &service; }
+  void setBatteryLevel(uint8_t level) { (void)level; }
+
+private:
+  NimBLEService service;
+};
+
+class NimBLEDevice
+{
+public:
+  static bool init(const std::string &name) { (void)name; return false; }
+  static void setSecurityAuth(bool bonding, bool mitm, bool sc) { (void)bonding; (void)mitm; (void)sc; }
+  static NimBLEServer *createServer() { return nullptr; }
+  static NimBLEAdvertising *getAdvertising() { return nullptr; }
+  static NimBLEAddress getBondedAddress(int index) { (void)index; return NimBLEAddress(); }
+  static bool isBonded(const NimBLEAddress &address) { (void)address; return false; }
+  static int getNumBonds() { return 0; }
+};
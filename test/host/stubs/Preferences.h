@@ -0,0 +1,20 @@
+#pragma once
+/*
+ * Preferences for the host tests: nothing is stored, reads return the default.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Preferences
+{
+public:
+  bool begin(const char *name, bool readOnly = false) { (void)name; (void)readOnly; return true; }
+  void end() {}
+  size_t getBytes(const char *key, void *buffer, size_t length) { (void)key; (void)buffer; (void)length; return 0; }
+  size_t putBytes(const char *key, const void *value, size_t length) { (void)key; (void)value; (void)length; return 0; }
+  int32_t getInt(const char *key, int32_t value = 0) { (void)key; return value; }
+  size_t putInt(const char *key, int32_t value) { (void)key; (void)value; return 4; }
+  uint8_t getUChar(const char *key, uint8_t value = 0) { (void)key; return value; }
+  size_t putUChar(const char *key, uint8_t value) { (void)key; (void)value; return 1; }
+};
@@ -0,0 +1,2 @@
+#pragma once
+// Not used on the host
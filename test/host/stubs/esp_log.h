@@ -0,0 +1,3 @@
+#pragma once
+
+#define ESP_LOGI(tag, format, ...) ((void)(tag))
@@ -0,0 +1,39 @@
+#pragma once
+/*
+ * FreeRTOS for the host tests. There are no tasks, so queues and semaphores are
+ * never created: BleKeyboard only uses them after begin(), which the tests do
+ * not call. Its reports go to a HidRoute instead.
+ */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef unsigned int UBaseType_t;
+typedef int BaseType_t;
+typedef void *QueueHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffffUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t size) { (void)length; (void)size; return nullptr; }
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) { (void)queue; (void)item; (void)wait; return pdFALSE; }
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) { (void)queue; (void)item; (void)wait; return pdFALSE; }
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { (void)queue; return 0; }
+inline BaseType_t xQueueReset(QueueHandle_t queue) { (void)queue; return pdTRUE; }
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return nullptr; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t wait) { (void)semaphore; (void)wait; return pdFALSE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) { (void)semaphore; return pdFALSE; }
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack, void *arg,
+                                          UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+  (void)task; (void)name; (void)stack; (void)arg; (void)priority; (void)handle; (void)core;
+  return pdFALSE;
+}
+inline void vTaskDelay(TickType_t ticks) { (void)ticks; }
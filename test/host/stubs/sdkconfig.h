@@ -0,0 +1,3 @@
+#pragma once
+// The original ESP32: no 2M PHY, see BleKeyboard.h
+#define CONFIG_IDF_TARGET_ESP32 1